@@ -0,0 +1,234 @@
+#ifndef AccessorConversion_h
+#define AccessorConversion_h
+
+#include "GLTFFile.h"
+#include "Json.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace gltf2 {
+
+/**
+ * @brief The component type stored as the C++ type `T`.
+ */
+template <typename T> struct ComponentTypeOf;
+template <> struct ComponentTypeOf<int8_t> {
+  static constexpr auto value = json::Accessor::ComponentType::BYTE;
+};
+template <> struct ComponentTypeOf<uint8_t> {
+  static constexpr auto value = json::Accessor::ComponentType::UNSIGNED_BYTE;
+};
+template <> struct ComponentTypeOf<int16_t> {
+  static constexpr auto value = json::Accessor::ComponentType::SHORT;
+};
+template <> struct ComponentTypeOf<uint16_t> {
+  static constexpr auto value = json::Accessor::ComponentType::UNSIGNED_SHORT;
+};
+template <> struct ComponentTypeOf<uint32_t> {
+  static constexpr auto value = json::Accessor::ComponentType::UNSIGNED_INT;
+};
+template <> struct ComponentTypeOf<float> {
+  static constexpr auto value = json::Accessor::ComponentType::FLOAT;
+};
+
+/**
+ * @brief Converts one component. Without `Normalized` this is a
+ * `static_cast`. With it, integers become floats in [0, 1] or [-1, 1] and
+ * floats become integers over the range of `Dst`, with the formulas of the
+ * glTF spec; integers of different types are converted through a float.
+ */
+template <typename Src, typename Dst, bool Normalized>
+inline Dst convertComponent(Src c) {
+  if constexpr (!Normalized || std::is_same_v<Src, Dst>) {
+    return static_cast<Dst>(c);
+  } else if constexpr (std::is_integral_v<Src> &&
+                       std::is_floating_point_v<Dst>) {
+    const auto scale = (Dst)std::numeric_limits<Src>::max();
+    if constexpr (std::is_signed_v<Src>)
+      return std::max((Dst)c / scale, (Dst)-1);
+    else
+      return (Dst)c / scale;
+  } else if constexpr (std::is_floating_point_v<Src> &&
+                       std::is_integral_v<Dst>) {
+    const auto scale = (Src)std::numeric_limits<Dst>::max();
+    const auto low = std::is_signed_v<Dst> ? (Src)-1 : (Src)0;
+    return static_cast<Dst>(
+        std::round(std::min(std::max(c, low), (Src)1) * scale));
+  } else if constexpr (std::is_integral_v<Src> && std::is_integral_v<Dst>) {
+    return convertComponent<float, Dst, true>(
+        convertComponent<Src, float, true>(c));
+  } else {
+    return static_cast<Dst>(c);
+  }
+}
+
+/**
+ * @brief Converts `count` normalized integer components of `componentType`
+ * into floats in [0, 1] or [-1, 1], writing them to `dst`.
+ *
+ * BYTE, UNSIGNED_BYTE, SHORT and UNSIGNED_SHORT are converted with SSE2,
+ * AVX2 or NEON, whichever the library is compiled for.
+ */
+void normalizeComponents(const void *src, size_t count,
+                         json::Accessor::ComponentType componentType,
+                         float *dst);
+
+/**
+ * @brief Converts the tightly packed integer components of a normalized
+ * accessor into floats in [0, 1] or [-1, 1].
+ *
+ * @param binary The packed components of the accessor.
+ * @param accessor The accessor describing the components.
+ * @return Buffer The components as 32-bit floats.
+ */
+Buffer normalizeBuffer(const Buffer &binary, const json::Accessor &accessor);
+
+/**
+ * @brief Converts `count` floats into IEEE 754 half floats, rounding to the
+ * nearest half. Uses F16C or NEON when the library is compiled for them.
+ */
+void floatsToHalfs(const float *src, size_t count, uint16_t *dst);
+
+/**
+ * @brief Copies `count` elements of `elementSize` bytes, which start
+ * `byteStride` bytes apart at `src`, into tightly packed elements at `dst`.
+ *
+ * Elements of 8, 12 and 16 bytes are copied with 16-byte SIMD loads and
+ * stores, and other common sizes with fixed-size copies.
+ */
+void gatherElements(const void *src, size_t byteStride, size_t elementSize,
+                    size_t count, void *dst);
+
+/**
+ * @brief An attribute of interleaved vertices and its packed destination.
+ */
+struct InterleavedElement {
+  /// The offset of the attribute from the start of the vertices.
+  size_t byteOffset;
+  size_t elementSize;
+  /// Room for `count` packed elements.
+  void *dst;
+};
+
+/**
+ * @brief Splits `count` interleaved vertices, `byteStride` bytes apart at
+ * `src`, into one packed array per element, in a single pass over `src`.
+ */
+void deinterleave(const void *src, size_t byteStride, size_t count,
+                  const std::vector<InterleavedElement> &elements);
+
+/**
+ * @brief Converts `count` elements of `N` components of type `Src`, which
+ * start `byteStride` bytes apart at `src`, into tightly packed elements of
+ * type `Dst` at `dst`. The loops have no branches, so the compiler can
+ * vectorize each instantiation; normalized BYTE and SHORT elements that are
+ * already packed go through `normalizeComponents`.
+ */
+template <typename Src, typename Dst, size_t N, bool Normalized = false>
+void convertAccessor(const void *src, size_t byteStride, size_t count,
+                     Dst *dst) {
+  if constexpr (Normalized && std::is_same_v<Dst, float> &&
+                std::is_integral_v<Src> && sizeof(Src) <= 2) {
+    if (byteStride == sizeof(Src) * N) {
+      normalizeComponents(src, count * N, ComponentTypeOf<Src>::value, dst);
+      return;
+    }
+  }
+  if constexpr (std::is_same_v<Src, Dst>) {
+    if (byteStride == sizeof(Src) * N) {
+      std::memcpy(dst, src, sizeof(Src) * N * count);
+      return;
+    }
+  }
+  const uint8_t *bytes = (const uint8_t *)src;
+  for (size_t i = 0; i < count; i++) {
+    Src element[N];
+    std::memcpy(element, bytes + i * byteStride, sizeof(element));
+    for (size_t j = 0; j < N; j++)
+      dst[i * N + j] = convertComponent<Src, Dst, Normalized>(element[j]);
+  }
+}
+
+/**
+ * @brief An instantiation of `convertAccessor` writing `Dst`.
+ */
+template <typename Dst>
+using AccessorConverter = void (*)(const void *src, size_t byteStride,
+                                   size_t count, Dst *dst);
+
+namespace detail {
+
+template <typename Src, typename Dst, bool Normalized>
+AccessorConverter<Dst> accessorConverterOfType(json::Accessor::Type type) {
+  switch (type) {
+  case json::Accessor::Type::SCALAR:
+    return &convertAccessor<Src, Dst, 1, Normalized>;
+  case json::Accessor::Type::VEC2:
+    return &convertAccessor<Src, Dst, 2, Normalized>;
+  case json::Accessor::Type::VEC3:
+    return &convertAccessor<Src, Dst, 3, Normalized>;
+  case json::Accessor::Type::VEC4:
+  case json::Accessor::Type::MAT2:
+    return &convertAccessor<Src, Dst, 4, Normalized>;
+  case json::Accessor::Type::MAT3:
+    return &convertAccessor<Src, Dst, 9, Normalized>;
+  case json::Accessor::Type::MAT4:
+    return &convertAccessor<Src, Dst, 16, Normalized>;
+  }
+  return nullptr;
+}
+
+template <typename Src, typename Dst>
+AccessorConverter<Dst> accessorConverterOf(json::Accessor::Type type,
+                                           bool normalized) {
+  return normalized ? accessorConverterOfType<Src, Dst, true>(type)
+                    : accessorConverterOfType<Src, Dst, false>(type);
+}
+
+} // namespace detail
+
+/**
+ * @brief Selects the instantiation of `convertAccessor` for the component
+ * type, element type and normalized flag of an accessor, so the
+ * conversion itself does not switch on them.
+ */
+template <typename Dst>
+AccessorConverter<Dst>
+accessorConverter(json::Accessor::ComponentType componentType,
+                  json::Accessor::Type type, bool normalized) {
+  switch (componentType) {
+  case json::Accessor::ComponentType::BYTE:
+    return detail::accessorConverterOf<int8_t, Dst>(type, normalized);
+  case json::Accessor::ComponentType::UNSIGNED_BYTE:
+    return detail::accessorConverterOf<uint8_t, Dst>(type, normalized);
+  case json::Accessor::ComponentType::SHORT:
+    return detail::accessorConverterOf<int16_t, Dst>(type, normalized);
+  case json::Accessor::ComponentType::UNSIGNED_SHORT:
+    return detail::accessorConverterOf<uint16_t, Dst>(type, normalized);
+  case json::Accessor::ComponentType::UNSIGNED_INT:
+    return detail::accessorConverterOf<uint32_t, Dst>(type, normalized);
+  case json::Accessor::ComponentType::FLOAT:
+    return detail::accessorConverterOf<float, Dst>(type, normalized);
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Converts all elements of `accessor`, which start `byteStride`
+ * bytes apart at `src`, into tightly packed components of type `Dst`.
+ */
+template <typename Dst>
+void convertAccessor(const void *src, size_t byteStride,
+                     const json::Accessor &accessor, Dst *dst,
+                     bool normalized) {
+  accessorConverter<Dst>(accessor.componentType, accessor.type,
+                         normalized)(src, byteStride, accessor.count, dst);
+}
+
+} // namespace gltf2
+
+#endif /* AccessorConversion_h */
@@ -0,0 +1,52 @@
+#ifndef DracoDecoder_h
+#define DracoDecoder_h
+
+#include "Executor.h"
+#include "GLTFData.h"
+#include "LoadOptions.h"
+#include "draco/mesh/mesh.h"
+#include <memory>
+#include <vector>
+
+namespace gltf2 {
+
+/**
+ * @brief Decodes the Draco meshes of KHR_draco_mesh_compression bufferViews.
+ *
+ * Every thread keeps one `draco::Decoder` configured for the skipped
+ * attributes and reuses it for all the meshes it decodes, so decoding many
+ * small meshes does not set up a decoder for each.
+ */
+class DracoDecoder {
+public:
+  explicit DracoDecoder(
+      MeshAttributes skippedAttributes = MeshAttributes::None)
+      : _skippedAttributes(skippedAttributes) {}
+
+  /**
+   * @brief Decode a Draco mesh on the calling thread.
+   * @throws InvalidFormatException If the data is not a valid Draco mesh.
+   */
+  std::unique_ptr<draco::Mesh> decode(const uint8_t *data,
+                                      size_t bytes) const;
+
+  std::unique_ptr<draco::Mesh> decode(const BufferView &bufferView) const {
+    return decode(bufferView.data, bufferView.bytes);
+  }
+
+  /**
+   * @brief Decode every bufferView concurrently on `executor`.
+   * @throws InvalidFormatException For the first bufferView that fails to
+   * decode, after the others are done.
+   */
+  std::vector<std::unique_ptr<draco::Mesh>>
+  decodeAll(const std::vector<BufferView> &bufferViews,
+            Executor &executor) const;
+
+private:
+  MeshAttributes _skippedAttributes;
+};
+
+} // namespace gltf2
+
+#endif /* DracoDecoder_h */
@@ -0,0 +1,105 @@
+#ifndef DracoEncoder_h
+#define DracoEncoder_h
+
+#include "Executor.h"
+#include "GLBWriter.h"
+#include "GLTFData.h"
+#include "Json.h"
+#include <vector>
+
+namespace gltf2 {
+
+/**
+ * @brief The quantization bits of each kind of attribute, from 1 to 30, or 0
+ * to store it losslessly. Only float attributes are quantized; integer
+ * attributes such as joints are always lossless.
+ */
+struct DracoQuantization {
+  int position = 14;
+  int normal = 10;
+  int tangent = 10;
+  int texcoord = 12;
+  int color = 8;
+  int weights = 12;
+};
+
+struct DracoEncodeOptions {
+  DracoQuantization quantization;
+  /// From 0, the best compression, to 10, the fastest encoding.
+  int encodingSpeed = 5;
+  /// From 0, the best compression, to 10, the fastest decoding.
+  int decodingSpeed = 5;
+};
+
+/**
+ * @brief A mesh primitive encoded as a Draco mesh.
+ */
+struct DracoEncodedPrimitive {
+  /// The Draco mesh, the payload of the extension's bufferView.
+  Buffer data;
+  /// The unique ids of the attributes in the Draco mesh. `bufferView` is
+  /// left for the caller to set.
+  json::MeshPrimitiveDracoExtension extension;
+  /// The number of vertices the mesh decodes to.
+  uint32_t vertexCount = 0;
+  /// The number of indices the mesh decodes to.
+  uint32_t indexCount = 0;
+};
+
+/**
+ * @brief Encodes loaded mesh primitives for KHR_draco_mesh_compression.
+ */
+class DracoEncoder {
+public:
+  explicit DracoEncoder(DracoEncodeOptions options = DracoEncodeOptions())
+      : _options(options) {}
+
+  const DracoEncodeOptions &options() const { return _options; }
+
+  /**
+   * @brief Encode a triangle list on the calling thread. A primitive without
+   * an element is encoded as a triangle list of its vertices.
+   *
+   * Primitives with morph targets keep the order of their vertices so that
+   * the uncompressed targets still apply to them; the vertices of other
+   * primitives are reordered for a better compression.
+   *
+   * @throws InputException If the primitive has no positions, is not a
+   * triangle list, or cannot be encoded.
+   */
+  DracoEncodedPrimitive encode(const MeshPrimitive &primitive) const;
+
+  /**
+   * @brief Encode every primitive concurrently on `executor`.
+   * @throws InputException For the first primitive that fails to encode,
+   * after the others are done.
+   */
+  std::vector<DracoEncodedPrimitive>
+  encodeAll(const std::vector<const MeshPrimitive *> &primitives,
+            Executor &executor) const;
+
+  /**
+   * @brief Write loaded data to a GLB whose triangle mesh primitives are
+   * compressed with KHR_draco_mesh_compression.
+   *
+   * Each compressed primitive is rewritten from its loaded sources, so
+   * attributes skipped by `LoadOptions::skippedAttributes` are dropped.
+   * Accessors only the compressed primitives referred to are removed along
+   * with their bufferViews; morph targets, other primitives and every other
+   * bufferView are written as they are. Images keep their URIs.
+   *
+   * The returned writer refers to the buffers of `data`, which must outlive
+   * it.
+   *
+   * @throws InputException If a primitive cannot be encoded.
+   */
+  GLBWriter compress(const GLTFData &data,
+                     Executor &executor = defaultExecutor()) const;
+
+private:
+  DracoEncodeOptions _options;
+};
+
+} // namespace gltf2
+
+#endif /* DracoEncoder_h */
@@ -0,0 +1,106 @@
+#ifndef Executor_h
+#define Executor_h
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gltf2 {
+
+enum class TaskPriority { Low, Normal, High };
+
+/**
+ * @brief Runs the work of GLTF2 on threads owned by the caller, like an
+ * engine's job system. Every parallel site in the library goes through an
+ * executor.
+ */
+class Executor {
+public:
+  virtual ~Executor() = default;
+
+  /**
+   * @brief Run `fn` later on a thread of the executor. `fn` must not block
+   * waiting for other work submitted with `submit` to the same executor;
+   * `parallelFor` is safe to call from it.
+   */
+  virtual void submit(std::function<void()> fn,
+                      TaskPriority priority = TaskPriority::Normal) = 0;
+
+  /**
+   * @brief Call `fn(i)` for every `i` in `[0, count)` and return once all
+   * calls have returned. The calling thread runs calls too, so this makes
+   * progress even when every thread of the executor is busy.
+   *
+   * @throws The first exception thrown by `fn`, after all calls returned.
+   */
+  virtual void parallelFor(size_t count,
+                           const std::function<void(size_t)> &fn,
+                           TaskPriority priority = TaskPriority::Normal);
+
+  /**
+   * @brief The number of threads that run submitted work.
+   */
+  virtual size_t concurrency() const = 0;
+};
+
+/**
+ * @brief Runs everything on the calling thread, in order.
+ */
+class InlineExecutor : public Executor {
+public:
+  void submit(std::function<void()> fn,
+              TaskPriority /*priority*/ = TaskPriority::Normal) override {
+    fn();
+  }
+
+  void parallelFor(size_t count, const std::function<void(size_t)> &fn,
+                   TaskPriority /*priority*/ = TaskPriority::Normal) override {
+    for (size_t i = 0; i < count; i++)
+      fn(i);
+  }
+
+  size_t concurrency() const override { return 1; }
+};
+
+/**
+ * @brief A fixed number of threads taking work from one queue per
+ * priority, higher priorities first.
+ */
+class ThreadPoolExecutor : public Executor {
+public:
+  explicit ThreadPoolExecutor(
+      size_t threads = std::thread::hardware_concurrency());
+  ~ThreadPoolExecutor();
+
+  ThreadPoolExecutor(const ThreadPoolExecutor &) = delete;
+  ThreadPoolExecutor &operator=(const ThreadPoolExecutor &) = delete;
+
+  void submit(std::function<void()> fn,
+              TaskPriority priority = TaskPriority::Normal) override;
+
+  size_t concurrency() const override { return _threads.size(); }
+
+private:
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::array<std::deque<std::function<void()>>, 3> _queues;
+  std::vector<std::thread> _threads;
+  bool _stop = false;
+
+  void run();
+};
+
+/**
+ * @brief The executor used when `LoadOptions::executor` is not set: a
+ * `ThreadPoolExecutor` with one thread per core, shared by all loads.
+ */
+Executor &defaultExecutor();
+
+} // namespace gltf2
+
+#endif /* Executor_h */
@@ -0,0 +1,31 @@
+#ifndef GLBFormat_h
+#define GLBFormat_h
+
+#include <cstdint>
+
+namespace gltf2 {
+
+static const uint32_t GLBHeaderMagic = 0x46546C67;
+static const uint32_t GLBVersion = 2;
+static const uint32_t GLBChunkTypeJSON = 0x4E4F534A;
+static const uint32_t GLBChunkTypeBIN = 0x004E4942;
+
+/**
+ * @brief Alignment of GLB chunks and of the data inside the BIN chunk.
+ */
+static const uint32_t GLBChunkAlignment = 4;
+
+struct GLBHeader {
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint32_t length = 0;
+};
+
+struct GLBChunkHead {
+  uint32_t length = 0;
+  uint32_t type = 0;
+};
+
+} // namespace gltf2
+
+#endif /* GLBFormat_h */
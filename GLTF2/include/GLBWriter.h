@@ -0,0 +1,153 @@
+#ifndef GLBWriter_h
+#define GLBWriter_h
+
+#include "GLBFormat.h"
+#include "GLTFData.h"
+#include "GLTFFile.h"
+#include "Json.h"
+#include <deque>
+#include <filesystem>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gltf2 {
+
+/**
+ * @brief Assembles a GLB file from a glTF document and bufferView payloads.
+ *
+ * The writer owns the `buffers` and `bufferViews` of the document: all
+ * payloads added with `addBufferView` are laid out in a single BIN chunk and
+ * the corresponding entries are generated when the file is written. Every
+ * payload starts at an offset aligned to at least 4 bytes, and payloads with
+ * identical contents share the same range of the BIN chunk.
+ *
+ * Payloads are not copied into an intermediate buffer. `write` streams the
+ * header, the JSON chunk and each payload directly to the destination.
+ */
+class GLBWriter {
+public:
+  /**
+   * @brief Create a writer for the given document.
+   *
+   * @param json The document to write. Its `buffers` and `bufferViews` are
+   * discarded; bufferViews must be re-added in order with `addBufferView`.
+   * They hold plain data, so EXT_meshopt_compression is no longer used.
+   */
+  explicit GLBWriter(json::Json json);
+
+  GLBWriter(const GLBWriter &) = delete;
+  GLBWriter &operator=(const GLBWriter &) = delete;
+  GLBWriter(GLBWriter &&) = default;
+  GLBWriter &operator=(GLBWriter &&) = default;
+
+  /**
+   * @brief Append a bufferView whose payload is owned by the caller.
+   *
+   * The payload is not copied; it must stay alive until the last call of
+   * `write`.
+   *
+   * @param data The payload.
+   * @param bytes The size of the payload in bytes.
+   * @param alignment The required alignment of the payload in the BIN chunk.
+   * It is always raised to a multiple of 4.
+   * @param byteStride The byteStride of the bufferView.
+   * @param target The target of the bufferView.
+   * @param name The name of the bufferView.
+   * @return uint32_t The index of the new bufferView.
+   * @throws InputException If the BIN chunk would exceed 4 GiB.
+   */
+  uint32_t addBufferView(const uint8_t *data, uint32_t bytes,
+                         uint32_t alignment = 4,
+                         std::optional<uint32_t> byteStride = std::nullopt,
+                         std::optional<uint32_t> target = std::nullopt,
+                         std::optional<std::string> name = std::nullopt);
+
+  /**
+   * @brief Append a bufferView whose payload is moved into the writer.
+   */
+  uint32_t addBufferView(Buffer &&buffer, uint32_t alignment = 4,
+                         std::optional<uint32_t> byteStride = std::nullopt,
+                         std::optional<uint32_t> target = std::nullopt,
+                         std::optional<std::string> name = std::nullopt);
+
+  /**
+   * @brief Keep a buffer alive for the lifetime of the writer, so that
+   * bufferViews can refer to ranges of it without copying.
+   */
+  const Buffer &retainBuffer(Buffer &&buffer) {
+    return _ownedBuffers.emplace_back(std::move(buffer));
+  }
+
+  /**
+   * @brief The document to write. Accessors and images may be edited to refer
+   * to the bufferViews added to this writer.
+   */
+  json::Json &json() { return _json; }
+  const json::Json &json() const { return _json; }
+
+  uint32_t bufferViewCount() const { return _bufferViews.size(); }
+
+  /**
+   * @brief The length of the BIN chunk data, excluding trailing padding.
+   */
+  uint32_t binLength() const { return _binLength; }
+
+  /**
+   * @brief Write the GLB file to the given path.
+   *
+   * @throws InputException If the file cannot be opened or written.
+   */
+  void write(const std::filesystem::path &path) const;
+
+  /**
+   * @brief Write the GLB file to the given stream.
+   *
+   * @throws InputException If the stream fails.
+   */
+  void write(std::ostream &os) const;
+
+  /**
+   * @brief Create a writer that packs every bufferView of loaded data into the
+   * BIN chunk of a single buffer.
+   *
+   * Indices of bufferViews are preserved, so accessors and images keep
+   * referring to the same data. The writer refers to the bufferViews of
+   * `data`, which must outlive it.
+   */
+  static GLBWriter fromData(const GLTFData &data);
+
+private:
+  struct Segment {
+    const uint8_t *data;
+    uint32_t bytes;
+    uint32_t offset;
+  };
+
+  struct Chunk {
+    const uint8_t *data;
+    size_t bytes;
+  };
+
+  struct Heads {
+    GLBHeader header;
+    GLBChunkHead json;
+    GLBChunkHead bin;
+  };
+
+  json::Json _json;
+  std::vector<json::BufferView> _bufferViews;
+  std::vector<Segment> _segments;
+  std::unordered_multimap<size_t, size_t> _segmentsByHash;
+  std::deque<Buffer> _ownedBuffers;
+  uint32_t _binLength = 0;
+
+  std::string encodeJsonChunk() const;
+  std::vector<Chunk> chunks(const std::string &jsonChunk, Heads &heads) const;
+};
+
+} // namespace gltf2
+
+#endif /* GLBWriter_h */
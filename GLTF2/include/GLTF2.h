@@ -1,9 +1,24 @@
 #ifndef GLTF2_h
 #define GLTF2_h
 
+#include "AccessorConversion.h"
+#include "DracoEncoder.h"
+#include "Executor.h"
+#include "GLBWriter.h"
+#include "GLTFAsync.h"
 #include "GLTFData.h"
+#include "GLTFDocument.h"
 #include "GLTFException.h"
 #include "GLTFFile.h"
+#include "GLTFPrune.h"
+#include "GLTFRepack.h"
+#include "LoadOptions.h"
+#include "LoadStats.h"
+#include "LoadTrace.h"
+#include "MemoryBudget.h"
+#include "MeshOptimizer.h"
+#include "VertexLayout.h"
+#include "VertexWelder.h"
 #include "Json.h"
 
 #endif /* GLTF2_h */
@@ -0,0 +1,184 @@
+#ifndef GLTFAsync_h
+#define GLTFAsync_h
+
+#include "Executor.h"
+#include "GLTFDocument.h"
+#include "LoadOptions.h"
+#include <exception>
+#include <filesystem>
+#include <future>
+#include <optional>
+#include <utility>
+
+/*
+ * The coroutine API needs C++20 and is defined in this header alone, so the
+ * library itself can still be built as C++17. It is left out when the
+ * including code is built as C++17.
+ */
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+
+#define GLTF2_HAS_COROUTINES 1
+
+namespace gltf2 {
+
+/**
+ * @brief A lazily started coroutine producing a `T`. Awaiting it starts it
+ * and resumes the awaiting coroutine when it finishes, on the thread it
+ * finished on.
+ */
+template <typename T> class Task {
+public:
+  struct promise_type {
+    std::optional<T> value;
+    std::exception_ptr exception;
+    std::coroutine_handle<> continuation;
+
+    Task get_return_object() {
+      return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+      bool await_ready() noexcept { return false; }
+      std::coroutine_handle<>
+      await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+        auto continuation = handle.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+      }
+      void await_resume() noexcept {}
+    };
+
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void return_value(T v) { value = std::move(v); }
+
+    void unhandled_exception() { exception = std::current_exception(); }
+  };
+
+  Task(Task &&other) noexcept : _handle(std::exchange(other._handle, {})) {}
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+
+  ~Task() {
+    if (_handle)
+      _handle.destroy();
+  }
+
+  bool await_ready() const noexcept { return false; }
+
+  std::coroutine_handle<>
+  await_suspend(std::coroutine_handle<> continuation) noexcept {
+    _handle.promise().continuation = continuation;
+    return _handle;
+  }
+
+  T await_resume() {
+    auto &promise = _handle.promise();
+    if (promise.exception)
+      std::rethrow_exception(promise.exception);
+    return std::move(*promise.value);
+  }
+
+private:
+  explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+  std::coroutine_handle<promise_type> _handle;
+};
+
+/**
+ * @brief Awaiting the result suspends the coroutine and resumes it on a
+ * thread of `executor`.
+ */
+inline auto schedule(Executor &executor) {
+  struct Awaiter {
+    Executor &executor;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+      executor.submit([handle] { handle.resume(); });
+    }
+    void await_resume() const noexcept {}
+  };
+  return Awaiter{executor};
+}
+
+namespace detail {
+
+struct DetachedTask {
+  struct promise_type {
+    DetachedTask get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+template <typename T>
+DetachedTask fulfill(Task<T> task, std::promise<T> promise) {
+  try {
+    promise.set_value(co_await task);
+  } catch (...) {
+    promise.set_exception(std::current_exception());
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Start `task` and return a future of its result, for callers that
+ * are not coroutines.
+ */
+template <typename T> std::future<T> startTask(Task<T> task) {
+  std::promise<T> promise;
+  auto future = promise.get_future();
+  detail::fulfill(std::move(task), std::move(promise));
+  return future;
+}
+
+/**
+ * @brief Load a glTF or GLB file as a coroutine, so the awaiting coroutine
+ * never blocks a thread.
+ *
+ * Reading and decoding the file, loading the buffers, accessors and images,
+ * and loading the mesh primitives with their Draco meshes are separate
+ * stages. Each stage is resumed on `executor`, which must outlive
+ * the load, and spreads its work over the executor of `options`, which
+ * defaults to `executor`.
+ *
+ * @throws GLTFException If reading, parsing or loading fails.
+ */
+inline Task<GLTFDocumentPtr> loadAsync(std::filesystem::path path,
+                                       Executor &executor,
+                                       LoadOptions options = LoadOptions()) {
+  // I/O and JSON decode, streaming the file once
+  co_await schedule(executor);
+  auto file = GLTFFile::parseFile(path);
+
+  co_await schedule(executor);
+  if (!options.executor)
+    options.executor = &executor;
+  GLTFData data(std::move(file), std::move(options));
+  data.checkMemoryBudget();
+
+  // buffers, accessors and images
+  co_await schedule(executor);
+  data.loadPhase(LoadPhase::Buffers);
+  data.loadPhase(LoadPhase::BufferViews);
+  data.loadPhase(LoadPhase::AccessorBuffers);
+  data.loadPhase(LoadPhase::ImageBuffers);
+
+  // mesh primitives, including Draco decoding
+  co_await schedule(executor);
+  data.loadPhase(LoadPhase::MeshPrimitives);
+
+  co_return GLTFDocument::freeze(std::move(data));
+}
+
+} // namespace gltf2
+
+#endif /* __cpp_impl_coroutine */
+
+#endif /* GLTFAsync_h */
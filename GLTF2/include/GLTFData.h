@@ -3,12 +3,19 @@
 
 #include "GLTFFile.h"
 #include "Json.h"
+#include "LoadOptions.h"
+#include "MemoryBudget.h"
 #include <filesystem>
 #include <fstream>
 #include <future>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
+
+namespace draco {
+class Mesh;
+} // namespace draco
 
 namespace gltf2 {
 
@@ -21,19 +28,83 @@ struct BufferView {
   Buffer toBuffer() const { return Buffer(data, data + bytes); }
 };
 
+/**
+ * @brief A sparse accessor kept as an overlay: the elements of its
+ * bufferView, or zeros without one, with some of them replaced.
+ */
+struct SparseAccessorBuffer {
+  /// The first element of the base in the loaded buffer, or null when the
+  /// base is all zeros.
+  const uint8_t *base = nullptr;
+  uint32_t baseStride = 0;
+  /// The number of elements of the accessor.
+  uint32_t count = 0;
+  uint32_t elementSize = 0;
+  /// The indices of the replaced elements, in increasing order.
+  std::vector<uint32_t> indices;
+  /// The replacing elements, packed in the order of `indices`.
+  Buffer values;
+
+  /**
+   * @brief Call `fn(index, element)` for the replaced elements only, for
+   * consumers such as morph targets that apply them to another buffer.
+   */
+  template <typename Fn> void forEachValue(Fn &&fn) const {
+    for (size_t i = 0; i < indices.size(); i++)
+      fn(indices[i], values.data() + i * elementSize);
+  }
+
+  /**
+   * @brief Write the `count` dense elements to `dst`: copy the base, then
+   * scatter the values.
+   */
+  void densify(uint8_t *dst) const;
+
+  Buffer toBuffer() const {
+    Buffer buffer((size_t)count * elementSize);
+    densify(buffer.data());
+    return buffer;
+  }
+};
+
 struct AccessorBuffer {
+  /// The dense elements, empty when the accessor is kept as `sparse`.
   Buffer buffer;
   bool normalized;
+  std::shared_ptr<const SparseAccessorBuffer> sparse;
 
   AccessorBuffer(Buffer buffer, bool normalized)
-      : buffer(buffer), normalized(normalized) {}
+      : buffer(std::move(buffer)), normalized(normalized) {}
+
+  explicit AccessorBuffer(std::shared_ptr<const SparseAccessorBuffer> sparse)
+      : normalized(false), sparse(std::move(sparse)) {}
 };
 
 struct MeshPrimitiveSource {
+  /// The dense elements, empty when the accessor is kept as `sparse`.
   Buffer buffer;
   uint32_t vectorCount;
   uint8_t componentsPerVector;
   json::Accessor::ComponentType componentType;
+  std::shared_ptr<const SparseAccessorBuffer> sparse;
+  /// Whether the integer components are normalized. Only kept quantized
+  /// sources have normalized components, see
+  /// `LoadOptions::keepQuantizedAttributes`.
+  bool normalized = false;
+
+  /**
+   * @brief The factor that dequantizes a normalized component `c`:
+   * `max(c * scale, -1)`. It is 1 for floats and for integers that are not
+   * normalized, whose dequantization is part of the node transform under
+   * KHR_mesh_quantization.
+   */
+  float dequantizationScale() const;
+
+  /**
+   * @brief Expand the components to 32-bit floats, with the SIMD
+   * conversions of `convertAccessor`.
+   */
+  Buffer toFloatBuffer() const;
 };
 
 struct MeshPrimitiveSources {
@@ -53,27 +124,55 @@ struct MeshPrimitiveElement {
   json::Accessor::ComponentType componentType;
 };
 
+/**
+ * @brief The number of primitives that `indicesCount` indices, or vertices
+ * without indices, draw in `mode`.
+ */
+uint32_t primitiveCountOfMode(json::MeshPrimitive::Mode mode,
+                              uint32_t indicesCount);
+
 struct MeshPrimitive {
   MeshPrimitiveSources sources;
   std::optional<MeshPrimitiveElement> element;
   std::vector<MeshPrimitiveSources> targets;
 };
 
+/**
+ * @brief The phases of `GLTFData::eagerLoad`, in order.
+ */
+enum class LoadPhase {
+  Buffers,
+  BufferViews,
+  AccessorBuffers,
+  ImageBuffers,
+  MeshPrimitives
+};
+
 class GLTFData {
 public:
-  GLTFData(const GLTFFile &&file) : _file(std::move(file)){};
+  GLTFData(GLTFFile &&file, LoadOptions options = LoadOptions())
+      : _file(std::move(file)), _options(std::move(options)),
+        _stats(std::make_unique<LoadStatsRecorder>()),
+        _memory(std::make_unique<MemoryCounter>(_options.memoryBudget)){};
 
   std::future<void> eagerLoad();
 
-  static GLTFData load(const GLTFFile &&file) {
-    GLTFData data(std::move(file));
+  static GLTFData load(GLTFFile &&file,
+                       LoadOptions options = LoadOptions()) {
+    GLTFData data(std::move(file), std::move(options));
     data.eagerLoad().get();
     return std::move(data);
   }
 
   const json::Json &json() const { return _file.json(); }
 
-  const json::Json &&moveJson() const { return _file.moveJson(); }
+  const LoadOptions &options() const { return _options; }
+
+  /**
+   * @brief Move the JSON out of this data, leaving it empty. Use
+   * `GLTFDocument` to share the JSON and the loaded data instead.
+   */
+  json::Json moveJson() { return _file.moveJson(); }
 
   const std::vector<std::unique_ptr<Buffer>> &buffers() const {
     return _buffers;
@@ -115,41 +214,170 @@ public:
     return *_meshPrimitives.at(meshIndex).at(index);
   }
 
+  /*
+   * The phases of `eagerLoad`. Each phase replaces the results of a previous
+   * run of itself and depends on the results of the phases before it:
+   * loadBuffers, loadBufferViews, then loadAccessorBuffers and
+   * loadImageBuffers, then loadMeshPrimitives.
+   */
+
+  std::future<void> loadBuffers();
+  std::future<void> loadBufferViews();
+  std::future<void> loadAccessorBuffers();
+  std::future<void> loadImageBuffers();
+  std::future<void> loadMeshPrimitives();
+
+  /**
+   * @brief Run one phase on the calling thread, spreading its work over the
+   * executor with `Executor::parallelFor`. The functions above run this as a
+   * task of the executor.
+   */
+  void loadPhase(LoadPhase phase);
+
+  /**
+   * @brief Statistics of parsing the file and of every phase loaded so far.
+   * `eagerLoad` starts over from the statistics of the file.
+   */
+  LoadStats stats() const;
+
+  /**
+   * @brief The bytes a full load of this document is expected to allocate.
+   */
+  MemoryEstimate estimateMemory() const {
+    return gltf2::estimateMemory(json());
+  }
+
+  /**
+   * @brief The bytes allocated by the phases loaded since the last
+   * `eagerLoad`, as counted against `LoadOptions::memoryBudget`.
+   */
+  uint64_t allocatedBytes() const { return _memory->bytes(); }
+
+  /**
+   * @brief Check the estimate of the whole load against
+   * `LoadOptions::memoryBudget`. `eagerLoad` does this before loading.
+   * @throws MemoryBudgetException If the estimate exceeds the budget.
+   */
+  void checkMemoryBudget() const;
+
+  /**
+   * @brief Whether every phase has been loaded, so that every buffer,
+   * bufferView, accessor, image and mesh primitive can be read.
+   */
+  bool isLoaded() const;
+
 private:
   GLTFFile _file;
+  LoadOptions _options;
   std::vector<std::unique_ptr<Buffer>> _buffers;
   std::vector<std::unique_ptr<BufferView>> _bufferViews;
   std::vector<std::unique_ptr<AccessorBuffer>> _accessorBuffers;
   std::vector<std::unique_ptr<Buffer>> _imageBuffers;
   std::vector<std::vector<std::unique_ptr<MeshPrimitive>>> _meshPrimitives;
+  std::unique_ptr<LoadStatsRecorder> _stats;
+  std::unique_ptr<MemoryCounter> _memory;
+  /// The accessors that are not normalized to floats while loading.
+  std::vector<bool> _quantizedAccessors;
+  /// The decoded Draco meshes by bufferView, while loading mesh primitives.
+  std::vector<std::shared_ptr<const draco::Mesh>> _dracoMeshes;
 
   void clear();
 
-  std::future<void> loadBuffers();
-  std::future<void> loadBufferAt(uint32_t index);
-
-  std::future<void> loadBufferViews();
-  std::future<void> loadBufferViewAt(uint32_t index);
-
-  std::future<void> loadAccessorBuffers();
-  std::future<void> loadAccessorBufferAt(uint32_t index);
-
-  std::future<void> loadImageBuffers();
-  std::future<void> loadImageBufferAt(uint32_t index);
-
-  std::future<void> loadMeshPrimitives();
-  std::future<void> loadMeshPrimitiveAtMesh(uint32_t meshIndex);
-  std::future<void> loadMeshPrimitiveAt(uint32_t meshIndex,
-                                        uint32_t primitiveIndex);
+  Executor &executor() const;
+
+  /**
+   * @brief Run `fn` as a task of the executor.
+   */
+  std::future<void> submit(std::function<void()> fn) const;
+
+  /**
+   * @brief Call `fn` for `[0, count)` on the executor, counting each call as
+   * a task of `phase`.
+   */
+  void forEach(LoadStatsRecorder::Phase phase, size_t count,
+               const std::function<void(uint32_t)> &fn) const;
+
+  /**
+   * @brief Resize `results` to the items and load each with `loadAt`.
+   */
+  template <typename T, typename Results>
+  void loadEach(LoadStatsRecorder::Phase phase, const char *name,
+                const std::optional<std::vector<T>> &items, Results &results,
+                void (GLTFData::*loadAt)(uint32_t));
+
+  void loadBufferAt(uint32_t index);
+  void loadBufferViewAt(uint32_t index);
+
+  /**
+   * @brief Decode the EXT_meshopt_compression data of a bufferView into
+   * `dst`, its range in the fallback buffer.
+   * @throws InvalidFormatException If the data is out of range or cannot be
+   * decoded.
+   */
+  void decodeMeshoptBufferViewAt(uint32_t index, uint8_t *dst);
+  void loadAccessorBufferAt(uint32_t index);
+
+  /**
+   * @brief Validate the ranges of an accessor and reserve its memory.
+   */
+  void reserveAccessorAt(uint32_t index);
+
+  /**
+   * @brief Whether the accessor is loaded as floats converted from its
+   * normalized integers.
+   */
+  bool normalizesAccessorAt(uint32_t index) const;
+
+  bool keepsSparseAt(uint32_t index) const;
+
+  /**
+   * @brief The accessors of the positions, normals, tangents and texcoords
+   * of meshes, which `LoadOptions::keepQuantizedAttributes` keeps as
+   * integers.
+   */
+  std::vector<bool> quantizedAccessors() const;
+
+  /**
+   * @brief Group the accessors for loading: accessors with the same count
+   * interleaved in one bufferView share a group, every other accessor is
+   * alone in its group.
+   */
+  std::vector<std::vector<uint32_t>> accessorGroups() const;
+
+  /**
+   * @brief Load the accessors of one group of interleaved accessors in a
+   * single pass over their bufferView.
+   */
+  void deinterleaveAccessorBuffersAt(const std::vector<uint32_t> &indices);
+  void loadImageBufferAt(uint32_t index);
+  void loadMeshPrimitiveAtMesh(uint32_t meshIndex);
+  void loadMeshPrimitiveAt(uint32_t meshIndex, uint32_t primitiveIndex);
 
   std::vector<uint32_t>
   indicesForAccessorSparse(const json::AccessorSparse &sparse) const;
+  SparseAccessorBuffer sparseAccessorBufferAt(uint32_t index) const;
 
   MeshPrimitiveSource meshPrimitiveSourceFromAccessor(uint32_t index) const;
-  std::future<MeshPrimitive> meshPrimitiveFromDracoExtension(
-      const json::MeshPrimitiveDracoExtension &extension) const;
-  MeshPrimitiveSources
-  meshPrimitiveSourcesFromTarget(const json::MeshPrimitiveTarget &target) const;
+  /**
+   * @brief Decode the Draco meshes of all mesh primitives into
+   * `_dracoMeshes`, concurrently and once for each bufferView.
+   * @throws InvalidFormatException If a mesh fails to decode.
+   */
+  void decodeDracoMeshes();
+  /**
+   * @brief Load the attributes of a primitive with KHR_draco_mesh_compression
+   * from its decoded Draco mesh by their unique ids, or from their accessors
+   * for the attributes that are not compressed.
+   */
+  MeshPrimitive
+  meshPrimitiveFromDracoExtension(const json::MeshPrimitive &primitive) const;
+  /**
+   * @brief Load the sources of `target`, and the texcoords, colors, joints
+   * and weights of `attributes` when it is given.
+   */
+  MeshPrimitiveSources meshPrimitiveSourcesFromTarget(
+      const json::MeshPrimitiveTarget &target,
+      const json::MeshPrimitiveAttributes *attributes = nullptr) const;
 };
 
 } // namespace gltf2
@@ -0,0 +1,69 @@
+#ifndef GLTFDocument_h
+#define GLTFDocument_h
+
+#include "GLTFData.h"
+#include <memory>
+
+namespace gltf2 {
+
+class GLTFDocument;
+
+using GLTFDocumentPtr = std::shared_ptr<const GLTFDocument>;
+
+/**
+ * @brief A fully loaded glTF document that can no longer change.
+ *
+ * Documents are only handed out as `GLTFDocumentPtr`, which gives const
+ * access alone, so any number of threads can read one document without
+ * copies or locks. The accessors below return handles that share ownership
+ * of the document: a handle keeps the whole document alive after every
+ * other reference to it is gone.
+ */
+class GLTFDocument : public std::enable_shared_from_this<GLTFDocument> {
+public:
+  /**
+   * @brief Load every phase of `file` and freeze the result.
+   * @throws GLTFException If loading fails.
+   */
+  static GLTFDocumentPtr load(GLTFFile &&file,
+                              LoadOptions options = LoadOptions());
+
+  /**
+   * @brief Freeze data whose phases have all been loaded.
+   * @throws InputException If a phase of `data` has not been loaded.
+   */
+  static GLTFDocumentPtr freeze(GLTFData &&data);
+
+  GLTFDocument(const GLTFDocument &) = delete;
+  GLTFDocument &operator=(const GLTFDocument &) = delete;
+
+  const GLTFData &data() const { return _data; }
+
+  const json::Json &json() const { return _data.json(); }
+
+  std::shared_ptr<const json::Json> sharedJson() const;
+
+  std::shared_ptr<const Buffer> bufferAt(uint32_t index) const;
+
+  std::shared_ptr<const AccessorBuffer> accessorBufferAt(uint32_t index) const;
+
+  std::shared_ptr<const Buffer> imageBufferAt(uint32_t index) const;
+
+  std::shared_ptr<const json::Mesh> meshAt(uint32_t index) const;
+
+  std::shared_ptr<const MeshPrimitive> meshPrimitiveAt(uint32_t meshIndex,
+                                                       uint32_t index) const;
+
+private:
+  explicit GLTFDocument(GLTFData &&data) : _data(std::move(data)) {}
+
+  template <typename T> std::shared_ptr<const T> share(const T &value) const {
+    return std::shared_ptr<const T>(shared_from_this(), &value);
+  }
+
+  GLTFData _data;
+};
+
+} // namespace gltf2
+
+#endif /* GLTFDocument_h */
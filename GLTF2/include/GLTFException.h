@@ -39,6 +39,17 @@ public:
   const char *what() const noexcept override { return message.c_str(); }
 };
 
+class MemoryBudgetException : public GLTFException {
+private:
+  std::string message;
+
+public:
+  MemoryBudgetException(std::string context)
+      : message("memory budget exceeded: " + context) {}
+
+  const char *what() const noexcept override { return message.c_str(); }
+};
+
 } // namespace gltf2
 
 #endif /* GLTFException_h */
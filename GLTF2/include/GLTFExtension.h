@@ -19,8 +19,11 @@ extern const std::string GLTFExtensionKHRMaterialsSpecular;
 extern const std::string GLTFExtensionKHRMaterialsTransmission;
 extern const std::string GLTFExtensionKHRMaterialsUnlit;
 extern const std::string GLTFExtensionKHRMaterialsVolume;
+extern const std::string GLTFExtensionKHRMeshQuantization;
 extern const std::string GLTFExtensionKHRTextureTransform;
 
+extern const std::string GLTFExtensionEXTMeshoptCompression;
+
 extern const std::string GLTFExtensionVRM;
 extern const std::string GLTFExtensionVRMCvrm;
 extern const std::string GLTFExtensionVRMCSpringBone;
@@ -2,6 +2,7 @@
 #define GLTFFile_h
 
 #include "Json.h"
+#include "LoadStats.h"
 #include <filesystem>
 #include <fstream>
 #include <future>
@@ -35,33 +36,45 @@ public:
    */
   static GLTFFile
   parseStream(std::istream &&fs,
-              const std::optional<std::filesystem::path> path = std::nullopt,
-              const std::optional<Buffer> bin = std::nullopt);
+              std::optional<std::filesystem::path> path = std::nullopt,
+              std::optional<Buffer> bin = std::nullopt);
 
   GLTFFile() = delete;
 
   const json::Json &json() const { return _json; }
 
-  const json::Json &&moveJson() const { return std::move(_json); }
+  /**
+   * @brief Move the JSON out of this file, leaving it empty.
+   */
+  json::Json moveJson() { return std::move(_json); }
 
   const std::optional<std::filesystem::path> &path() const { return _path; }
 
   const std::optional<Buffer> &bin() const { return _bin; }
 
+  /**
+   * @brief Statistics of parsing the file. Only `parse` and `bytesFromFiles`
+   * are set.
+   */
+  const LoadStats &stats() const { return _stats; }
+
   Buffer bufferFromUri(const std::string &uri) const;
 
   Buffer getBuffer(const json::Buffer &buffer) const;
   Buffer getBuffer(uint32_t index) const;
 
 private:
+  friend class GLTFPrune;
+
   GLTFFile(json::Json json,
            std::optional<std::filesystem::path> path = std::nullopt,
            std::optional<Buffer> bin = std::nullopt)
-      : _json(json), _path(path), _bin(bin){};
+      : _json(std::move(json)), _path(std::move(path)), _bin(std::move(bin)){};
 
   json::Json _json;
   std::optional<std::filesystem::path> _path;
   std::optional<Buffer> _bin;
+  LoadStats _stats;
 };
 
 } // namespace gltf2
@@ -0,0 +1,64 @@
+#ifndef GLTFPrune_h
+#define GLTFPrune_h
+
+#include "GLTFFile.h"
+#include "Json.h"
+#include <cstdint>
+
+namespace gltf2 {
+
+/**
+ * @brief The number of objects of each kind removed by `GLTFPrune`.
+ */
+struct PruneResult {
+  uint32_t accessors = 0;
+  uint32_t buffers = 0;
+  uint32_t bufferViews = 0;
+  uint32_t cameras = 0;
+  uint32_t images = 0;
+  uint32_t materials = 0;
+  uint32_t meshes = 0;
+  uint32_t nodes = 0;
+  uint32_t samplers = 0;
+  uint32_t skins = 0;
+  uint32_t textures = 0;
+
+  uint32_t total() const {
+    return accessors + buffers + bufferViews + cameras + images + materials +
+           meshes + nodes + samplers + skins + textures;
+  }
+};
+
+/**
+ * @brief Removes objects that are not reachable from the document roots.
+ *
+ * The roots are the nodes of every scene (or every node if the document has
+ * no scenes), every animation, and the nodes, meshes, materials, textures and
+ * images referenced by the VRM, VRMC_vrm and VRMC_springBone extensions. An
+ * object is kept if it is reachable from a root through any index
+ * reference; all other accessors, buffers, bufferViews, cameras, images,
+ * materials, meshes, nodes, samplers, skins and textures are removed, and
+ * every remaining index is renumbered consistently.
+ *
+ * Scenes, animations and lights are never removed.
+ */
+class GLTFPrune {
+public:
+  /**
+   * @brief Prune the document in place.
+   *
+   * @throws InvalidFormatException If the document contains an index out of
+   * range.
+   */
+  static PruneResult prune(json::Json &json);
+
+  /**
+   * @brief Prune the document of a parsed file. Its buffers are kept as they
+   * are; only the document refers to fewer ranges of them.
+   */
+  static GLTFFile prune(GLTFFile &&file, PruneResult *result = nullptr);
+};
+
+} // namespace gltf2
+
+#endif /* GLTFPrune_h */
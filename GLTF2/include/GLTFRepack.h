@@ -0,0 +1,56 @@
+#ifndef GLTFRepack_h
+#define GLTFRepack_h
+
+#include "GLBWriter.h"
+#include "GLTFData.h"
+#include "GLTFFile.h"
+#include <filesystem>
+
+namespace gltf2 {
+
+/**
+ * @brief Repacks a glTF document into a single self-contained GLB.
+ *
+ * All buffers, including external `.bin` files and data URIs, and all
+ * external or data URI images are merged into one BIN chunk. BufferViews that
+ * are not referenced by any accessor, image or extension are dropped along
+ * with the byte ranges only they covered, and the remaining bufferViews are
+ * renumbered and packed at aligned offsets. BufferViews compressed with
+ * EXT_meshopt_compression are stored decoded.
+ */
+class GLTFRepack {
+public:
+  /**
+   * @brief Repack a parsed file.
+   *
+   * Only the buffers referenced by the remaining bufferViews are read, in
+   * parallel on `executor`. The returned writer owns everything it refers to.
+   *
+   * @throws InputException If a buffer or an image cannot be read.
+   * @throws InvalidFormatException If a bufferView is out of range of its
+   * buffer, or its EXT_meshopt_compression data cannot be decoded.
+   */
+  static GLBWriter repack(const GLTFFile &file,
+                          Executor &executor = defaultExecutor());
+
+  /**
+   * @brief Repack loaded data without reading any file again.
+   *
+   * The returned writer refers to the buffers of `data`, which must outlive
+   * it.
+   *
+   * @throws InvalidFormatException If a bufferView is out of range of its
+   * buffer.
+   */
+  static GLBWriter repack(const GLTFData &data);
+
+  /**
+   * @brief Repack the glTF or GLB file at `src` and write the GLB to `dst`.
+   */
+  static void repack(const std::filesystem::path &src,
+                     const std::filesystem::path &dst);
+};
+
+} // namespace gltf2
+
+#endif /* GLTFRepack_h */
@@ -224,11 +224,64 @@ public:
 
 // Buffer
 
+class BufferMeshoptExtension {
+public:
+  std::optional<bool> fallback;
+};
+
 class Buffer {
 public:
   std::optional<std::string> uri;
   uint32_t byteLength;
   std::optional<std::string> name;
+  std::optional<BufferMeshoptExtension> meshoptExtension;
+
+  /// Whether the buffer only reserves the space of the bufferViews
+  /// compressed by EXT_meshopt_compression.
+  bool isMeshoptFallback() const {
+    return meshoptExtension && meshoptExtension->fallback.value_or(false);
+  }
+};
+
+class BufferViewMeshoptExtension {
+public:
+  enum class Mode { ATTRIBUTES, TRIANGLES, INDICES };
+
+  static std::optional<Mode> ModeFromString(const std::string &value) {
+    if (value == "ATTRIBUTES")
+      return Mode::ATTRIBUTES;
+    else if (value == "TRIANGLES")
+      return Mode::TRIANGLES;
+    else if (value == "INDICES")
+      return Mode::INDICES;
+    else
+      return std::nullopt;
+  }
+
+  enum class Filter { NONE, OCTAHEDRAL, QUATERNION, EXPONENTIAL };
+
+  static std::optional<Filter> FilterFromString(const std::string &value) {
+    if (value == "NONE")
+      return Filter::NONE;
+    else if (value == "OCTAHEDRAL")
+      return Filter::OCTAHEDRAL;
+    else if (value == "QUATERNION")
+      return Filter::QUATERNION;
+    else if (value == "EXPONENTIAL")
+      return Filter::EXPONENTIAL;
+    else
+      return std::nullopt;
+  }
+
+  uint32_t buffer;
+  std::optional<uint32_t> byteOffset;
+  uint32_t byteLength;
+  uint32_t byteStride;
+  uint32_t count;
+  Mode mode;
+  std::optional<Filter> filter;
+
+  Filter filterValue() const { return filter.value_or(Filter::NONE); }
 };
 
 class BufferView {
@@ -239,6 +292,7 @@ public:
   std::optional<uint32_t> byteStride;
   std::optional<uint32_t> target;
   std::optional<std::string> name;
+  std::optional<BufferViewMeshoptExtension> meshoptExtension;
 };
 
 // Camera
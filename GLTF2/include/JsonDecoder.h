@@ -720,6 +720,14 @@ public:
     decodeValue(j, "uri", buffer.uri);
     decodeValue(j, "byteLength", buffer.byteLength);
     decodeValue(j, "name", buffer.name);
+    auto extensionsObj = decodeOptionalObj(j, "extensions");
+    if (extensionsObj) {
+      decodeObjWithMap<BufferMeshoptExtension>(
+          *extensionsObj, GLTFExtensionEXTMeshoptCompression,
+          buffer.meshoptExtension, [this](const nlohmann::json &value) {
+            return decodeBufferMeshoptExtension(value);
+          });
+    }
     return buffer;
   }
 
@@ -731,6 +739,14 @@ public:
     decodeValue(j, "byteStride", bufferView.byteStride);
     decodeValue(j, "target", bufferView.target);
     decodeValue(j, "name", bufferView.name);
+    auto extensionsObj = decodeOptionalObj(j, "extensions");
+    if (extensionsObj) {
+      decodeObjWithMap<BufferViewMeshoptExtension>(
+          *extensionsObj, GLTFExtensionEXTMeshoptCompression,
+          bufferView.meshoptExtension, [this](const nlohmann::json &value) {
+            return decodeBufferViewMeshoptExtension(value);
+          });
+    }
     return bufferView;
   }
 
@@ -1323,6 +1339,30 @@ public:
     return dracoExtension;
   }
 
+#pragma mark - meshopt
+  BufferMeshoptExtension decodeBufferMeshoptExtension(const nlohmann::json &j) {
+    BufferMeshoptExtension meshoptExtension;
+    decodeValue(j, "fallback", meshoptExtension.fallback);
+    return meshoptExtension;
+  }
+
+  BufferViewMeshoptExtension
+  decodeBufferViewMeshoptExtension(const nlohmann::json &j) {
+    BufferViewMeshoptExtension meshoptExtension;
+    decodeValue(j, "buffer", meshoptExtension.buffer);
+    decodeValue(j, "byteOffset", meshoptExtension.byteOffset);
+    decodeValue(j, "byteLength", meshoptExtension.byteLength);
+    decodeValue(j, "byteStride", meshoptExtension.byteStride);
+    decodeValue(j, "count", meshoptExtension.count);
+    decodeEnumValue<BufferViewMeshoptExtension::Mode>(
+        j, "mode", meshoptExtension.mode,
+        BufferViewMeshoptExtension::ModeFromString);
+    decodeEnumValue<BufferViewMeshoptExtension::Filter>(
+        j, "filter", meshoptExtension.filter,
+        BufferViewMeshoptExtension::FilterFromString);
+    return meshoptExtension;
+  }
+
 #pragma mark - KHR
 
   KHRTextureTransform decodeKHRTextureTransform(const nlohmann::json &j) {
@@ -0,0 +1,1627 @@
+#ifndef JsonEncoder_h
+#define JsonEncoder_h
+
+#include "GLTFException.h"
+#include "GLTFExtension.h"
+#include "Json.h"
+#include "nlohmann/json.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace gltf2 {
+namespace json {
+
+/**
+ * @brief Encodes a `Json` document back into its glTF JSON representation.
+ *
+ * This is the inverse of `JsonDecoder`: every property modelled by `Json` is
+ * written under the same key the decoder reads it from, and absent optionals
+ * are omitted. Properties the decoder does not model (`extras`, unknown
+ * extensions) are not preserved.
+ */
+class JsonEncoder {
+public:
+  static nlohmann::json encode(const Json &json) {
+    return JsonEncoder().encodeJson(json);
+  }
+
+  JsonEncoder(const JsonEncoder &) = delete;
+  JsonEncoder &operator=(const JsonEncoder &) = delete;
+
+  JsonEncoder(){};
+
+  /**
+   * @brief Finds the string representation of an enumerated value.
+   *
+   * The decoder maps strings to enums with the `*FromString` functions of the
+   * model classes. This function inverts such a mapping by trying each of the
+   * given candidate strings, so the encoder can never disagree with the
+   * decoder about the spelling of a value.
+   *
+   * @tparam T The enumerated type.
+   * @param value The value to encode.
+   * @param fromString The decoder's mapping function for `T`.
+   * @param candidates Every string `fromString` accepts.
+   * @return std::string The string that decodes to `value`.
+   *
+   * @throws InvalidFormatException If no candidate maps to `value`.
+   */
+  template <typename T>
+  std::string
+  encodeEnumString(T value,
+                   std::function<std::optional<T>(const std::string &)> fromString,
+                   const std::vector<std::string> &candidates) {
+    for (const auto &candidate : candidates) {
+      if (fromString(candidate) == value)
+        return candidate;
+    }
+    throw InvalidFormatException("unknown enum value " +
+                                 std::to_string(static_cast<int>(value)));
+  }
+
+  /**
+   * @brief Writes a value under the given key.
+   */
+  template <typename T>
+  void encodeValue(nlohmann::json &j, const std::string &key, const T &value) {
+    j[key] = value;
+  }
+
+  /**
+   * @brief Writes an optional value under the given key if it is present.
+   */
+  template <typename T>
+  void encodeValue(nlohmann::json &j, const std::string &key,
+                   const std::optional<T> &value) {
+    if (value)
+      j[key] = *value;
+  }
+
+  /**
+   * @brief Writes a value under the given key after converting it with a
+   * mapping function.
+   */
+  template <typename T>
+  void encodeValueWithMap(nlohmann::json &j, const std::string &key,
+                          const T &value,
+                          std::function<nlohmann::json(const T &)> mapFunc) {
+    j[key] = mapFunc(value);
+  }
+
+  /**
+   * @brief Writes an optional value under the given key after converting it
+   * with a mapping function. Nothing is written if the value is absent.
+   */
+  template <typename T>
+  void encodeValueWithMap(nlohmann::json &j, const std::string &key,
+                          const std::optional<T> &value,
+                          std::function<nlohmann::json(const T &)> mapFunc) {
+    if (value)
+      j[key] = mapFunc(*value);
+  }
+
+  /**
+   * @brief Writes an array under the given key, converting each element with
+   * a mapping function.
+   */
+  template <typename T>
+  void
+  encodeArrayWithMapElem(nlohmann::json &j, const std::string &key,
+                         const std::vector<T> &values,
+                         std::function<nlohmann::json(const T &)> mapFunc) {
+    auto array = nlohmann::json::array();
+    for (const auto &value : values) {
+      array.push_back(mapFunc(value));
+    }
+    j[key] = array;
+  }
+
+  /**
+   * @brief Writes an optional array under the given key, converting each
+   * element with a mapping function. Nothing is written if the array is
+   * absent.
+   */
+  template <typename T>
+  void
+  encodeArrayWithMapElem(nlohmann::json &j, const std::string &key,
+                         const std::optional<std::vector<T>> &values,
+                         std::function<nlohmann::json(const T &)> mapFunc) {
+    if (values)
+      encodeArrayWithMapElem(j, key, *values, mapFunc);
+  }
+
+  nlohmann::json
+  encodeAccessorSparseIndices(const AccessorSparseIndices &indices) {
+    nlohmann::json j;
+    encodeValue(j, "bufferView", indices.bufferView);
+    encodeValue(j, "byteOffset", indices.byteOffset);
+    encodeValue(j, "componentType",
+                static_cast<uint32_t>(indices.componentType));
+    return j;
+  }
+
+  nlohmann::json encodeAccessorSparseValues(const AccessorSparseValues &values) {
+    nlohmann::json j;
+    encodeValue(j, "bufferView", values.bufferView);
+    encodeValue(j, "byteOffset", values.byteOffset);
+    return j;
+  }
+
+  nlohmann::json encodeAccessorSparse(const AccessorSparse &sparse) {
+    nlohmann::json j;
+    encodeValue(j, "count", sparse.count);
+    j["indices"] = encodeAccessorSparseIndices(sparse.indices);
+    j["values"] = encodeAccessorSparseValues(sparse.values);
+    return j;
+  }
+
+  nlohmann::json encodeAccessor(const Accessor &accessor) {
+    nlohmann::json j;
+    encodeValue(j, "bufferView", accessor.bufferView);
+    encodeValue(j, "byteOffset", accessor.byteOffset);
+    encodeValue(j, "componentType",
+                static_cast<uint32_t>(accessor.componentType));
+    encodeValue(j, "normalized", accessor.normalized);
+    encodeValue(j, "count", accessor.count);
+    j["type"] = encodeEnumString<Accessor::Type>(
+        accessor.type, Accessor::TypeFromString,
+        {"SCALAR", "VEC2", "VEC3", "VEC4", "MAT2", "MAT3", "MAT4"});
+    encodeValue(j, "max", accessor.max);
+    encodeValue(j, "min", accessor.min);
+    encodeValueWithMap<AccessorSparse>(
+        j, "sparse", accessor.sparse,
+        [this](const AccessorSparse &value) {
+          return encodeAccessorSparse(value);
+        });
+    encodeValue(j, "name", accessor.name);
+    return j;
+  }
+
+  nlohmann::json
+  encodeAnimationChannelTarget(const AnimationChannelTarget &target) {
+    nlohmann::json j;
+    encodeValue(j, "node", target.node);
+    j["path"] = encodeEnumString<AnimationChannelTarget::Path>(
+        target.path, AnimationChannelTarget::PathFromString,
+        {"translation", "rotation", "scale", "weights"});
+    return j;
+  }
+
+  nlohmann::json encodeAnimationChannel(const AnimationChannel &channel) {
+    nlohmann::json j;
+    encodeValue(j, "sampler", channel.sampler);
+    j["target"] = encodeAnimationChannelTarget(channel.target);
+    return j;
+  }
+
+  nlohmann::json encodeAnimationSampler(const AnimationSampler &sampler) {
+    nlohmann::json j;
+    encodeValue(j, "input", sampler.input);
+    encodeValueWithMap<AnimationSampler::Interpolation>(
+        j, "interpolation", sampler.interpolation,
+        [this](const AnimationSampler::Interpolation &value) {
+          return encodeEnumString<AnimationSampler::Interpolation>(
+              value, AnimationSampler::InterpolationFromString,
+              {"LINEAR", "STEP", "CUBICSPLINE"});
+        });
+    encodeValue(j, "output", sampler.output);
+    return j;
+  }
+
+  nlohmann::json encodeAnimation(const Animation &animation) {
+    nlohmann::json j;
+    encodeValue(j, "name", animation.name);
+    encodeArrayWithMapElem<AnimationChannel>(
+        j, "channels", animation.channels,
+        [this](const AnimationChannel &value) {
+          return encodeAnimationChannel(value);
+        });
+    encodeArrayWithMapElem<AnimationSampler>(
+        j, "samplers", animation.samplers,
+        [this](const AnimationSampler &value) {
+          return encodeAnimationSampler(value);
+        });
+    return j;
+  }
+
+  nlohmann::json encodeAsset(const Asset &asset) {
+    nlohmann::json j;
+    encodeValue(j, "copyright", asset.copyright);
+    encodeValue(j, "generator", asset.generator);
+    encodeValue(j, "version", asset.version);
+    encodeValue(j, "minVersion", asset.minVersion);
+    return j;
+  }
+
+  nlohmann::json encodeBuffer(const Buffer &buffer) {
+    nlohmann::json j;
+    encodeValue(j, "uri", buffer.uri);
+    encodeValue(j, "byteLength", buffer.byteLength);
+    encodeValue(j, "name", buffer.name);
+    if (buffer.meshoptExtension) {
+      j["extensions"][GLTFExtensionEXTMeshoptCompression] =
+          encodeBufferMeshoptExtension(*buffer.meshoptExtension);
+    }
+    return j;
+  }
+
+  nlohmann::json encodeBufferView(const BufferView &bufferView) {
+    nlohmann::json j;
+    encodeValue(j, "buffer", bufferView.buffer);
+    encodeValue(j, "byteOffset", bufferView.byteOffset);
+    encodeValue(j, "byteLength", bufferView.byteLength);
+    encodeValue(j, "byteStride", bufferView.byteStride);
+    encodeValue(j, "target", bufferView.target);
+    encodeValue(j, "name", bufferView.name);
+    if (bufferView.meshoptExtension) {
+      j["extensions"][GLTFExtensionEXTMeshoptCompression] =
+          encodeBufferViewMeshoptExtension(*bufferView.meshoptExtension);
+    }
+    return j;
+  }
+
+  nlohmann::json encodeCameraOrthographic(const CameraOrthographic &camera) {
+    nlohmann::json j;
+    encodeValue(j, "xmag", camera.xmag);
+    encodeValue(j, "ymag", camera.ymag);
+    encodeValue(j, "zfar", camera.zfar);
+    encodeValue(j, "znear", camera.znear);
+    return j;
+  }
+
+  nlohmann::json encodeCameraPerspective(const CameraPerspective &camera) {
+    nlohmann::json j;
+    encodeValue(j, "aspectRatio", camera.aspectRatio);
+    encodeValue(j, "yfov", camera.yfov);
+    encodeValue(j, "zfar", camera.zfar);
+    encodeValue(j, "znear", camera.znear);
+    return j;
+  }
+
+  nlohmann::json encodeCamera(const Camera &camera) {
+    nlohmann::json j;
+    j["type"] = encodeEnumString<Camera::Type>(
+        camera.type, Camera::TypeFromString, {"perspective", "orthographic"});
+    encodeValue(j, "name", camera.name);
+    encodeValueWithMap<CameraPerspective>(
+        j, "perspective", camera.perspective,
+        [this](const CameraPerspective &value) {
+          return encodeCameraPerspective(value);
+        });
+    encodeValueWithMap<CameraOrthographic>(
+        j, "orthographic", camera.orthographic,
+        [this](const CameraOrthographic &value) {
+          return encodeCameraOrthographic(value);
+        });
+    return j;
+  }
+
+  nlohmann::json encodeImage(const Image &image) {
+    nlohmann::json j;
+    encodeValue(j, "uri", image.uri);
+    encodeValueWithMap<Image::MimeType>(
+        j, "mimeType", image.mimeType, [this](const Image::MimeType &value) {
+          return encodeEnumString<Image::MimeType>(
+              value, Image::MimeTypeFromString, {"image/jpeg", "image/png"});
+        });
+    encodeValue(j, "bufferView", image.bufferView);
+    encodeValue(j, "name", image.name);
+    return j;
+  }
+
+  nlohmann::json encodeTexture(const Texture &texture) {
+    nlohmann::json j;
+    encodeValue(j, "sampler", texture.sampler);
+    encodeValue(j, "source", texture.source);
+    encodeValue(j, "name", texture.name);
+    return j;
+  }
+
+  void encodeTextureInfoProperties(nlohmann::json &j,
+                                   const TextureInfo &textureInfo) {
+    encodeValue(j, "index", textureInfo.index);
+    encodeValue(j, "texCoord", textureInfo.texCoord);
+    if (textureInfo.khrTextureTransform) {
+      j["extensions"][GLTFExtensionKHRTextureTransform] =
+          encodeKHRTextureTransform(*textureInfo.khrTextureTransform);
+    }
+  }
+
+  nlohmann::json encodeTextureInfo(const TextureInfo &textureInfo) {
+    nlohmann::json j;
+    encodeTextureInfoProperties(j, textureInfo);
+    return j;
+  }
+
+  nlohmann::json
+  encodeMaterialPBRMetallicRoughness(const MaterialPBRMetallicRoughness &pbr) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "baseColorFactor", pbr.baseColorFactor);
+    encodeValueWithMap<TextureInfo>(j, "baseColorTexture",
+                                    pbr.baseColorTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    encodeValue(j, "metallicFactor", pbr.metallicFactor);
+    encodeValue(j, "roughnessFactor", pbr.roughnessFactor);
+    encodeValueWithMap<TextureInfo>(j, "metallicRoughnessTexture",
+                                    pbr.metallicRoughnessTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    return j;
+  }
+
+  nlohmann::json
+  encodeMaterialNormalTextureInfo(const MaterialNormalTextureInfo &normal) {
+    nlohmann::json j;
+    encodeTextureInfoProperties(j, normal);
+    encodeValue(j, "scale", normal.scale);
+    return j;
+  }
+
+  nlohmann::json encodeMaterialOcclusionTextureInfo(
+      const MaterialOcclusionTextureInfo &occlusion) {
+    nlohmann::json j;
+    encodeTextureInfoProperties(j, occlusion);
+    encodeValue(j, "strength", occlusion.strength);
+    return j;
+  }
+
+  nlohmann::json
+  encodeShadingShiftTexture(const vrmc::ShadingShiftTexture &texture) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "index", texture.index);
+    encodeValue(j, "texCoord", texture.texCoord);
+    encodeValue(j, "scale", texture.scale);
+    return j;
+  }
+
+  nlohmann::json encodeMaterialsMtoon(const vrmc::MaterialsMtoon &mtoon) {
+    nlohmann::json j;
+    encodeValue(j, "specVersion", mtoon.specVersion);
+    encodeValue(j, "transparentWithZWrite", mtoon.transparentWithZWrite);
+    encodeValue(j, "renderQueueOffsetNumber", mtoon.renderQueueOffsetNumber);
+    encodeValue(j, "shadeColorFactor", mtoon.shadeColorFactor);
+    encodeValueWithMap<TextureInfo>(j, "shadeMultiplyTexture",
+                                    mtoon.shadeMultiplyTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    encodeValue(j, "shadingShiftFactor", mtoon.shadingShiftFactor);
+    encodeValueWithMap<vrmc::ShadingShiftTexture>(
+        j, "shadingShiftTexture", mtoon.shadingShiftTexture,
+        [this](const vrmc::ShadingShiftTexture &value) {
+          return encodeShadingShiftTexture(value);
+        });
+    encodeValue(j, "shadingToonyFactor", mtoon.shadingToonyFactor);
+    encodeValue(j, "giEqualizationFactor", mtoon.giEqualizationFactor);
+    encodeValue(j, "matcapFactor", mtoon.matcapFactor);
+    encodeValueWithMap<TextureInfo>(j, "matcapTexture", mtoon.matcapTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    encodeValue(j, "parametricRimColorFactor", mtoon.parametricRimColorFactor);
+    encodeValueWithMap<TextureInfo>(j, "rimMultiplyTexture",
+                                    mtoon.rimMultiplyTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    encodeValue(j, "rimLightingMixFactor", mtoon.rimLightingMixFactor);
+    encodeValue(j, "parametricRimFresnelPowerFactor",
+                mtoon.parametricRimFresnelPowerFactor);
+    encodeValue(j, "parametricRimLiftFactor", mtoon.parametricRimLiftFactor);
+    encodeValueWithMap<vrmc::MaterialsMtoon::OutlineWidthMode>(
+        j, "outlineWidthMode", mtoon.outlineWidthMode,
+        [this](const vrmc::MaterialsMtoon::OutlineWidthMode &value) {
+          return encodeEnumString<vrmc::MaterialsMtoon::OutlineWidthMode>(
+              value, vrmc::MaterialsMtoon::OutlineWidthModeFromString,
+              {"none", "worldCoordinates", "screenCoordinates"});
+        });
+    encodeValue(j, "outlineWidthFactor", mtoon.outlineWidthFactor);
+    encodeValueWithMap<TextureInfo>(j, "outlineWidthMultiplyTexture",
+                                    mtoon.outlineWidthMultiplyTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    encodeValue(j, "outlineColorFactor", mtoon.outlineColorFactor);
+    encodeValue(j, "outlineLightingMixFactor", mtoon.outlineLightingMixFactor);
+    encodeValueWithMap<TextureInfo>(j, "uvAnimationMaskTexture",
+                                    mtoon.uvAnimationMaskTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    encodeValue(j, "uvAnimationScrollXSpeedFactor",
+                mtoon.uvAnimationScrollXSpeedFactor);
+    encodeValue(j, "uvAnimationScrollYSpeedFactor",
+                mtoon.uvAnimationScrollYSpeedFactor);
+    encodeValue(j, "uvAnimationRotationSpeedFactor",
+                mtoon.uvAnimationRotationSpeedFactor);
+    return j;
+  }
+
+  nlohmann::json encodeMaterial(const Material &material) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "name", material.name);
+    encodeValueWithMap<MaterialPBRMetallicRoughness>(
+        j, "pbrMetallicRoughness", material.pbrMetallicRoughness,
+        [this](const MaterialPBRMetallicRoughness &value) {
+          return encodeMaterialPBRMetallicRoughness(value);
+        });
+    encodeValueWithMap<MaterialNormalTextureInfo>(
+        j, "normalTexture", material.normalTexture,
+        [this](const MaterialNormalTextureInfo &value) {
+          return encodeMaterialNormalTextureInfo(value);
+        });
+    encodeValueWithMap<MaterialOcclusionTextureInfo>(
+        j, "occlusionTexture", material.occlusionTexture,
+        [this](const MaterialOcclusionTextureInfo &value) {
+          return encodeMaterialOcclusionTextureInfo(value);
+        });
+    encodeValueWithMap<TextureInfo>(j, "emissiveTexture",
+                                    material.emissiveTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    encodeValue(j, "emissiveFactor", material.emissiveFactor);
+    encodeValueWithMap<Material::AlphaMode>(
+        j, "alphaMode", material.alphaMode,
+        [this](const Material::AlphaMode &value) {
+          return encodeEnumString<Material::AlphaMode>(
+              value, Material::AlphaModeFromString,
+              {"OPAQUE", "MASK", "BLEND"});
+        });
+    encodeValue(j, "alphaCutoff", material.alphaCutoff);
+    encodeValue(j, "doubleSided", material.doubleSided);
+
+    nlohmann::json extensions = nlohmann::json::object();
+    if (material.isUnlit())
+      extensions[GLTFExtensionKHRMaterialsUnlit] = nlohmann::json::object();
+    encodeValueWithMap<KHRMaterialAnisotropy>(
+        extensions, GLTFExtensionKHRMaterialsAnisotropy, material.anisotropy,
+        [this](const KHRMaterialAnisotropy &value) {
+          return encodeKHRMaterialAnisotropy(value);
+        });
+    encodeValueWithMap<KHRMaterialClearcoat>(
+        extensions, GLTFExtensionKHRMaterialsClearcoat, material.clearcoat,
+        [this](const KHRMaterialClearcoat &value) {
+          return encodeKHRMaterialClearcoat(value);
+        });
+    encodeValueWithMap<KHRMaterialDispersion>(
+        extensions, GLTFExtensionKHRMaterialsDispersion, material.dispersion,
+        [this](const KHRMaterialDispersion &value) {
+          return encodeKHRMaterialDispersion(value);
+        });
+    encodeValueWithMap<KHRMaterialEmissiveStrength>(
+        extensions, GLTFExtensionKHRMaterialsEmissiveStrength,
+        material.emissiveStrength,
+        [this](const KHRMaterialEmissiveStrength &value) {
+          return encodeKHRMaterialEmissiveStrength(value);
+        });
+    encodeValueWithMap<KHRMaterialIor>(extensions,
+                                       GLTFExtensionKHRMaterialsIor,
+                                       material.ior,
+                                       [this](const KHRMaterialIor &value) {
+                                         return encodeKHRMaterialIor(value);
+                                       });
+    encodeValueWithMap<KHRMaterialIridescence>(
+        extensions, GLTFExtensionKHRMaterialsIridescence,
+        material.iridescence, [this](const KHRMaterialIridescence &value) {
+          return encodeKHRMaterialIridescence(value);
+        });
+    encodeValueWithMap<KHRMaterialSheen>(
+        extensions, GLTFExtensionKHRMaterialsSheen, material.sheen,
+        [this](const KHRMaterialSheen &value) {
+          return encodeKHRMaterialSheen(value);
+        });
+    encodeValueWithMap<KHRMaterialSpecular>(
+        extensions, GLTFExtensionKHRMaterialsSpecular, material.specular,
+        [this](const KHRMaterialSpecular &value) {
+          return encodeKHRMaterialSpecular(value);
+        });
+    encodeValueWithMap<KHRMaterialTransmission>(
+        extensions, GLTFExtensionKHRMaterialsTransmission,
+        material.transmission, [this](const KHRMaterialTransmission &value) {
+          return encodeKHRMaterialTransmission(value);
+        });
+    encodeValueWithMap<KHRMaterialVolume>(
+        extensions, GLTFExtensionKHRMaterialsVolume, material.volume,
+        [this](const KHRMaterialVolume &value) {
+          return encodeKHRMaterialVolume(value);
+        });
+    encodeValueWithMap<vrmc::MaterialsMtoon>(
+        extensions, GLTFExtensionVRMCMaterialsMtoon, material.mtoon,
+        [this](const vrmc::MaterialsMtoon &value) {
+          return encodeMaterialsMtoon(value);
+        });
+    if (!extensions.empty())
+      j["extensions"] = extensions;
+
+    return j;
+  }
+
+  void encodeMeshPrimitiveTarget(nlohmann::json &j,
+                                 const MeshPrimitiveTarget &target) {
+    encodeValue(j, "POSITION", target.position);
+    encodeValue(j, "NORMAL", target.normal);
+    encodeValue(j, "TANGENT", target.tangent);
+  }
+
+  void encodeMeshPrimitiveAttributesSequenceKey(
+      nlohmann::json &j, const std::string &prefix,
+      const std::optional<std::vector<uint32_t>> &values) {
+    if (!values)
+      return;
+    for (size_t i = 0; i < values->size(); i++) {
+      j[prefix + "_" + std::to_string(i)] = values->at(i);
+    }
+  }
+
+  nlohmann::json
+  encodeMeshPrimitiveAttributes(const MeshPrimitiveAttributes &attributes) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeMeshPrimitiveTarget(j, attributes);
+    encodeMeshPrimitiveAttributesSequenceKey(j, "TEXCOORD",
+                                             attributes.texcoords);
+    encodeMeshPrimitiveAttributesSequenceKey(j, "COLOR", attributes.colors);
+    encodeMeshPrimitiveAttributesSequenceKey(j, "JOINTS", attributes.joints);
+    encodeMeshPrimitiveAttributesSequenceKey(j, "WEIGHTS",
+                                             attributes.weights);
+    return j;
+  }
+
+  nlohmann::json encodeMeshPrimitive(const MeshPrimitive &primitive) {
+    nlohmann::json j;
+    j["attributes"] = encodeMeshPrimitiveAttributes(primitive.attributes);
+    encodeValue(j, "indices", primitive.indices);
+    encodeValue(j, "material", primitive.material);
+    encodeValueWithMap<MeshPrimitive::Mode>(
+        j, "mode", primitive.mode, [](const MeshPrimitive::Mode &value) {
+          return static_cast<uint32_t>(value);
+        });
+    encodeArrayWithMapElem<MeshPrimitiveTarget>(
+        j, "targets", primitive.targets,
+        [this](const MeshPrimitiveTarget &value) {
+          nlohmann::json target = nlohmann::json::object();
+          encodeMeshPrimitiveTarget(target, value);
+          return target;
+        });
+    if (primitive.dracoExtension) {
+      j["extensions"][GLTFExtensionKHRDracoMeshCompression] =
+          encodeMeshPrimitiveDracoExtension(*primitive.dracoExtension);
+    }
+    return j;
+  }
+
+  nlohmann::json encodeMesh(const Mesh &mesh) {
+    nlohmann::json j;
+    encodeArrayWithMapElem<MeshPrimitive>(
+        j, "primitives", mesh.primitives, [this](const MeshPrimitive &value) {
+          return encodeMeshPrimitive(value);
+        });
+    encodeValue(j, "name", mesh.name);
+    encodeValue(j, "weights", mesh.weights);
+    return j;
+  }
+
+  nlohmann::json encodeNode(const Node &node) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "camera", node.camera);
+    encodeValue(j, "children", node.children);
+    encodeValue(j, "skin", node.skin);
+    encodeValue(j, "matrix", node.matrix);
+    encodeValue(j, "mesh", node.mesh);
+    encodeValue(j, "rotation", node.rotation);
+    encodeValue(j, "scale", node.scale);
+    encodeValue(j, "translation", node.translation);
+    encodeValue(j, "weights", node.weights);
+    encodeValue(j, "name", node.name);
+    return j;
+  }
+
+  nlohmann::json encodeSampler(const Sampler &sampler) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValueWithMap<Sampler::MagFilter>(
+        j, "magFilter", sampler.magFilter,
+        [](const Sampler::MagFilter &value) {
+          return static_cast<uint32_t>(value);
+        });
+    encodeValueWithMap<Sampler::MinFilter>(
+        j, "minFilter", sampler.minFilter,
+        [](const Sampler::MinFilter &value) {
+          return static_cast<uint32_t>(value);
+        });
+    encodeValueWithMap<Sampler::WrapMode>(j, "wrapS", sampler.wrapS,
+                                          [](const Sampler::WrapMode &value) {
+                                            return static_cast<uint32_t>(value);
+                                          });
+    encodeValueWithMap<Sampler::WrapMode>(j, "wrapT", sampler.wrapT,
+                                          [](const Sampler::WrapMode &value) {
+                                            return static_cast<uint32_t>(value);
+                                          });
+    encodeValue(j, "name", sampler.name);
+    return j;
+  }
+
+  nlohmann::json encodeScene(const Scene &scene) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "nodes", scene.nodes);
+    encodeValue(j, "name", scene.name);
+    return j;
+  }
+
+  nlohmann::json encodeSkin(const Skin &skin) {
+    nlohmann::json j;
+    encodeValue(j, "inverseBindMatrices", skin.inverseBindMatrices);
+    encodeValue(j, "skeleton", skin.skeleton);
+    encodeValue(j, "joints", skin.joints);
+    encodeValue(j, "name", skin.name);
+    return j;
+  }
+
+  nlohmann::json encodeJson(const Json &data) {
+    nlohmann::json j;
+
+    encodeValue(j, "extensionsUsed", data.extensionsUsed);
+    encodeValue(j, "extensionsRequired", data.extensionsRequired);
+
+    encodeArrayWithMapElem<Accessor>(
+        j, "accessors", data.accessors,
+        [this](const Accessor &item) { return encodeAccessor(item); });
+    encodeArrayWithMapElem<Animation>(
+        j, "animations", data.animations,
+        [this](const Animation &item) { return encodeAnimation(item); });
+
+    j["asset"] = encodeAsset(data.asset);
+
+    encodeArrayWithMapElem<Buffer>(
+        j, "buffers", data.buffers,
+        [this](const Buffer &item) { return encodeBuffer(item); });
+    encodeArrayWithMapElem<BufferView>(
+        j, "bufferViews", data.bufferViews,
+        [this](const BufferView &item) { return encodeBufferView(item); });
+    encodeArrayWithMapElem<Camera>(
+        j, "cameras", data.cameras,
+        [this](const Camera &item) { return encodeCamera(item); });
+    encodeArrayWithMapElem<Image>(
+        j, "images", data.images,
+        [this](const Image &item) { return encodeImage(item); });
+    encodeArrayWithMapElem<Material>(
+        j, "materials", data.materials,
+        [this](const Material &item) { return encodeMaterial(item); });
+    encodeArrayWithMapElem<Mesh>(
+        j, "meshes", data.meshes,
+        [this](const Mesh &item) { return encodeMesh(item); });
+    encodeArrayWithMapElem<Node>(
+        j, "nodes", data.nodes,
+        [this](const Node &item) { return encodeNode(item); });
+    encodeArrayWithMapElem<Sampler>(
+        j, "samplers", data.samplers,
+        [this](const Sampler &item) { return encodeSampler(item); });
+
+    encodeValue(j, "scene", data.scene);
+
+    encodeArrayWithMapElem<Scene>(
+        j, "scenes", data.scenes,
+        [this](const Scene &item) { return encodeScene(item); });
+    encodeArrayWithMapElem<Skin>(
+        j, "skins", data.skins,
+        [this](const Skin &item) { return encodeSkin(item); });
+    encodeArrayWithMapElem<Texture>(
+        j, "textures", data.textures,
+        [this](const Texture &item) { return encodeTexture(item); });
+
+    nlohmann::json extensions = nlohmann::json::object();
+    if (data.lights) {
+      encodeArrayWithMapElem<KHRLight>(
+          extensions[GLTFExtensionKHRLightsPunctual], "lights", *data.lights,
+          [this](const KHRLight &item) { return encodeKHRLight(item); });
+    }
+    encodeValueWithMap<vrm0::VRM>(
+        extensions, GLTFExtensionVRM, data.vrm0,
+        [this](const vrm0::VRM &item) { return encodeVRM0VRM(item); });
+    encodeValueWithMap<vrmc::VRM>(
+        extensions, GLTFExtensionVRMCvrm, data.vrm1,
+        [this](const vrmc::VRM &item) { return encodeVRM1VRM(item); });
+    encodeValueWithMap<vrmc::SpringBone>(
+        extensions, GLTFExtensionVRMCSpringBone, data.springBone,
+        [this](const vrmc::SpringBone &item) {
+          return encodeVRM1SpringBone(item);
+        });
+    if (!extensions.empty())
+      j["extensions"] = extensions;
+
+    return j;
+  }
+
+#pragma mark - draco
+  nlohmann::json encodeMeshPrimitiveDracoExtension(
+      const MeshPrimitiveDracoExtension &dracoExtension) {
+    nlohmann::json j;
+    encodeValue(j, "bufferView", dracoExtension.bufferView);
+    j["attributes"] = encodeMeshPrimitiveAttributes(dracoExtension.attributes);
+    return j;
+  }
+
+#pragma mark - meshopt
+  nlohmann::json
+  encodeBufferMeshoptExtension(const BufferMeshoptExtension &meshoptExtension) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "fallback", meshoptExtension.fallback);
+    return j;
+  }
+
+  nlohmann::json encodeBufferViewMeshoptExtension(
+      const BufferViewMeshoptExtension &meshoptExtension) {
+    nlohmann::json j;
+    encodeValue(j, "buffer", meshoptExtension.buffer);
+    encodeValue(j, "byteOffset", meshoptExtension.byteOffset);
+    encodeValue(j, "byteLength", meshoptExtension.byteLength);
+    encodeValue(j, "byteStride", meshoptExtension.byteStride);
+    encodeValue(j, "count", meshoptExtension.count);
+    j["mode"] = encodeEnumString<BufferViewMeshoptExtension::Mode>(
+        meshoptExtension.mode, BufferViewMeshoptExtension::ModeFromString,
+        {"ATTRIBUTES", "TRIANGLES", "INDICES"});
+    encodeValueWithMap<BufferViewMeshoptExtension::Filter>(
+        j, "filter", meshoptExtension.filter,
+        [this](const BufferViewMeshoptExtension::Filter &value) {
+          return encodeEnumString<BufferViewMeshoptExtension::Filter>(
+              value, BufferViewMeshoptExtension::FilterFromString,
+              {"NONE", "OCTAHEDRAL", "QUATERNION", "EXPONENTIAL"});
+        });
+    return j;
+  }
+
+#pragma mark - KHR
+
+  nlohmann::json encodeKHRTextureTransform(const KHRTextureTransform &t) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "offset", t.offset);
+    encodeValue(j, "rotation", t.rotation);
+    encodeValue(j, "scale", t.scale);
+    encodeValue(j, "texCoord", t.texCoord);
+    return j;
+  }
+
+  nlohmann::json
+  encodeKHRMaterialAnisotropy(const KHRMaterialAnisotropy &anisotropy) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "anisotropyStrength", anisotropy.anisotropyStrength);
+    encodeValue(j, "anisotropyRotation", anisotropy.anisotropyRotation);
+    encodeValueWithMap<TextureInfo>(j, "anisotropyTexture",
+                                    anisotropy.anisotropyTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    return j;
+  }
+
+  nlohmann::json
+  encodeKHRMaterialClearcoat(const KHRMaterialClearcoat &clearcoat) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "clearcoatFactor", clearcoat.clearcoatFactor);
+    encodeValueWithMap<TextureInfo>(j, "clearcoatTexture",
+                                    clearcoat.clearcoatTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    encodeValue(j, "clearcoatRoughnessFactor",
+                clearcoat.clearcoatRoughnessFactor);
+    encodeValueWithMap<TextureInfo>(j, "clearcoatRoughnessTexture",
+                                    clearcoat.clearcoatRoughnessTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    encodeValueWithMap<MaterialNormalTextureInfo>(
+        j, "clearcoatNormalTexture", clearcoat.clearcoatNormalTexture,
+        [this](const MaterialNormalTextureInfo &value) {
+          return encodeMaterialNormalTextureInfo(value);
+        });
+    return j;
+  }
+
+  nlohmann::json
+  encodeKHRMaterialDispersion(const KHRMaterialDispersion &dispersion) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "dispersion", dispersion.dispersion);
+    return j;
+  }
+
+  nlohmann::json
+  encodeKHRMaterialEmissiveStrength(const KHRMaterialEmissiveStrength &strength) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "emissiveStrength", strength.emissiveStrength);
+    return j;
+  }
+
+  nlohmann::json encodeKHRMaterialIor(const KHRMaterialIor &ior) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "ior", ior.ior);
+    return j;
+  }
+
+  nlohmann::json
+  encodeKHRMaterialIridescence(const KHRMaterialIridescence &iridescence) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "iridescenceFactor", iridescence.iridescenceFactor);
+    encodeValueWithMap<TextureInfo>(j, "iridescenceTexture",
+                                    iridescence.iridescenceTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    encodeValue(j, "iridescenceIor", iridescence.iridescenceIor);
+    encodeValue(j, "iridescenceThicknessMinimum",
+                iridescence.iridescenceThicknessMinimum);
+    encodeValue(j, "iridescenceThicknessMaximum",
+                iridescence.iridescenceThicknessMaximum);
+    encodeValueWithMap<TextureInfo>(j, "iridescenceThicknessTexture",
+                                    iridescence.iridescenceThicknessTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    return j;
+  }
+
+  nlohmann::json encodeKHRMaterialSheen(const KHRMaterialSheen &sheen) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "sheenColorFactor", sheen.sheenColorFactor);
+    encodeValueWithMap<TextureInfo>(j, "sheenColorTexture",
+                                    sheen.sheenColorTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    encodeValue(j, "sheenRoughnessFactor", sheen.sheenRoughnessFactor);
+    encodeValueWithMap<TextureInfo>(j, "sheenRoughnessTexture",
+                                    sheen.sheenRoughnessTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    return j;
+  }
+
+  nlohmann::json
+  encodeKHRMaterialSpecular(const KHRMaterialSpecular &specular) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "specularFactor", specular.specularFactor);
+    encodeValueWithMap<TextureInfo>(j, "specularTexture",
+                                    specular.specularTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    encodeValue(j, "specularColorFactor", specular.specularColorFactor);
+    encodeValueWithMap<TextureInfo>(j, "specularColorTexture",
+                                    specular.specularColorTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    return j;
+  }
+
+  nlohmann::json
+  encodeKHRMaterialTransmission(const KHRMaterialTransmission &transmission) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "transmissionFactor", transmission.transmissionFactor);
+    encodeValueWithMap<TextureInfo>(j, "transmissionTexture",
+                                    transmission.transmissionTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    return j;
+  }
+
+  nlohmann::json encodeKHRMaterialVolume(const KHRMaterialVolume &volume) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "thicknessFactor", volume.thicknessFactor);
+    encodeValueWithMap<TextureInfo>(j, "thicknessTexture",
+                                    volume.thicknessTexture,
+                                    [this](const TextureInfo &value) {
+                                      return encodeTextureInfo(value);
+                                    });
+    encodeValue(j, "attenuationDistance", volume.attenuationDistance);
+    encodeValue(j, "attenuationColor", volume.attenuationColor);
+    return j;
+  }
+
+  nlohmann::json encodeKHRLightSpot(const KHRLightSpot &spot) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "innerConeAngle", spot.innerConeAngle);
+    encodeValue(j, "outerConeAngle", spot.outerConeAngle);
+    return j;
+  }
+
+  nlohmann::json encodeKHRLight(const KHRLight &light) {
+    nlohmann::json j;
+    encodeValue(j, "name", light.name);
+    encodeValue(j, "color", light.color);
+    encodeValue(j, "intensity", light.intensity);
+    j["type"] = encodeEnumString<KHRLight::Type>(
+        light.type, KHRLight::TypeFromString, {"point", "spot", "directional"});
+    encodeValueWithMap<KHRLightSpot>(
+        j, "spot", light.spot,
+        [this](const KHRLightSpot &value) { return encodeKHRLightSpot(value); });
+    return j;
+  }
+
+#pragma mark - VRM 1
+
+  nlohmann::json encodeVRM1Meta(const vrmc::Meta &meta) {
+    nlohmann::json j;
+    encodeValue(j, "name", meta.name);
+    encodeValue(j, "version", meta.version);
+    encodeValue(j, "authors", meta.authors);
+    encodeValue(j, "copyrightInformation", meta.copyrightInformation);
+    encodeValue(j, "contactInformation", meta.contactInformation);
+    encodeValue(j, "references", meta.references);
+    encodeValue(j, "thirdPartyLicenses", meta.thirdPartyLicenses);
+    encodeValue(j, "thumbnailImage", meta.thumbnailImage);
+    encodeValue(j, "licenseUrl", meta.licenseUrl);
+    encodeValueWithMap<vrmc::Meta::AvatarPermission>(
+        j, "avatarPermission", meta.avatarPermission,
+        [this](const vrmc::Meta::AvatarPermission &value) {
+          return encodeEnumString<vrmc::Meta::AvatarPermission>(
+              value, vrmc::Meta::AvatarPermissionFromString,
+              {"onlyAuthor", "onlySeparatelyLicensedPerson", "everyone"});
+        });
+    encodeValue(j, "allowExcessivelyViolentUsage",
+                meta.allowExcessivelyViolentUsage);
+    encodeValue(j, "allowExcessivelySexualUsage",
+                meta.allowExcessivelySexualUsage);
+    encodeValueWithMap<vrmc::Meta::CommercialUsage>(
+        j, "commercialUsage", meta.commercialUsage,
+        [this](const vrmc::Meta::CommercialUsage &value) {
+          return encodeEnumString<vrmc::Meta::CommercialUsage>(
+              value, vrmc::Meta::CommercialUsageFromString,
+              {"personalNonProfit", "personalProfit", "corporation"});
+        });
+    encodeValue(j, "allowPoliticalOrReligiousUsage",
+                meta.allowPoliticalOrReligiousUsage);
+    encodeValue(j, "allowAntisocialOrHateUsage",
+                meta.allowAntisocialOrHateUsage);
+    encodeValueWithMap<vrmc::Meta::CreditNotation>(
+        j, "creditNotation", meta.creditNotation,
+        [this](const vrmc::Meta::CreditNotation &value) {
+          return encodeEnumString<vrmc::Meta::CreditNotation>(
+              value, vrmc::Meta::CreditNotationFromString,
+              {"required", "unnecessary"});
+        });
+    encodeValue(j, "allowRedistribution", meta.allowRedistribution);
+    encodeValueWithMap<vrmc::Meta::Modification>(
+        j, "modification", meta.modification,
+        [this](const vrmc::Meta::Modification &value) {
+          return encodeEnumString<vrmc::Meta::Modification>(
+              value, vrmc::Meta::ModificationFromString,
+              {"prohibited", "allowModification",
+               "allowModificationRedistribution"});
+        });
+    encodeValue(j, "otherLicenseUrl", meta.otherLicenseUrl);
+    return j;
+  }
+
+  nlohmann::json encodeVRM1Humanoid(const vrmc::Humanoid &humanoid) {
+    nlohmann::json bones = nlohmann::json::object();
+    humanoid.humanBones.forEachBone(
+        [&bones](const std::string &name, const vrmc::HumanoidHumanBone &bone) {
+          bones[name]["node"] = bone.node;
+        });
+    nlohmann::json j;
+    j["humanBones"] = bones;
+    return j;
+  }
+
+  nlohmann::json encodeVRM1FirstPersonMeshAnnotation(
+      const vrmc::FirstPersonMeshAnnotation &annotation) {
+    nlohmann::json j;
+    encodeValue(j, "node", annotation.node);
+    j["type"] = encodeEnumString<vrmc::FirstPersonMeshAnnotation::Type>(
+        annotation.type, vrmc::FirstPersonMeshAnnotation::TypeFromString,
+        {"auto", "both", "thirdPersonOnly", "firstPersonOnly"});
+    return j;
+  }
+
+  nlohmann::json encodeVRM1FirstPerson(const vrmc::FirstPerson &firstPerson) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeArrayWithMapElem<vrmc::FirstPersonMeshAnnotation>(
+        j, "meshAnnotations", firstPerson.meshAnnotations,
+        [this](const vrmc::FirstPersonMeshAnnotation &item) {
+          return encodeVRM1FirstPersonMeshAnnotation(item);
+        });
+    return j;
+  }
+
+  nlohmann::json encodeVRM1LookAtRangeMap(const vrmc::LookAtRangeMap &rangeMap) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "inputMaxValue", rangeMap.inputMaxValue);
+    encodeValue(j, "outputScale", rangeMap.outputScale);
+    return j;
+  }
+
+  nlohmann::json encodeVRM1LookAt(const vrmc::LookAt &lookAt) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "offsetFromHeadBone", lookAt.offsetFromHeadBone);
+    encodeValueWithMap<vrmc::LookAt::Type>(
+        j, "type", lookAt.type, [this](const vrmc::LookAt::Type &value) {
+          return encodeEnumString<vrmc::LookAt::Type>(
+              value, vrmc::LookAt::TypeFromString, {"bone", "expression"});
+        });
+    encodeValueWithMap<vrmc::LookAtRangeMap>(
+        j, "rangeMapHorizontalInner", lookAt.rangeMapHorizontalInner,
+        [this](const vrmc::LookAtRangeMap &value) {
+          return encodeVRM1LookAtRangeMap(value);
+        });
+    encodeValueWithMap<vrmc::LookAtRangeMap>(
+        j, "rangeMapHorizontalOuter", lookAt.rangeMapHorizontalOuter,
+        [this](const vrmc::LookAtRangeMap &value) {
+          return encodeVRM1LookAtRangeMap(value);
+        });
+    encodeValueWithMap<vrmc::LookAtRangeMap>(
+        j, "rangeMapVerticalDown", lookAt.rangeMapVerticalDown,
+        [this](const vrmc::LookAtRangeMap &value) {
+          return encodeVRM1LookAtRangeMap(value);
+        });
+    encodeValueWithMap<vrmc::LookAtRangeMap>(
+        j, "rangeMapVerticalUp", lookAt.rangeMapVerticalUp,
+        [this](const vrmc::LookAtRangeMap &value) {
+          return encodeVRM1LookAtRangeMap(value);
+        });
+    return j;
+  }
+
+  nlohmann::json encodeVRM1ExpressionMaterialColorBind(
+      const vrmc::ExpressionMaterialColorBind &bind) {
+    nlohmann::json j;
+    encodeValue(j, "material", bind.material);
+    j["type"] = encodeEnumString<vrmc::ExpressionMaterialColorBind::Type>(
+        bind.type, vrmc::ExpressionMaterialColorBind::TypeFromString,
+        {"color", "emissionColor", "shadeColor", "matcapColor", "rimColor",
+         "outlineColor"});
+    encodeValue(j, "targetValue", bind.targetValue);
+    return j;
+  }
+
+  nlohmann::json encodeVRM1ExpressionMorphTargetBind(
+      const vrmc::ExpressionMorphTargetBind &bind) {
+    nlohmann::json j;
+    encodeValue(j, "node", bind.node);
+    encodeValue(j, "index", bind.index);
+    encodeValue(j, "weight", bind.weight);
+    return j;
+  }
+
+  nlohmann::json encodeVRM1ExpressionTextureTransformBind(
+      const vrmc::ExpressionTextureTransformBind &bind) {
+    nlohmann::json j;
+    encodeValue(j, "material", bind.material);
+    encodeValue(j, "scale", bind.scale);
+    encodeValue(j, "offset", bind.offset);
+    return j;
+  }
+
+  nlohmann::json encodeVRM1Expression(const vrmc::Expression &expression) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeArrayWithMapElem<vrmc::ExpressionMorphTargetBind>(
+        j, "morphTargetBinds", expression.morphTargetBinds,
+        [this](const vrmc::ExpressionMorphTargetBind &item) {
+          return encodeVRM1ExpressionMorphTargetBind(item);
+        });
+    encodeArrayWithMapElem<vrmc::ExpressionMaterialColorBind>(
+        j, "materialColorBinds", expression.materialColorBinds,
+        [this](const vrmc::ExpressionMaterialColorBind &item) {
+          return encodeVRM1ExpressionMaterialColorBind(item);
+        });
+    encodeArrayWithMapElem<vrmc::ExpressionTextureTransformBind>(
+        j, "textureTransformBinds", expression.textureTransformBinds,
+        [this](const vrmc::ExpressionTextureTransformBind &item) {
+          return encodeVRM1ExpressionTextureTransformBind(item);
+        });
+    encodeValue(j, "isBinary", expression.isBinary);
+    std::function<nlohmann::json(const vrmc::Expression::Override &)>
+        encodeOverride = [this](const vrmc::Expression::Override &value) {
+          return encodeEnumString<vrmc::Expression::Override>(
+              value, vrmc::Expression::OverrideFromString,
+              {"none", "block", "blend"});
+        };
+    encodeValueWithMap(j, "overrideBlink", expression.overrideBlink,
+                       encodeOverride);
+    encodeValueWithMap(j, "overrideLookAt", expression.overrideLookAt,
+                       encodeOverride);
+    encodeValueWithMap(j, "overrideMouth", expression.overrideMouth,
+                       encodeOverride);
+    return j;
+  }
+
+  nlohmann::json encodeVRM1Expressions(const vrmc::Expressions &expressions) {
+    nlohmann::json j = nlohmann::json::object();
+    if (expressions.preset) {
+      nlohmann::json preset = nlohmann::json::object();
+      expressions.preset->forEachExpression(
+          [this, &preset](const std::string &name,
+                          const vrmc::Expression &expression) {
+            preset[name] = encodeVRM1Expression(expression);
+          });
+      j["preset"] = preset;
+    }
+    if (expressions.custom) {
+      nlohmann::json custom = nlohmann::json::object();
+      for (const auto &pair : *expressions.custom) {
+        custom[pair.first] = encodeVRM1Expression(pair.second);
+      }
+      j["custom"] = custom;
+    }
+    return j;
+  }
+
+  nlohmann::json encodeVRM1VRM(const vrmc::VRM &vrm) {
+    nlohmann::json j;
+    encodeValue(j, "specVersion", vrm.specVersion);
+    j["meta"] = encodeVRM1Meta(vrm.meta);
+    j["humanoid"] = encodeVRM1Humanoid(vrm.humanoid);
+    encodeValueWithMap<vrmc::FirstPerson>(
+        j, "firstPerson", vrm.firstPerson,
+        [this](const vrmc::FirstPerson &value) {
+          return encodeVRM1FirstPerson(value);
+        });
+    encodeValueWithMap<vrmc::LookAt>(
+        j, "lookAt", vrm.lookAt,
+        [this](const vrmc::LookAt &value) { return encodeVRM1LookAt(value); });
+    encodeValueWithMap<vrmc::Expressions>(
+        j, "expressions", vrm.expressions,
+        [this](const vrmc::Expressions &value) {
+          return encodeVRM1Expressions(value);
+        });
+    return j;
+  }
+
+#pragma mark - VRM 0
+
+  nlohmann::json encodeVRM0VRM(const vrm0::VRM &vrm) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "exporterVersion", vrm.exporterVersion);
+    encodeValue(j, "specVersion", vrm.specVersion);
+    encodeValueWithMap<vrm0::Meta>(
+        j, "meta", vrm.meta,
+        [this](const vrm0::Meta &value) { return encodeVRM0Meta(value); });
+    encodeValueWithMap<vrm0::Humanoid>(
+        j, "humanoid", vrm.humanoid,
+        [this](const vrm0::Humanoid &value) {
+          return encodeVRM0Humanoid(value);
+        });
+    encodeValueWithMap<vrm0::FirstPerson>(
+        j, "firstPerson", vrm.firstPerson,
+        [this](const vrm0::FirstPerson &value) {
+          return encodeVRM0FirstPerson(value);
+        });
+    encodeValueWithMap<vrm0::BlendShape>(
+        j, "blendShapeMaster", vrm.blendShapeMaster,
+        [this](const vrm0::BlendShape &value) {
+          return encodeVRM0BlendShape(value);
+        });
+    encodeValueWithMap<vrm0::SecondaryAnimation>(
+        j, "secondaryAnimation", vrm.secondaryAnimation,
+        [this](const vrm0::SecondaryAnimation &value) {
+          return encodeVRM0SecondaryAnimation(value);
+        });
+    encodeArrayWithMapElem<vrm0::Material>(
+        j, "materialProperties", vrm.materialProperties,
+        [this](const vrm0::Material &item) { return encodeVRM0Material(item); });
+    return j;
+  }
+
+  nlohmann::json encodeVRM0Meta(const vrm0::Meta &meta) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "title", meta.title);
+    encodeValue(j, "version", meta.version);
+    encodeValue(j, "author", meta.author);
+    encodeValue(j, "contactInformation", meta.contactInformation);
+    encodeValue(j, "reference", meta.reference);
+    encodeValue(j, "texture", meta.texture);
+    encodeValueWithMap<vrm0::Meta::AllowedUserName>(
+        j, "allowedUserName", meta.allowedUserName,
+        [this](const vrm0::Meta::AllowedUserName &value) {
+          return encodeEnumString<vrm0::Meta::AllowedUserName>(
+              value, vrm0::Meta::AllowedUserNameFromString,
+              {"OnlyAuthor", "ExplicitlyLicensedPerson", "Everyone"});
+        });
+    std::function<nlohmann::json(const vrm0::Meta::UsagePermission &)>
+        encodeUsagePermission =
+            [this](const vrm0::Meta::UsagePermission &value) {
+              return encodeEnumString<vrm0::Meta::UsagePermission>(
+                  value, vrm0::Meta::UsagePermissionFromString,
+                  {"Disallow", "Allow"});
+            };
+    encodeValueWithMap(j, "violentUssageName", meta.violentUsage,
+                       encodeUsagePermission);
+    encodeValueWithMap(j, "sexualUssageName", meta.sexualUsage,
+                       encodeUsagePermission);
+    encodeValueWithMap(j, "commercialUssageName", meta.commercialUsage,
+                       encodeUsagePermission);
+    encodeValue(j, "otherPermissionUrl", meta.otherPermissionUrl);
+    encodeValueWithMap<vrm0::Meta::LicenseName>(
+        j, "licenseName", meta.licenseName,
+        [this](const vrm0::Meta::LicenseName &value) {
+          return encodeEnumString<vrm0::Meta::LicenseName>(
+              value, vrm0::Meta::LicenseNameFromString,
+              {"Redistribution_Prohibited", "CC0", "CC_BY", "CC_BY_NC",
+               "CC_BY_SA", "CC_BY_NC_SA", "CC_BY_ND", "CC_BY_NC_ND", "Other"});
+        });
+    encodeValue(j, "otherLicenseUrl", meta.otherLicenseUrl);
+    return j;
+  }
+
+  nlohmann::json encodeVRM0Humanoid(const vrm0::Humanoid &humanoid) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeArrayWithMapElem<vrm0::HumanoidBone>(
+        j, "humanBones", humanoid.humanBones,
+        [this](const vrm0::HumanoidBone &item) {
+          return encodeVRM0HumanoidBone(item);
+        });
+    encodeValue(j, "armStretch", humanoid.armStretch);
+    encodeValue(j, "legStretch", humanoid.legStretch);
+    encodeValue(j, "upperArmTwist", humanoid.upperArmTwist);
+    encodeValue(j, "lowerArmTwist", humanoid.lowerArmTwist);
+    encodeValue(j, "upperLegTwist", humanoid.upperLegTwist);
+    encodeValue(j, "lowerLegTwist", humanoid.lowerLegTwist);
+    encodeValue(j, "feetSpacing", humanoid.feetSpacing);
+    encodeValue(j, "hasTranslationDoF", humanoid.hasTranslationDoF);
+    return j;
+  }
+
+  nlohmann::json encodeVRM0HumanoidBone(const vrm0::HumanoidBone &bone) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValueWithMap<vrm0::HumanoidBone::BoneName>(
+        j, "bone", bone.bone,
+        [this](const vrm0::HumanoidBone::BoneName &value) {
+          return encodeEnumString<vrm0::HumanoidBone::BoneName>(
+              value, vrm0::HumanoidBone::BoneNameFromString,
+              {"hips",
+               "leftUpperLeg",
+               "rightUpperLeg",
+               "leftLowerLeg",
+               "rightLowerLeg",
+               "leftFoot",
+               "rightFoot",
+               "spine",
+               "chest",
+               "neck",
+               "head",
+               "leftShoulder",
+               "rightShoulder",
+               "leftUpperArm",
+               "rightUpperArm",
+               "leftLowerArm",
+               "rightLowerArm",
+               "leftHand",
+               "rightHand",
+               "leftToes",
+               "rightToes",
+               "leftEye",
+               "rightEye",
+               "jaw",
+               "leftThumbProximal",
+               "leftThumbIntermediate",
+               "leftThumbDistal",
+               "leftIndexProximal",
+               "leftIndexIntermediate",
+               "leftIndexDistal",
+               "leftMiddleProximal",
+               "leftMiddleIntermediate",
+               "leftMiddleDistal",
+               "leftRingProximal",
+               "leftRingIntermediate",
+               "leftRingDistal",
+               "leftLittleProximal",
+               "leftLittleIntermediate",
+               "leftLittleDistal",
+               "rightThumbProximal",
+               "rightThumbIntermediate",
+               "rightThumbDistal",
+               "rightIndexProximal",
+               "rightIndexIntermediate",
+               "rightIndexDistal",
+               "rightMiddleProximal",
+               "rightMiddleIntermediate",
+               "rightMiddleDistal",
+               "rightRingProximal",
+               "rightRingIntermediate",
+               "rightRingDistal",
+               "rightLittleProximal",
+               "rightLittleIntermediate",
+               "rightLittleDistal",
+               "upperChest"});
+        });
+    encodeValue(j, "node", bone.node);
+    encodeValue(j, "useDefaultValues", bone.useDefaultValues);
+    std::function<nlohmann::json(const vrm0::Vec3 &)> encodeVec3 =
+        [this](const vrm0::Vec3 &value) { return encodeVRM0Vec3(value); };
+    encodeValueWithMap(j, "min", bone.min, encodeVec3);
+    encodeValueWithMap(j, "max", bone.max, encodeVec3);
+    encodeValueWithMap(j, "center", bone.center, encodeVec3);
+    encodeValue(j, "axisLength", bone.axisLength);
+    return j;
+  }
+
+  nlohmann::json encodeVRM0Vec3(const vrm0::Vec3 &vec) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "x", vec.x);
+    encodeValue(j, "y", vec.y);
+    encodeValue(j, "z", vec.z);
+    return j;
+  }
+
+  nlohmann::json encodeVRM0FirstPersonMeshAnnotation(
+      const vrm0::FirstPersonMeshAnnotation &annotation) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "mesh", annotation.mesh);
+    encodeValue(j, "firstPersonFlag", annotation.firstPersonFlag);
+    return j;
+  }
+
+  nlohmann::json
+  encodeVRM0FirstPersonDegreeMap(const vrm0::FirstPersonDegreeMap &degreeMap) {
+    nlohmann::json j = nlohmann::json::object();
+    if (degreeMap.curve) {
+      auto curve = nlohmann::json::array();
+      for (const auto &mapping : *degreeMap.curve) {
+        curve.push_back(mapping.time);
+        curve.push_back(mapping.value);
+        curve.push_back(mapping.inTangent);
+        curve.push_back(mapping.outTangent);
+      }
+      j["curve"] = curve;
+    }
+    encodeValue(j, "xRange", degreeMap.xRange);
+    encodeValue(j, "yRange", degreeMap.yRange);
+    return j;
+  }
+
+  nlohmann::json encodeVRM0FirstPerson(const vrm0::FirstPerson &firstPerson) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "firstPersonBone", firstPerson.firstPersonBone);
+    encodeValueWithMap<vrm0::Vec3>(
+        j, "firstPersonBoneOffset", firstPerson.firstPersonBoneOffset,
+        [this](const vrm0::Vec3 &value) { return encodeVRM0Vec3(value); });
+    encodeArrayWithMapElem<vrm0::FirstPersonMeshAnnotation>(
+        j, "meshAnnotations", firstPerson.meshAnnotations,
+        [this](const vrm0::FirstPersonMeshAnnotation &item) {
+          return encodeVRM0FirstPersonMeshAnnotation(item);
+        });
+    encodeValueWithMap<vrm0::FirstPerson::LookAtType>(
+        j, "lookAtTypeName", firstPerson.lookAtTypeName,
+        [this](const vrm0::FirstPerson::LookAtType &value) {
+          return encodeEnumString<vrm0::FirstPerson::LookAtType>(
+              value, vrm0::FirstPerson::LookAtTypeFromString,
+              {"Bone", "BlendShape"});
+        });
+    std::function<nlohmann::json(const vrm0::FirstPersonDegreeMap &)>
+        encodeDegreeMap = [this](const vrm0::FirstPersonDegreeMap &value) {
+          return encodeVRM0FirstPersonDegreeMap(value);
+        };
+    encodeValueWithMap(j, "lookAtHorizontalInner",
+                       firstPerson.lookAtHorizontalInner, encodeDegreeMap);
+    encodeValueWithMap(j, "lookAtHorizontalOuter",
+                       firstPerson.lookAtHorizontalOuter, encodeDegreeMap);
+    encodeValueWithMap(j, "lookAtVerticalDown", firstPerson.lookAtVerticalDown,
+                       encodeDegreeMap);
+    encodeValueWithMap(j, "lookAtVerticalUp", firstPerson.lookAtVerticalUp,
+                       encodeDegreeMap);
+    return j;
+  }
+
+  nlohmann::json encodeVRM0BlendShapeMaterialBind(
+      const vrm0::BlendShapeMaterialBind &materialBind) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "materialName", materialBind.materialName);
+    encodeValue(j, "propertyName", materialBind.propertyName);
+    encodeValue(j, "targetValue", materialBind.targetValue);
+    return j;
+  }
+
+  nlohmann::json encodeVRM0BlendShape(const vrm0::BlendShape &blendShape) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeArrayWithMapElem<vrm0::BlendShapeGroup>(
+        j, "blendShapeGroups", blendShape.blendShapeGroups,
+        [this](const vrm0::BlendShapeGroup &item) {
+          return encodeVRM0BlendShapeGroup(item);
+        });
+    return j;
+  }
+
+  nlohmann::json encodeVRM0BlendShapeBind(const vrm0::BlendShapeBind &bind) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "mesh", bind.mesh);
+    encodeValue(j, "index", bind.index);
+    encodeValue(j, "weight", bind.weight);
+    return j;
+  }
+
+  nlohmann::json
+  encodeVRM0BlendShapeGroup(const vrm0::BlendShapeGroup &blendShapeGroup) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "name", blendShapeGroup.name);
+    encodeValueWithMap<vrm0::BlendShapeGroup::PresetName>(
+        j, "presetName", blendShapeGroup.presetName,
+        [](const vrm0::BlendShapeGroup::PresetName &value) {
+          return vrm0::BlendShapeGroup::PresetNameToString(value);
+        });
+    encodeArrayWithMapElem<vrm0::BlendShapeBind>(
+        j, "binds", blendShapeGroup.binds,
+        [this](const vrm0::BlendShapeBind &item) {
+          return encodeVRM0BlendShapeBind(item);
+        });
+    encodeArrayWithMapElem<vrm0::BlendShapeMaterialBind>(
+        j, "materialValues", blendShapeGroup.materialValues,
+        [this](const vrm0::BlendShapeMaterialBind &item) {
+          return encodeVRM0BlendShapeMaterialBind(item);
+        });
+    encodeValue(j, "isBinary", blendShapeGroup.isBinary);
+    return j;
+  }
+
+  nlohmann::json encodeVRM0SecondaryAnimationCollider(
+      const vrm0::SecondaryAnimationCollider &collider) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValueWithMap<vrm0::Vec3>(
+        j, "offset", collider.offset,
+        [this](const vrm0::Vec3 &value) { return encodeVRM0Vec3(value); });
+    encodeValue(j, "radius", collider.radius);
+    return j;
+  }
+
+  nlohmann::json encodeVRM0SecondaryAnimationColliderGroup(
+      const vrm0::SecondaryAnimationColliderGroup &colliderGroup) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "node", colliderGroup.node);
+    encodeArrayWithMapElem<vrm0::SecondaryAnimationCollider>(
+        j, "colliders", colliderGroup.colliders,
+        [this](const vrm0::SecondaryAnimationCollider &item) {
+          return encodeVRM0SecondaryAnimationCollider(item);
+        });
+    return j;
+  }
+
+  nlohmann::json encodeVRM0SecondaryAnimationSpring(
+      const vrm0::SecondaryAnimationSpring &spring) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "comment", spring.comment);
+    encodeValue(j, "stiffiness", spring.stiffiness);
+    encodeValue(j, "gravityPower", spring.gravityPower);
+    encodeValueWithMap<vrm0::Vec3>(
+        j, "gravityDir", spring.gravityDir,
+        [this](const vrm0::Vec3 &value) { return encodeVRM0Vec3(value); });
+    encodeValue(j, "dragForce", spring.dragForce);
+    encodeValue(j, "center", spring.center);
+    encodeValue(j, "hitRadius", spring.hitRadius);
+    encodeValue(j, "bones", spring.bones);
+    encodeValue(j, "colliderGroups", spring.colliderGroups);
+    return j;
+  }
+
+  nlohmann::json encodeVRM0SecondaryAnimation(
+      const vrm0::SecondaryAnimation &secondaryAnimation) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeArrayWithMapElem<vrm0::SecondaryAnimationSpring>(
+        j, "boneGroups", secondaryAnimation.boneGroups,
+        [this](const vrm0::SecondaryAnimationSpring &item) {
+          return encodeVRM0SecondaryAnimationSpring(item);
+        });
+    encodeArrayWithMapElem<vrm0::SecondaryAnimationColliderGroup>(
+        j, "colliderGroups", secondaryAnimation.colliderGroups,
+        [this](const vrm0::SecondaryAnimationColliderGroup &item) {
+          return encodeVRM0SecondaryAnimationColliderGroup(item);
+        });
+    return j;
+  }
+
+  nlohmann::json encodeVRM0Material(const vrm0::Material &material) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "name", material.name);
+    encodeValue(j, "shader", material.shader);
+    encodeValue(j, "renderQueue", material.renderQueue);
+    encodeValue(j, "floatProperties", material.floatProperties);
+    encodeValue(j, "vectorProperties", material.vectorProperties);
+    encodeValue(j, "textureProperties", material.textureProperties);
+    encodeValue(j, "keywordMap", material.keywordMap);
+    encodeValue(j, "tagMap", material.tagMap);
+    return j;
+  }
+
+#pragma mark - Spring Bone
+
+  nlohmann::json encodeVRM1SpringBoneColliderGroup(
+      const vrmc::SpringBoneColliderGroup &colliderGroup) {
+    nlohmann::json j;
+    encodeValue(j, "name", colliderGroup.name);
+    encodeValue(j, "colliders", colliderGroup.colliders);
+    return j;
+  }
+
+  nlohmann::json encodeVRM1SpringBoneJoint(const vrmc::SpringBoneJoint &joint) {
+    nlohmann::json j;
+    encodeValue(j, "node", joint.node);
+    encodeValue(j, "hitRadius", joint.hitRadius);
+    encodeValue(j, "stiffness", joint.stiffness);
+    encodeValue(j, "gravityPower", joint.gravityPower);
+    encodeValue(j, "gravityDir", joint.gravityDir);
+    encodeValue(j, "dragForce", joint.dragForce);
+    return j;
+  }
+
+  nlohmann::json
+  encodeVRM1SpringBoneShapeSphere(const vrmc::SpringBoneShapeSphere &sphere) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "offset", sphere.offset);
+    encodeValue(j, "radius", sphere.radius);
+    return j;
+  }
+
+  nlohmann::json
+  encodeVRM1SpringBoneShapeCapsule(const vrmc::SpringBoneShapeCapsule &capsule) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValue(j, "offset", capsule.offset);
+    encodeValue(j, "radius", capsule.radius);
+    encodeValue(j, "tail", capsule.tail);
+    return j;
+  }
+
+  nlohmann::json encodeVRM1SpringBoneShape(const vrmc::SpringBoneShape &shape) {
+    nlohmann::json j = nlohmann::json::object();
+    encodeValueWithMap<vrmc::SpringBoneShapeSphere>(
+        j, "sphere", shape.sphere,
+        [this](const vrmc::SpringBoneShapeSphere &value) {
+          return encodeVRM1SpringBoneShapeSphere(value);
+        });
+    encodeValueWithMap<vrmc::SpringBoneShapeCapsule>(
+        j, "capsule", shape.capsule,
+        [this](const vrmc::SpringBoneShapeCapsule &value) {
+          return encodeVRM1SpringBoneShapeCapsule(value);
+        });
+    return j;
+  }
+
+  nlohmann::json
+  encodeVRM1SpringBoneCollider(const vrmc::SpringBoneCollider &collider) {
+    nlohmann::json j;
+    encodeValue(j, "node", collider.node);
+    j["shape"] = encodeVRM1SpringBoneShape(collider.shape);
+    return j;
+  }
+
+  nlohmann::json
+  encodeVRM1SpringBoneSpring(const vrmc::SpringBoneSpring &spring) {
+    nlohmann::json j;
+    encodeValue(j, "name", spring.name);
+    encodeArrayWithMapElem<vrmc::SpringBoneJoint>(
+        j, "joints", spring.joints, [this](const vrmc::SpringBoneJoint &item) {
+          return encodeVRM1SpringBoneJoint(item);
+        });
+    encodeValue(j, "colliderGroups", spring.colliderGroups);
+    encodeValue(j, "center", spring.center);
+    return j;
+  }
+
+  nlohmann::json encodeVRM1SpringBone(const vrmc::SpringBone &springBone) {
+    nlohmann::json j;
+    encodeValue(j, "specVersion", springBone.specVersion);
+    encodeArrayWithMapElem<vrmc::SpringBoneCollider>(
+        j, "colliders", springBone.colliders,
+        [this](const vrmc::SpringBoneCollider &item) {
+          return encodeVRM1SpringBoneCollider(item);
+        });
+    encodeArrayWithMapElem<vrmc::SpringBoneColliderGroup>(
+        j, "colliderGroups", springBone.colliderGroups,
+        [this](const vrmc::SpringBoneColliderGroup &item) {
+          return encodeVRM1SpringBoneColliderGroup(item);
+        });
+    encodeArrayWithMapElem<vrmc::SpringBoneSpring>(
+        j, "springs", springBone.springs,
+        [this](const vrmc::SpringBoneSpring &item) {
+          return encodeVRM1SpringBoneSpring(item);
+        });
+    return j;
+  }
+};
+
+} // namespace json
+} // namespace gltf2
+
+#endif /* JsonEncoder_h */
@@ -0,0 +1,375 @@
+#ifndef JsonReferences_h
+#define JsonReferences_h
+
+#include "Json.h"
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace gltf2 {
+namespace json {
+
+/**
+ * @brief The kinds of top-level objects that can be referenced by index.
+ */
+enum class ReferenceKind {
+  Accessor,
+  Buffer,
+  BufferView,
+  Camera,
+  Image,
+  Material,
+  Mesh,
+  Node,
+  Sampler,
+  Skin,
+  Texture,
+};
+
+/*
+ * The functions below call `fn(ReferenceKind, index)` for every index an
+ * object refers to. The index is passed by reference, so passing a mutable
+ * object allows the callback to rewrite it; passing a const object visits
+ * the indices read-only.
+ */
+
+namespace references {
+
+template <typename T> struct IsOptional : std::false_type {};
+template <typename T> struct IsOptional<std::optional<T>> : std::true_type {};
+
+template <typename T> struct IsVector : std::false_type {};
+template <typename T> struct IsVector<std::vector<T>> : std::true_type {};
+
+template <typename F, typename T>
+void visit(F &fn, ReferenceKind kind, T &value) {
+  using U = std::remove_const_t<T>;
+  if constexpr (IsOptional<U>::value) {
+    if (value)
+      visit(fn, kind, *value);
+  } else if constexpr (IsVector<U>::value) {
+    for (auto &index : value)
+      fn(kind, index);
+  } else {
+    fn(kind, value);
+  }
+}
+
+} // namespace references
+
+template <typename T, typename F>
+void forEachAccessorReference(T &accessor, F &&fn) {
+  references::visit(fn, ReferenceKind::BufferView, accessor.bufferView);
+  if (accessor.sparse) {
+    references::visit(fn, ReferenceKind::BufferView,
+                      accessor.sparse->indices.bufferView);
+    references::visit(fn, ReferenceKind::BufferView,
+                      accessor.sparse->values.bufferView);
+  }
+}
+
+template <typename T, typename F>
+void forEachAnimationReference(T &animation, F &&fn) {
+  for (auto &channel : animation.channels) {
+    references::visit(fn, ReferenceKind::Node, channel.target.node);
+  }
+  for (auto &sampler : animation.samplers) {
+    references::visit(fn, ReferenceKind::Accessor, sampler.input);
+    references::visit(fn, ReferenceKind::Accessor, sampler.output);
+  }
+}
+
+template <typename T, typename F>
+void forEachBufferViewReference(T &bufferView, F &&fn) {
+  references::visit(fn, ReferenceKind::Buffer, bufferView.buffer);
+  if (bufferView.meshoptExtension) {
+    references::visit(fn, ReferenceKind::Buffer,
+                      bufferView.meshoptExtension->buffer);
+  }
+}
+
+template <typename T, typename F> void forEachImageReference(T &image, F &&fn) {
+  references::visit(fn, ReferenceKind::BufferView, image.bufferView);
+}
+
+template <typename T, typename F>
+void forEachTextureReference(T &texture, F &&fn) {
+  references::visit(fn, ReferenceKind::Sampler, texture.sampler);
+  references::visit(fn, ReferenceKind::Image, texture.source);
+}
+
+template <typename T, typename F>
+void forEachTextureInfoReference(T &textureInfo, F &&fn) {
+  using U = std::remove_const_t<T>;
+  if constexpr (references::IsOptional<U>::value) {
+    if (textureInfo)
+      forEachTextureInfoReference(*textureInfo, fn);
+  } else {
+    references::visit(fn, ReferenceKind::Texture, textureInfo.index);
+  }
+}
+
+template <typename T, typename F>
+void forEachMaterialReference(T &material, F &&fn) {
+  if (material.pbrMetallicRoughness) {
+    auto &pbr = *material.pbrMetallicRoughness;
+    forEachTextureInfoReference(pbr.baseColorTexture, fn);
+    forEachTextureInfoReference(pbr.metallicRoughnessTexture, fn);
+  }
+  forEachTextureInfoReference(material.normalTexture, fn);
+  forEachTextureInfoReference(material.occlusionTexture, fn);
+  forEachTextureInfoReference(material.emissiveTexture, fn);
+  if (material.anisotropy) {
+    forEachTextureInfoReference(material.anisotropy->anisotropyTexture, fn);
+  }
+  if (material.clearcoat) {
+    auto &clearcoat = *material.clearcoat;
+    forEachTextureInfoReference(clearcoat.clearcoatTexture, fn);
+    forEachTextureInfoReference(clearcoat.clearcoatRoughnessTexture, fn);
+    forEachTextureInfoReference(clearcoat.clearcoatNormalTexture, fn);
+  }
+  if (material.iridescence) {
+    auto &iridescence = *material.iridescence;
+    forEachTextureInfoReference(iridescence.iridescenceTexture, fn);
+    forEachTextureInfoReference(iridescence.iridescenceThicknessTexture, fn);
+  }
+  if (material.sheen) {
+    forEachTextureInfoReference(material.sheen->sheenColorTexture, fn);
+    forEachTextureInfoReference(material.sheen->sheenRoughnessTexture, fn);
+  }
+  if (material.specular) {
+    forEachTextureInfoReference(material.specular->specularTexture, fn);
+    forEachTextureInfoReference(material.specular->specularColorTexture, fn);
+  }
+  if (material.transmission) {
+    forEachTextureInfoReference(material.transmission->transmissionTexture,
+                                fn);
+  }
+  if (material.volume) {
+    forEachTextureInfoReference(material.volume->thicknessTexture, fn);
+  }
+  if (material.mtoon) {
+    auto &mtoon = *material.mtoon;
+    forEachTextureInfoReference(mtoon.shadeMultiplyTexture, fn);
+    forEachTextureInfoReference(mtoon.shadingShiftTexture, fn);
+    forEachTextureInfoReference(mtoon.matcapTexture, fn);
+    forEachTextureInfoReference(mtoon.rimMultiplyTexture, fn);
+    forEachTextureInfoReference(mtoon.outlineWidthMultiplyTexture, fn);
+    forEachTextureInfoReference(mtoon.uvAnimationMaskTexture, fn);
+  }
+}
+
+template <typename T, typename F>
+void forEachMeshPrimitiveTargetReference(T &target, F &&fn) {
+  references::visit(fn, ReferenceKind::Accessor, target.position);
+  references::visit(fn, ReferenceKind::Accessor, target.normal);
+  references::visit(fn, ReferenceKind::Accessor, target.tangent);
+}
+
+template <typename T, typename F> void forEachMeshReference(T &mesh, F &&fn) {
+  for (auto &primitive : mesh.primitives) {
+    auto &attributes = primitive.attributes;
+    forEachMeshPrimitiveTargetReference(attributes, fn);
+    references::visit(fn, ReferenceKind::Accessor, attributes.texcoords);
+    references::visit(fn, ReferenceKind::Accessor, attributes.colors);
+    references::visit(fn, ReferenceKind::Accessor, attributes.joints);
+    references::visit(fn, ReferenceKind::Accessor, attributes.weights);
+    references::visit(fn, ReferenceKind::Accessor, primitive.indices);
+    references::visit(fn, ReferenceKind::Material, primitive.material);
+    if (primitive.targets) {
+      for (auto &target : *primitive.targets) {
+        forEachMeshPrimitiveTargetReference(target, fn);
+      }
+    }
+    // the attributes of the draco extension are draco attribute ids
+    if (primitive.dracoExtension) {
+      references::visit(fn, ReferenceKind::BufferView,
+                        primitive.dracoExtension->bufferView);
+    }
+  }
+}
+
+template <typename T, typename F> void forEachNodeReference(T &node, F &&fn) {
+  references::visit(fn, ReferenceKind::Camera, node.camera);
+  references::visit(fn, ReferenceKind::Node, node.children);
+  references::visit(fn, ReferenceKind::Skin, node.skin);
+  references::visit(fn, ReferenceKind::Mesh, node.mesh);
+}
+
+template <typename T, typename F> void forEachSceneReference(T &scene, F &&fn) {
+  references::visit(fn, ReferenceKind::Node, scene.nodes);
+}
+
+template <typename T, typename F> void forEachSkinReference(T &skin, F &&fn) {
+  references::visit(fn, ReferenceKind::Accessor, skin.inverseBindMatrices);
+  references::visit(fn, ReferenceKind::Node, skin.skeleton);
+  references::visit(fn, ReferenceKind::Node, skin.joints);
+}
+
+template <typename T, typename F> void forEachVRM0Reference(T &vrm, F &&fn) {
+  if (vrm.meta) {
+    references::visit(fn, ReferenceKind::Texture, vrm.meta->texture);
+  }
+  if (vrm.humanoid && vrm.humanoid->humanBones) {
+    for (auto &bone : *vrm.humanoid->humanBones) {
+      references::visit(fn, ReferenceKind::Node, bone.node);
+    }
+  }
+  if (vrm.firstPerson) {
+    auto &firstPerson = *vrm.firstPerson;
+    references::visit(fn, ReferenceKind::Node, firstPerson.firstPersonBone);
+    if (firstPerson.meshAnnotations) {
+      for (auto &annotation : *firstPerson.meshAnnotations) {
+        references::visit(fn, ReferenceKind::Mesh, annotation.mesh);
+      }
+    }
+  }
+  if (vrm.blendShapeMaster && vrm.blendShapeMaster->blendShapeGroups) {
+    for (auto &group : *vrm.blendShapeMaster->blendShapeGroups) {
+      if (!group.binds)
+        continue;
+      for (auto &bind : *group.binds) {
+        references::visit(fn, ReferenceKind::Mesh, bind.mesh);
+      }
+    }
+  }
+  if (vrm.secondaryAnimation) {
+    auto &secondaryAnimation = *vrm.secondaryAnimation;
+    if (secondaryAnimation.boneGroups) {
+      for (auto &spring : *secondaryAnimation.boneGroups) {
+        references::visit(fn, ReferenceKind::Node, spring.bones);
+        // VRM 0.x uses -1 for a spring without center
+        if (spring.center && *spring.center >= 0) {
+          uint32_t center = *spring.center;
+          fn(ReferenceKind::Node, center);
+          if constexpr (!std::is_const_v<T>)
+            spring.center = center;
+        }
+      }
+    }
+    if (secondaryAnimation.colliderGroups) {
+      for (auto &colliderGroup : *secondaryAnimation.colliderGroups) {
+        references::visit(fn, ReferenceKind::Node, colliderGroup.node);
+      }
+    }
+  }
+  if (vrm.materialProperties) {
+    for (auto &material : *vrm.materialProperties) {
+      if (!material.textureProperties)
+        continue;
+      // the MToon textures such as _ShadeTexture are only referenced here
+      for (auto &property : *material.textureProperties)
+        fn(ReferenceKind::Texture, property.second);
+    }
+  }
+}
+
+template <typename T, typename F>
+void forEachVRM1ExpressionReference(T &expression, F &&fn) {
+  if (expression.morphTargetBinds) {
+    for (auto &bind : *expression.morphTargetBinds) {
+      references::visit(fn, ReferenceKind::Node, bind.node);
+    }
+  }
+  if (expression.materialColorBinds) {
+    for (auto &bind : *expression.materialColorBinds) {
+      references::visit(fn, ReferenceKind::Material, bind.material);
+    }
+  }
+  if (expression.textureTransformBinds) {
+    for (auto &bind : *expression.textureTransformBinds) {
+      references::visit(fn, ReferenceKind::Material, bind.material);
+    }
+  }
+}
+
+template <typename T, typename F> void forEachVRM1Reference(T &vrm, F &&fn) {
+  references::visit(fn, ReferenceKind::Image, vrm.meta.thumbnailImage);
+  vrm.humanoid.humanBones.forEachBone(
+      [&fn](const std::string &, auto &bone) {
+        references::visit(fn, ReferenceKind::Node, bone.node);
+      });
+  if (vrm.firstPerson && vrm.firstPerson->meshAnnotations) {
+    for (auto &annotation : *vrm.firstPerson->meshAnnotations) {
+      references::visit(fn, ReferenceKind::Node, annotation.node);
+    }
+  }
+  if (vrm.expressions) {
+    auto &expressions = *vrm.expressions;
+    if (expressions.preset) {
+      expressions.preset->forEachExpression(
+          [&fn](const std::string &, auto &expression) {
+            forEachVRM1ExpressionReference(expression, fn);
+          });
+    }
+    if (expressions.custom) {
+      for (auto &pair : *expressions.custom) {
+        forEachVRM1ExpressionReference(pair.second, fn);
+      }
+    }
+  }
+}
+
+template <typename T, typename F>
+void forEachSpringBoneReference(T &springBone, F &&fn) {
+  if (springBone.colliders) {
+    for (auto &collider : *springBone.colliders) {
+      references::visit(fn, ReferenceKind::Node, collider.node);
+    }
+  }
+  if (springBone.springs) {
+    for (auto &spring : *springBone.springs) {
+      for (auto &joint : spring.joints) {
+        references::visit(fn, ReferenceKind::Node, joint.node);
+      }
+      references::visit(fn, ReferenceKind::Node, spring.center);
+    }
+  }
+}
+
+/**
+ * @brief Visits the references held by the VRM, VRMC_vrm and
+ * VRMC_springBone extensions of the document.
+ */
+template <typename T, typename F>
+void forEachExtensionReference(T &json, F &&fn) {
+  if (json.vrm0)
+    forEachVRM0Reference(*json.vrm0, fn);
+  if (json.vrm1)
+    forEachVRM1Reference(*json.vrm1, fn);
+  if (json.springBone)
+    forEachSpringBoneReference(*json.springBone, fn);
+}
+
+/**
+ * @brief Visits every index reference in the document.
+ */
+template <typename T, typename F> void forEachReference(T &json, F &&fn) {
+  auto each = [&fn](auto &array, auto &&visitor) {
+    if (array) {
+      for (auto &item : *array)
+        visitor(item, fn);
+    }
+  };
+  each(json.accessors,
+       [](auto &item, F &fn) { forEachAccessorReference(item, fn); });
+  each(json.animations,
+       [](auto &item, F &fn) { forEachAnimationReference(item, fn); });
+  each(json.bufferViews,
+       [](auto &item, F &fn) { forEachBufferViewReference(item, fn); });
+  each(json.images, [](auto &item, F &fn) { forEachImageReference(item, fn); });
+  each(json.materials,
+       [](auto &item, F &fn) { forEachMaterialReference(item, fn); });
+  each(json.meshes, [](auto &item, F &fn) { forEachMeshReference(item, fn); });
+  each(json.nodes, [](auto &item, F &fn) { forEachNodeReference(item, fn); });
+  each(json.scenes, [](auto &item, F &fn) { forEachSceneReference(item, fn); });
+  each(json.skins, [](auto &item, F &fn) { forEachSkinReference(item, fn); });
+  each(json.textures,
+       [](auto &item, F &fn) { forEachTextureReference(item, fn); });
+  forEachExtensionReference(json, fn);
+}
+
+} // namespace json
+} // namespace gltf2
+
+#endif /* JsonReferences_h */
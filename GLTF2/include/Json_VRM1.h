@@ -3,6 +3,7 @@
 
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace gltf2 {
@@ -192,6 +193,103 @@ public:
   std::optional<HumanoidHumanBone> rightLittleProximal;
   std::optional<HumanoidHumanBone> rightLittleIntermediate;
   std::optional<HumanoidHumanBone> rightLittleDistal;
+
+  /**
+   * @brief Calls `fn(name, bone)` for every present human bone, in the
+   * order the bones are declared. `name` is the key used in the JSON.
+   */
+  template <typename F> void forEachBone(F &&fn) {
+    for (const auto &entry : requiredBones())
+      fn(entry.first, this->*entry.second);
+    for (const auto &entry : optionalBones()) {
+      auto &bone = this->*entry.second;
+      if (bone)
+        fn(entry.first, *bone);
+    }
+  }
+
+  template <typename F> void forEachBone(F &&fn) const {
+    for (const auto &entry : requiredBones())
+      fn(entry.first, this->*entry.second);
+    for (const auto &entry : optionalBones()) {
+      const auto &bone = this->*entry.second;
+      if (bone)
+        fn(entry.first, *bone);
+    }
+  }
+
+private:
+  using RequiredBone = HumanoidHumanBone HumanoidHumanBones::*;
+  using OptionalBone = std::optional<HumanoidHumanBone> HumanoidHumanBones::*;
+
+  static const std::vector<std::pair<std::string, RequiredBone>> &
+  requiredBones() {
+    static const std::vector<std::pair<std::string, RequiredBone>> bones = {
+        {"hips", &HumanoidHumanBones::hips},
+        {"spine", &HumanoidHumanBones::spine},
+        {"head", &HumanoidHumanBones::head},
+        {"leftUpperLeg", &HumanoidHumanBones::leftUpperLeg},
+        {"leftLowerLeg", &HumanoidHumanBones::leftLowerLeg},
+        {"leftFoot", &HumanoidHumanBones::leftFoot},
+        {"rightUpperLeg", &HumanoidHumanBones::rightUpperLeg},
+        {"rightLowerLeg", &HumanoidHumanBones::rightLowerLeg},
+        {"rightFoot", &HumanoidHumanBones::rightFoot},
+        {"leftUpperArm", &HumanoidHumanBones::leftUpperArm},
+        {"leftLowerArm", &HumanoidHumanBones::leftLowerArm},
+        {"leftHand", &HumanoidHumanBones::leftHand},
+        {"rightUpperArm", &HumanoidHumanBones::rightUpperArm},
+        {"rightLowerArm", &HumanoidHumanBones::rightLowerArm},
+        {"rightHand", &HumanoidHumanBones::rightHand},
+    };
+    return bones;
+  }
+
+  static const std::vector<std::pair<std::string, OptionalBone>> &
+  optionalBones() {
+    static const std::vector<std::pair<std::string, OptionalBone>> bones = {
+        {"chest", &HumanoidHumanBones::chest},
+        {"upperChest", &HumanoidHumanBones::upperChest},
+        {"neck", &HumanoidHumanBones::neck},
+        {"leftEye", &HumanoidHumanBones::leftEye},
+        {"rightEye", &HumanoidHumanBones::rightEye},
+        {"jaw", &HumanoidHumanBones::jaw},
+        {"leftToes", &HumanoidHumanBones::leftToes},
+        {"rightToes", &HumanoidHumanBones::rightToes},
+        {"leftShoulder", &HumanoidHumanBones::leftShoulder},
+        {"rightShoulder", &HumanoidHumanBones::rightShoulder},
+        {"leftThumbMetacarpal", &HumanoidHumanBones::leftThumbMetacarpal},
+        {"leftThumbProximal", &HumanoidHumanBones::leftThumbProximal},
+        {"leftThumbDistal", &HumanoidHumanBones::leftThumbDistal},
+        {"leftIndexProximal", &HumanoidHumanBones::leftIndexProximal},
+        {"leftIndexIntermediate", &HumanoidHumanBones::leftIndexIntermediate},
+        {"leftIndexDistal", &HumanoidHumanBones::leftIndexDistal},
+        {"leftMiddleProximal", &HumanoidHumanBones::leftMiddleProximal},
+        {"leftMiddleIntermediate", &HumanoidHumanBones::leftMiddleIntermediate},
+        {"leftMiddleDistal", &HumanoidHumanBones::leftMiddleDistal},
+        {"leftRingProximal", &HumanoidHumanBones::leftRingProximal},
+        {"leftRingIntermediate", &HumanoidHumanBones::leftRingIntermediate},
+        {"leftRingDistal", &HumanoidHumanBones::leftRingDistal},
+        {"leftLittleProximal", &HumanoidHumanBones::leftLittleProximal},
+        {"leftLittleIntermediate", &HumanoidHumanBones::leftLittleIntermediate},
+        {"leftLittleDistal", &HumanoidHumanBones::leftLittleDistal},
+        {"rightThumbMetacarpal", &HumanoidHumanBones::rightThumbMetacarpal},
+        {"rightThumbProximal", &HumanoidHumanBones::rightThumbProximal},
+        {"rightThumbDistal", &HumanoidHumanBones::rightThumbDistal},
+        {"rightIndexProximal", &HumanoidHumanBones::rightIndexProximal},
+        {"rightIndexIntermediate", &HumanoidHumanBones::rightIndexIntermediate},
+        {"rightIndexDistal", &HumanoidHumanBones::rightIndexDistal},
+        {"rightMiddleProximal", &HumanoidHumanBones::rightMiddleProximal},
+        {"rightMiddleIntermediate", &HumanoidHumanBones::rightMiddleIntermediate},
+        {"rightMiddleDistal", &HumanoidHumanBones::rightMiddleDistal},
+        {"rightRingProximal", &HumanoidHumanBones::rightRingProximal},
+        {"rightRingIntermediate", &HumanoidHumanBones::rightRingIntermediate},
+        {"rightRingDistal", &HumanoidHumanBones::rightRingDistal},
+        {"rightLittleProximal", &HumanoidHumanBones::rightLittleProximal},
+        {"rightLittleIntermediate", &HumanoidHumanBones::rightLittleIntermediate},
+        {"rightLittleDistal", &HumanoidHumanBones::rightLittleDistal},
+    };
+    return bones;
+  }
 };
 
 class Humanoid {
@@ -431,6 +529,52 @@ public:
     }
     return names;
   }
+
+  /**
+   * @brief Calls `fn(name, expression)` for every present preset expression.
+   */
+  template <typename F> void forEachExpression(F &&fn) {
+    for (const auto &entry : presets()) {
+      auto &expression = this->*entry.second;
+      if (expression)
+        fn(entry.first, *expression);
+    }
+  }
+
+  template <typename F> void forEachExpression(F &&fn) const {
+    for (const auto &entry : presets()) {
+      const auto &expression = this->*entry.second;
+      if (expression)
+        fn(entry.first, *expression);
+    }
+  }
+
+private:
+  using Preset = std::optional<Expression> ExpressionsPreset::*;
+
+  static const std::vector<std::pair<std::string, Preset>> &presets() {
+    static const std::vector<std::pair<std::string, Preset>> presets = {
+        {"happy", &ExpressionsPreset::happy},
+        {"angry", &ExpressionsPreset::angry},
+        {"sad", &ExpressionsPreset::sad},
+        {"relaxed", &ExpressionsPreset::relaxed},
+        {"surprised", &ExpressionsPreset::surprised},
+        {"aa", &ExpressionsPreset::aa},
+        {"ih", &ExpressionsPreset::ih},
+        {"ou", &ExpressionsPreset::ou},
+        {"ee", &ExpressionsPreset::ee},
+        {"oh", &ExpressionsPreset::oh},
+        {"blink", &ExpressionsPreset::blink},
+        {"blinkLeft", &ExpressionsPreset::blinkLeft},
+        {"blinkRight", &ExpressionsPreset::blinkRight},
+        {"lookUp", &ExpressionsPreset::lookUp},
+        {"lookDown", &ExpressionsPreset::lookDown},
+        {"lookLeft", &ExpressionsPreset::lookLeft},
+        {"lookRight", &ExpressionsPreset::lookRight},
+        {"neutral", &ExpressionsPreset::neutral},
+    };
+    return presets;
+  }
 };
 
 class Expressions {
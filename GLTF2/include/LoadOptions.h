@@ -0,0 +1,109 @@
+#ifndef LoadOptions_h
+#define LoadOptions_h
+
+#include "Executor.h"
+#include "LoadTrace.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace gltf2 {
+
+/**
+ * @brief Vertex attributes of mesh primitives other than the position,
+ * combined as flags.
+ */
+enum class MeshAttributes : uint32_t {
+  None = 0,
+  Normal = 1 << 0,
+  Tangent = 1 << 1,
+  Texcoords = 1 << 2,
+  Colors = 1 << 3,
+  Joints = 1 << 4,
+  Weights = 1 << 5,
+  All = Normal | Tangent | Texcoords | Colors | Joints | Weights
+};
+
+constexpr MeshAttributes operator|(MeshAttributes lhs, MeshAttributes rhs) {
+  return static_cast<MeshAttributes>(static_cast<uint32_t>(lhs) |
+                                     static_cast<uint32_t>(rhs));
+}
+
+/**
+ * @brief Whether `attributes` has any of the flags of `flags`.
+ */
+constexpr bool contains(MeshAttributes attributes, MeshAttributes flags) {
+  return (static_cast<uint32_t>(attributes) & static_cast<uint32_t>(flags)) !=
+         0;
+}
+
+/**
+ * @brief The passes of `MeshOptimizer` over indexed triangle lists, run in
+ * this order.
+ */
+struct MeshOptimizeOptions {
+  /// Reorders the triangles for the post-transform vertex cache.
+  bool vertexCache = true;
+  /// Reorders clusters of triangles to draw the outer ones first, so that
+  /// fewer pixels are shaded twice.
+  bool overdraw = true;
+  /// How much worse the vertex cache may get for less overdraw: 1.05 allows
+  /// 5% more vertex transforms.
+  float overdrawThreshold = 1.05f;
+  /// Reorders the vertices in the order the indices first use them and
+  /// drops the unused ones.
+  bool vertexFetch = true;
+};
+
+/**
+ * @brief How `VertexWelder` compares vertices.
+ */
+struct VertexWeldOptions {
+  /// The size of the grid float position components are snapped to before
+  /// they are compared, or 0 to compare them exactly.
+  float positionEpsilon = 0.0f;
+  /// The size of the grid float normal components are snapped to before
+  /// they are compared, or 0 to compare them exactly.
+  float normalEpsilon = 0.0f;
+};
+
+/**
+ * @brief Options of `GLTFData`. The defaults load everything with no extra
+ * instrumentation.
+ */
+struct LoadOptions {
+  /// Runs every task of the load. It must outlive the load. Defaults to
+  /// `defaultExecutor()`.
+  Executor *executor = nullptr;
+  /// Receives every task of the load when set.
+  std::shared_ptr<LoadTracer> tracer;
+  /// The most bytes a load may allocate. A load that would exceed it throws
+  /// `MemoryBudgetException` before allocating, and before starting at all
+  /// when `estimateMemory` already exceeds it.
+  std::optional<uint64_t> memoryBudget;
+  /// Keeps sparse accessors as overlays on their bufferViews instead of
+  /// dense buffers: see `SparseAccessorBuffer`. Sparse accessors that are
+  /// normalized to floats are always dense.
+  bool keepSparseAccessors = false;
+  /// Keeps integer positions, normals, tangents and texcoords of meshes, as
+  /// allowed by KHR_mesh_quantization, in their components instead of
+  /// converting the normalized ones to floats. `MeshPrimitiveSource` then
+  /// carries the normalized flag; `toFloatBuffer` expands it.
+  bool keepQuantizedAttributes = false;
+  /// The attributes left out of the sources of mesh primitives and their
+  /// morph targets, e.g. `MeshAttributes::All` to load only positions and
+  /// indices. The skipped attributes of Draco primitives are neither
+  /// dequantized nor copied out of the decoded mesh.
+  MeshAttributes skippedAttributes = MeshAttributes::None;
+  /// Merges the duplicate vertices of each primitive as it is loaded, and
+  /// indexes the primitives that have no indices: see `VertexWelder`. It
+  /// runs before `meshOptimization`.
+  std::optional<VertexWeldOptions> vertexWeld;
+  /// Optimizes each indexed triangle list as it is loaded, on the thread
+  /// that loads it: see `MeshOptimizer`.
+  std::optional<MeshOptimizeOptions> meshOptimization;
+};
+
+} // namespace gltf2
+
+#endif /* LoadOptions_h */
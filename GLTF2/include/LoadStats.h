@@ -0,0 +1,195 @@
+#ifndef LoadStats_h
+#define LoadStats_h
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace gltf2 {
+
+/**
+ * @brief The time spent in one phase of a load.
+ */
+struct PhaseTime {
+  /// The time from the start to the end of the phase.
+  std::chrono::nanoseconds wall{0};
+  /// The CPU time of every task of the phase, summed over threads.
+  std::chrono::nanoseconds cpu{0};
+};
+
+/**
+ * @brief Statistics of parsing and loading a glTF document.
+ *
+ * Phases that run concurrently, like the accessor and image buffers in
+ * `GLTFData::eagerLoad`, overlap in wall time. Running a phase again adds to
+ * its statistics.
+ */
+struct LoadStats {
+  PhaseTime parse;
+  PhaseTime buffers;
+  PhaseTime bufferViews;
+  PhaseTime accessorBuffers;
+  PhaseTime imageBuffers;
+  PhaseTime meshPrimitives;
+  /// Decoding of Draco meshes, which runs right before `meshPrimitives`.
+  PhaseTime dracoDecode;
+
+  /// Bytes read from the glTF or GLB file and from external buffers and
+  /// images.
+  uint64_t bytesFromFiles = 0;
+  /// Bytes decoded from data URIs.
+  uint64_t bytesFromDataUris = 0;
+
+  /// Bytes allocated for loaded data, per category.
+  uint64_t bufferBytes = 0;
+  uint64_t accessorBytes = 0;
+  uint64_t imageBytes = 0;
+  uint64_t primitiveBytes = 0;
+  uint64_t morphTargetBytes = 0;
+
+  /// The number of asynchronous tasks run.
+  uint64_t tasks = 0;
+  uint64_t normalizedAccessors = 0;
+  uint64_t sparseAccessors = 0;
+  uint64_t dracoPrimitives = 0;
+  /// BufferViews decoded from EXT_meshopt_compression, as a part of
+  /// `bufferViews`.
+  uint64_t meshoptBufferViews = 0;
+};
+
+/**
+ * @brief The CPU time consumed by the calling thread so far.
+ */
+std::chrono::nanoseconds threadCpuTime();
+
+/**
+ * @brief Collects `LoadStats` from concurrent tasks.
+ *
+ * Every update is a single relaxed atomic addition, so recording can stay on
+ * in production.
+ */
+class LoadStatsRecorder {
+public:
+  enum class Phase {
+    Buffers,
+    BufferViews,
+    AccessorBuffers,
+    ImageBuffers,
+    MeshPrimitives,
+    DracoDecode
+  };
+
+  static constexpr size_t phaseCount =
+      static_cast<size_t>(Phase::DracoDecode) + 1;
+
+  enum class Bytes {
+    FromFiles,
+    FromDataUris,
+    Buffers,
+    Accessors,
+    Images,
+    Primitives,
+    MorphTargets
+  };
+
+  enum class Count {
+    Tasks,
+    NormalizedAccessors,
+    SparseAccessors,
+    DracoPrimitives,
+    MeshoptBufferViews
+  };
+
+  /**
+   * @brief Records the wall time of a phase when it goes out of scope.
+   */
+  class WallScope {
+  public:
+    WallScope(LoadStatsRecorder &recorder, Phase phase)
+        : _recorder(recorder), _phase(phase),
+          _start(std::chrono::steady_clock::now()) {}
+    ~WallScope() {
+      _recorder.addWall(_phase, std::chrono::steady_clock::now() - _start);
+    }
+
+  private:
+    LoadStatsRecorder &_recorder;
+    Phase _phase;
+    std::chrono::steady_clock::time_point _start;
+  };
+
+  /**
+   * @brief Counts a task and records the CPU time of the calling thread until
+   * it goes out of scope. Tasks of a phase that the thread runs while inside
+   * another task of that phase only count, since the outer task already
+   * includes their time.
+   */
+  class CpuScope {
+  public:
+    CpuScope(LoadStatsRecorder &recorder, Phase phase)
+        : _recorder(recorder), _phase(phase),
+          _outermost(depth(phase)++ == 0),
+          _start(_outermost ? threadCpuTime() : std::chrono::nanoseconds(0)) {
+      _recorder.increment(Count::Tasks);
+    }
+    ~CpuScope() {
+      depth(_phase)--;
+      if (_outermost)
+        _recorder.addCpu(_phase, threadCpuTime() - _start);
+    }
+
+  private:
+    LoadStatsRecorder &_recorder;
+    Phase _phase;
+    bool _outermost;
+    std::chrono::nanoseconds _start;
+
+    static int &depth(Phase phase) {
+      static thread_local std::array<int, phaseCount> depths{};
+      return depths[static_cast<size_t>(phase)];
+    }
+  };
+
+  void addWall(Phase phase, std::chrono::nanoseconds time) {
+    add(_wall[static_cast<size_t>(phase)], time.count());
+  }
+
+  void addCpu(Phase phase, std::chrono::nanoseconds time) {
+    add(_cpu[static_cast<size_t>(phase)], time.count());
+  }
+
+  void add(Bytes category, uint64_t bytes) {
+    add(_bytes[static_cast<size_t>(category)], bytes);
+  }
+
+  void increment(Count count, uint64_t n = 1) {
+    add(_counts[static_cast<size_t>(count)], n);
+  }
+
+  void reset();
+
+  /**
+   * @brief The statistics recorded so far. `parse` is left empty.
+   */
+  LoadStats stats() const;
+
+private:
+  static constexpr size_t bytesCount =
+      static_cast<size_t>(Bytes::MorphTargets) + 1;
+  static constexpr size_t countCount =
+      static_cast<size_t>(Count::MeshoptBufferViews) + 1;
+
+  std::array<std::atomic<uint64_t>, phaseCount> _wall{};
+  std::array<std::atomic<uint64_t>, phaseCount> _cpu{};
+  std::array<std::atomic<uint64_t>, bytesCount> _bytes{};
+  std::array<std::atomic<uint64_t>, countCount> _counts{};
+
+  static void add(std::atomic<uint64_t> &counter, uint64_t value) {
+    counter.fetch_add(value, std::memory_order_relaxed);
+  }
+};
+
+} // namespace gltf2
+
+#endif /* LoadStats_h */
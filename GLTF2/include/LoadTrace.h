@@ -0,0 +1,109 @@
+#ifndef LoadTrace_h
+#define LoadTrace_h
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace gltf2 {
+
+/**
+ * @brief One task of a load, from its begin to its end.
+ */
+struct TraceEvent {
+  /// The name of the task, like "loadAccessorBufferAt". It must have static
+  /// storage duration.
+  const char *name;
+  /// The index of the buffer, bufferView, accessor, image or mesh the task
+  /// loads. Draco decoding reports the compressed bufferView.
+  std::optional<uint32_t> index;
+  /// The index of the primitive in the mesh, for mesh primitive tasks.
+  std::optional<uint32_t> primitiveIndex;
+  /// The number of bytes the task produced.
+  uint64_t bytes = 0;
+  std::thread::id thread;
+  std::chrono::steady_clock::time_point begin;
+  std::chrono::steady_clock::time_point end;
+};
+
+/**
+ * @brief Receives the tasks of a load as they end. `record` is called
+ * concurrently from the threads running the tasks.
+ */
+class LoadTracer {
+public:
+  virtual ~LoadTracer() = default;
+
+  virtual void record(const TraceEvent &event) = 0;
+};
+
+/**
+ * @brief Collects tasks in memory and writes them in the Chrome trace event
+ * format, which chrome://tracing and ui.perfetto.dev open.
+ */
+class ChromeTraceRecorder : public LoadTracer {
+public:
+  ChromeTraceRecorder() : _origin(std::chrono::steady_clock::now()) {}
+
+  void record(const TraceEvent &event) override;
+
+  std::vector<TraceEvent> events() const;
+
+  /**
+   * @brief Write a JSON object with one complete ("X") event per task.
+   * Timestamps are microseconds since the recorder was created and threads
+   * are numbered in the order their first task ended.
+   */
+  void write(std::ostream &os) const;
+
+private:
+  std::chrono::steady_clock::time_point _origin;
+  mutable std::mutex _mutex;
+  std::vector<TraceEvent> _events;
+  std::unordered_map<std::thread::id, uint32_t> _threads;
+};
+
+/**
+ * @brief Records a task to a tracer when it goes out of scope. Does nothing
+ * when the tracer is null, so it can be left in place when tracing is off.
+ */
+class TraceScope {
+public:
+  TraceScope(LoadTracer *tracer, const char *name,
+             std::optional<uint32_t> index = std::nullopt,
+             std::optional<uint32_t> primitiveIndex = std::nullopt)
+      : _tracer(tracer) {
+    if (!_tracer)
+      return;
+    _event.name = name;
+    _event.index = index;
+    _event.primitiveIndex = primitiveIndex;
+    _event.thread = std::this_thread::get_id();
+    _event.begin = std::chrono::steady_clock::now();
+  }
+
+  ~TraceScope() {
+    if (!_tracer)
+      return;
+    _event.end = std::chrono::steady_clock::now();
+    _tracer->record(_event);
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+  void setBytes(uint64_t bytes) { _event.bytes = bytes; }
+
+private:
+  LoadTracer *_tracer;
+  TraceEvent _event{};
+};
+
+} // namespace gltf2
+
+#endif /* LoadTrace_h */
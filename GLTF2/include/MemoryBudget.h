@@ -0,0 +1,72 @@
+#ifndef MemoryBudget_h
+#define MemoryBudget_h
+
+#include "Json.h"
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+namespace gltf2 {
+
+/**
+ * @brief The bytes `GLTFData::eagerLoad` will allocate for a document,
+ * computed from its JSON alone.
+ *
+ * Images in external files and the decoded size of Draco meshes are not
+ * known before loading and are not included.
+ */
+struct MemoryEstimate {
+  uint64_t buffers = 0;
+  uint64_t accessors = 0;
+  uint64_t images = 0;
+  uint64_t primitives = 0;
+  uint64_t morphTargets = 0;
+
+  uint64_t total() const {
+    return buffers + accessors + images + primitives + morphTargets;
+  }
+};
+
+MemoryEstimate estimateMemory(const json::Json &json);
+
+/**
+ * @brief The `primitives` and `morphTargets` bytes of one mesh primitive.
+ */
+MemoryEstimate estimateMemory(const json::Json &json,
+                              const json::MeshPrimitive &primitive);
+
+/**
+ * @brief The bytes an accessor takes once loaded, after normalization.
+ */
+uint64_t accessorMemory(const json::Accessor &accessor);
+
+/**
+ * @brief Counts the bytes allocated by a load and enforces an optional
+ * budget on them.
+ */
+class MemoryCounter {
+public:
+  explicit MemoryCounter(std::optional<uint64_t> budget = std::nullopt)
+      : _budget(budget) {}
+
+  /**
+   * @brief Count `bytes` that are about to be allocated for `what`.
+   * @throws MemoryBudgetException when they would exceed the budget. The
+   * bytes are not counted then.
+   */
+  void reserve(uint64_t bytes, const char *what);
+
+  uint64_t bytes() const { return _bytes.load(std::memory_order_relaxed); }
+
+  const std::optional<uint64_t> &budget() const { return _budget; }
+
+  void reset() { _bytes.store(0, std::memory_order_relaxed); }
+
+private:
+  std::optional<uint64_t> _budget;
+  std::atomic<uint64_t> _bytes{0};
+};
+
+} // namespace gltf2
+
+#endif /* MemoryBudget_h */
@@ -0,0 +1,71 @@
+#ifndef MeshOptimizer_h
+#define MeshOptimizer_h
+
+#include "Executor.h"
+#include "GLBWriter.h"
+#include "GLTFData.h"
+#include "LoadOptions.h"
+#include <vector>
+
+namespace gltf2 {
+
+/**
+ * @brief Reorders the indices and vertices of triangle lists for the GPU,
+ * with the algorithms of meshoptimizer.
+ *
+ * The vertex cache pass reorders the triangles so that consecutive ones
+ * share vertices, which cuts the vertex shader invocations. The overdraw pass
+ * then sorts clusters of those triangles from the outside in, as long as the
+ * vertex cache gets at most `overdrawThreshold` times worse. The vertex fetch
+ * pass finally renumbers the vertices in the order the indices use them, so
+ * that every attribute, and every morph target, is read front to back.
+ */
+class MeshOptimizer {
+public:
+  explicit MeshOptimizer(MeshOptimizeOptions options = MeshOptimizeOptions())
+      : _options(options) {}
+
+  const MeshOptimizeOptions &options() const { return _options; }
+
+  /**
+   * @brief Optimize an indexed triangle list in place on the calling thread.
+   *
+   * Indices keep their component type. Sparse sources over zeros stay
+   * sparse when the vertices are reordered; other sparse sources are made
+   * dense.
+   *
+   * @return Whether the primitive was optimized. Primitives without indices,
+   * positions or a triangle list mode are left as they are, as are those
+   * whose indices or attribute counts are invalid.
+   */
+  bool optimize(MeshPrimitive &primitive) const;
+
+  /**
+   * @brief Optimize every primitive concurrently on `executor`.
+   */
+  void optimizeAll(const std::vector<MeshPrimitive *> &primitives,
+                   Executor &executor = defaultExecutor()) const;
+
+  /**
+   * @brief Write loaded data to a GLB whose indexed primitives are written
+   * from their loaded sources, as welded by `LoadOptions::vertexWeld` and
+   * optimized by `LoadOptions::meshOptimization`.
+   *
+   * Each rewritten primitive gets new vertex and index bufferViews, and the
+   * accessors only they referred to are removed along with their
+   * bufferViews. Draco primitives and every other bufferView are written as
+   * they are; attributes skipped by `LoadOptions::skippedAttributes` are
+   * dropped.
+   *
+   * The returned writer refers to the buffers of `data`, which must outlive
+   * it.
+   */
+  static GLBWriter write(const GLTFData &data);
+
+private:
+  MeshOptimizeOptions _options;
+};
+
+} // namespace gltf2
+
+#endif /* MeshOptimizer_h */
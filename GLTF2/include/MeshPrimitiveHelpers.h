@@ -0,0 +1,25 @@
+#ifndef MeshPrimitiveHelpers_h
+#define MeshPrimitiveHelpers_h
+
+#include "GLTFData.h"
+#include "Json.h"
+#include <vector>
+
+namespace gltf2 {
+
+/**
+ * @brief The accessor type of vectors of `components` components: a scalar,
+ * a vector, or a 3x3 or 4x4 matrix.
+ */
+json::Accessor::Type typeOfComponents(uint8_t components);
+
+/**
+ * @brief Read the indices of a loaded element as 32-bit integers.
+ * @return False if they are not unsigned integers.
+ */
+bool readIndices(const MeshPrimitiveElement &element,
+                 std::vector<uint32_t> &indices);
+
+} // namespace gltf2
+
+#endif /* MeshPrimitiveHelpers_h */
@@ -0,0 +1,23 @@
+#ifndef MeshoptDecoder_h
+#define MeshoptDecoder_h
+
+#include "GLTFFile.h"
+#include "Json.h"
+
+namespace gltf2 {
+
+/**
+ * @brief Decode the EXT_meshopt_compression data of bufferView `index` into
+ * `dst`, which holds its byteLength bytes.
+ *
+ * @param buffer The buffer that the extension of the bufferView refers to.
+ * @throws InvalidFormatException If the data is out of range of `buffer` or
+ * cannot be decoded.
+ */
+void decodeMeshoptBufferView(const json::BufferView &bufferView,
+                             uint32_t index, const Buffer &buffer,
+                             uint8_t *dst);
+
+} // namespace gltf2
+
+#endif /* MeshoptDecoder_h */
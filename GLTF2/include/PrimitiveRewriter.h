@@ -0,0 +1,111 @@
+#ifndef PrimitiveRewriter_h
+#define PrimitiveRewriter_h
+
+#include "GLBWriter.h"
+#include "GLTFData.h"
+#include "Json.h"
+#include <optional>
+#include <vector>
+
+namespace gltf2 {
+
+/**
+ * @brief Writes loaded data to a GLB in which some mesh primitives refer to
+ * new accessors and bufferViews.
+ *
+ * New accessors and bufferViews are appended to a copy of the document. When
+ * it is written, the accessors the original document referred to and the
+ * rewritten one no longer does are removed, and only the bufferViews still
+ * referred to are written: the original ones from the loaded data, the new
+ * ones from their payloads. Images keep their URIs.
+ *
+ * The payloads of new bufferViews that are not moved into the rewriter, and
+ * the buffers of the data, must outlive the returned writer.
+ */
+class PrimitiveRewriter {
+public:
+  explicit PrimitiveRewriter(const GLTFData &data);
+
+  json::Json &json() { return _json; }
+
+  /**
+   * @brief Append a bufferView of `bytes` bytes at `data`.
+   * @return Its index in `json()`.
+   */
+  uint32_t addBufferView(const uint8_t *data, uint32_t bytes,
+                         std::optional<uint32_t> byteStride = std::nullopt,
+                         std::optional<uint32_t> target = std::nullopt);
+
+  /**
+   * @brief Append a bufferView of a buffer the rewriter keeps.
+   * @return Its index in `json()`.
+   */
+  uint32_t addBufferView(Buffer &&buffer,
+                         std::optional<uint32_t> byteStride = std::nullopt,
+                         std::optional<uint32_t> target = std::nullopt);
+
+  /// @return The index of the accessor in `json()`.
+  uint32_t addAccessor(const json::Accessor &accessor);
+
+  /**
+   * @brief Append an accessor of `count` elements typed as `source`, with
+   * the bounds glTF requires when `isPosition`. When `stored`, the elements
+   * of the source are written to a new vertex bufferView, padded to 4 bytes;
+   * otherwise the accessor has no bufferView, as extensions that carry the
+   * data elsewhere expect.
+   */
+  uint32_t addSourceAccessor(const MeshPrimitiveSource &source, uint32_t count,
+                             bool stored, bool isPosition = false);
+
+  /**
+   * @brief Append accessors for the sources of a primitive.
+   * @return The attributes referring to them.
+   */
+  json::MeshPrimitiveAttributes addSources(const MeshPrimitiveSources &sources,
+                                           uint32_t count, bool stored);
+
+  /**
+   * @brief Append accessors for the positions, normals and tangents of a
+   * morph target.
+   */
+  json::MeshPrimitiveTarget addTarget(const MeshPrimitiveSources &target,
+                                      uint32_t count);
+
+  /**
+   * @brief Append an index accessor of a loaded element, stored in a new
+   * element array bufferView.
+   */
+  uint32_t addElementAccessor(const MeshPrimitiveElement &element);
+
+  /**
+   * @brief Remove the replaced accessors and write the document. The
+   * rewriter is left empty.
+   */
+  GLBWriter write();
+
+private:
+  struct Payload {
+    const uint8_t *data;
+    uint32_t bytes;
+    /// The index of the kept buffer in `_buffers`, if any.
+    std::optional<size_t> buffer;
+  };
+
+  const GLTFData &_data;
+  json::Json _json;
+  /// The number of bufferViews of the original document.
+  uint32_t _bufferViewCount;
+  /// The accessors the original document referred to.
+  std::vector<bool> _usedAccessors;
+  /// The payloads of the new bufferViews, in order.
+  std::vector<Payload> _payloads;
+  std::vector<Buffer> _buffers;
+
+  uint32_t addBufferView(Payload payload, std::optional<uint32_t> byteStride,
+                         std::optional<uint32_t> target);
+  void removeReplacedAccessors();
+};
+
+} // namespace gltf2
+
+#endif /* PrimitiveRewriter_h */
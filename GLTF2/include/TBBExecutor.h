@@ -0,0 +1,48 @@
+#ifndef TBBExecutor_h
+#define TBBExecutor_h
+
+#include "Executor.h"
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+namespace gltf2 {
+
+/**
+ * @brief Runs the work of GLTF2 in a oneTBB task arena, so loads share
+ * threads with the rest of an application that uses TBB.
+ *
+ * This adapter is header-only: including it requires TBB, building GLTF2
+ * does not. Priorities are left to the arena.
+ */
+class TBBExecutor : public Executor {
+public:
+  explicit TBBExecutor(tbb::task_arena &arena) : _arena(arena) {}
+
+  void submit(std::function<void()> fn,
+              TaskPriority /*priority*/ = TaskPriority::Normal) override {
+    _arena.enqueue(std::move(fn));
+  }
+
+  void parallelFor(size_t count, const std::function<void(size_t)> &fn,
+                   TaskPriority /*priority*/ = TaskPriority::Normal) override {
+    _arena.execute([&] {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, count),
+                        [&](const tbb::blocked_range<size_t> &range) {
+                          for (auto i = range.begin(); i != range.end(); i++)
+                            fn(i);
+                        });
+    });
+  }
+
+  size_t concurrency() const override {
+    return _arena.max_concurrency();
+  }
+
+private:
+  tbb::task_arena &_arena;
+};
+
+} // namespace gltf2
+
+#endif /* TBBExecutor_h */
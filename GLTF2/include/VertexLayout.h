@@ -0,0 +1,142 @@
+#ifndef VertexLayout_h
+#define VertexLayout_h
+
+#include "Executor.h"
+#include "GLTFData.h"
+#include <optional>
+#include <vector>
+
+namespace gltf2 {
+
+/**
+ * @brief The attributes of `MeshPrimitiveSources`.
+ */
+enum class VertexAttribute {
+  Position,
+  Normal,
+  Tangent,
+  Texcoord,
+  Color,
+  Joints,
+  Weights
+};
+
+/**
+ * @brief The format of an attribute in an interleaved vertex, named after
+ * the WebGPU vertex formats.
+ */
+enum class VertexFormat {
+  Float32,
+  Float32x2,
+  Float32x3,
+  Float32x4,
+  Float16x2,
+  Float16x4,
+  Snorm16x2,
+  Snorm16x4,
+  Unorm16x2,
+  Unorm16x4,
+  Snorm8x4,
+  Unorm8x4,
+  Uint16x4,
+  Uint8x4
+};
+
+uint32_t componentsOfVertexFormat(VertexFormat format);
+
+uint32_t sizeOfVertexFormat(VertexFormat format);
+
+struct VertexElement {
+  VertexAttribute attribute;
+  VertexFormat format;
+  /// The set of texcoords, colors, joints or weights.
+  uint32_t set = 0;
+  /// The offset of the element in the vertex. Without one, the element
+  /// follows the previous one at the next multiple of `alignment`.
+  std::optional<uint32_t> offset = std::nullopt;
+  uint32_t alignment = 4;
+};
+
+/**
+ * @brief The elements of an interleaved vertex.
+ *
+ * Each element converts the components of its attribute to its format:
+ * normalized integers are dequantized, floats are rounded to halves or
+ * to normalized integers, and integer formats take the values as they are.
+ * Components the attribute does not have are 0, and a missing fourth
+ * component is 1, so RGB colors get an opaque alpha.
+ */
+struct VertexLayout {
+  std::vector<VertexElement> elements;
+  /// The size of a vertex. Without one, it is the end of the last element
+  /// rounded up to `strideAlignment`.
+  std::optional<uint32_t> stride;
+  uint32_t strideAlignment = 4;
+};
+
+/**
+ * @brief The vertices of a primitive interleaved with a layout.
+ */
+struct InterleavedVertices {
+  Buffer buffer;
+  uint32_t vertexCount = 0;
+};
+
+/**
+ * @brief Interleaves the sources of mesh primitives into vertex buffers
+ * ready for upload.
+ */
+class VertexBufferBuilder {
+public:
+  /**
+   * @throws InputException If an offset is not a multiple of its alignment,
+   * elements overlap, or the stride is smaller than a vertex.
+   */
+  explicit VertexBufferBuilder(VertexLayout layout);
+
+  const VertexLayout &layout() const { return _layout; }
+
+  /// The size of a vertex in bytes.
+  uint32_t stride() const { return _stride; }
+
+  /// The offset of each element of the layout, in order.
+  const std::vector<uint32_t> &offsets() const { return _offsets; }
+
+  /**
+   * @brief Write the vertices of a primitive to `dst`, which has room for
+   * `stride() * vertexCount` bytes.
+   *
+   * The vertices are written in blocks that stay in the L1 cache: every
+   * element converts a block of its source to floats and stores it in its
+   * format, so `dst` is written front to back in one pass. If the layout has
+   * padding or the primitive lacks one of its attributes, `dst` is zeroed
+   * first, and those bytes stay zero.
+   *
+   * @throws InputException If a source does not have `vertexCount`
+   * vertices.
+   */
+  void build(const MeshPrimitiveSources &sources, uint32_t vertexCount,
+             uint8_t *dst) const;
+
+  /**
+   * @brief Interleave the vertices of a primitive into a new buffer. The
+   * number of vertices is that of its positions.
+   */
+  InterleavedVertices build(const MeshPrimitive &primitive) const;
+
+  /**
+   * @brief Interleave every primitive of every mesh concurrently on
+   * `executor`, indexed by mesh then primitive.
+   */
+  std::vector<std::vector<InterleavedVertices>>
+  buildAll(const GLTFData &data, Executor &executor = defaultExecutor()) const;
+
+private:
+  VertexLayout _layout;
+  uint32_t _stride;
+  std::vector<uint32_t> _offsets;
+};
+
+} // namespace gltf2
+
+#endif /* VertexLayout_h */
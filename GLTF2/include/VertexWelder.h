@@ -0,0 +1,50 @@
+#ifndef VertexWelder_h
+#define VertexWelder_h
+
+#include "Executor.h"
+#include "GLTFData.h"
+#include "LoadOptions.h"
+
+namespace gltf2 {
+
+/**
+ * @brief Merges the vertices of mesh primitives that are equal in every
+ * attribute and every morph target, and indexes the remaining ones.
+ *
+ * Every vertex is packed into a key of all its components, with float
+ * positions and normals snapped to the grid of their epsilon. The keys are
+ * inserted concurrently into an open addressing hash table that keeps the
+ * first vertex of each set of equal keys, so the result does not depend on
+ * the scheduling. The kept vertices are numbered in their original order.
+ */
+class VertexWelder {
+public:
+  explicit VertexWelder(VertexWeldOptions options = VertexWeldOptions())
+      : _options(options) {}
+
+  const VertexWeldOptions &options() const { return _options; }
+
+  /**
+   * @brief Weld the vertices of a primitive in place, concurrently on
+   * `executor` for large primitives.
+   *
+   * The indices are rewritten to the welded vertices, widening their
+   * component type if needed, and a primitive without indices gets them,
+   * drawn in `mode`. Welded sources are dense.
+   *
+   * @return Whether the primitive was welded. Primitives without positions,
+   * and those whose indices or attribute counts are invalid, are left as
+   * they are.
+   */
+  bool
+  weld(MeshPrimitive &primitive,
+       json::MeshPrimitive::Mode mode = json::MeshPrimitive::Mode::TRIANGLES,
+       Executor &executor = defaultExecutor()) const;
+
+private:
+  VertexWeldOptions _options;
+};
+
+} // namespace gltf2
+
+#endif /* VertexWelder_h */
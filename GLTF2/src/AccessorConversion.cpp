@@ -0,0 +1,427 @@
+#include "AccessorConversion.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#if defined(__F16C__) && !defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace gltf2 {
+
+namespace {
+
+/*
+ * Every kernel divides rather than multiplies by a reciprocal, so all of
+ * them produce exactly the same floats as `convertComponent`.
+ */
+template <typename T> float normalizeScalar(T c) {
+  return convertComponent<T, float, true>(c);
+}
+
+/*
+ * Each `normalizeVectorized` overload converts a prefix of the components
+ * and returns its length; the scalar loop finishes the rest.
+ */
+#if defined(__AVX2__)
+
+inline void storeNormalized(float *dst, __m256i values, float scale,
+                            bool isSigned) {
+  auto f = _mm256_div_ps(_mm256_cvtepi32_ps(values), _mm256_set1_ps(scale));
+  if (isSigned)
+    f = _mm256_max_ps(f, _mm256_set1_ps(-1.0f));
+  _mm256_storeu_ps(dst, f);
+}
+
+size_t normalizeVectorized(const int8_t *src, size_t count, float *dst) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    auto v = _mm_loadl_epi64((const __m128i *)(src + i));
+    storeNormalized(dst + i, _mm256_cvtepi8_epi32(v), INT8_MAX, true);
+  }
+  return i;
+}
+
+size_t normalizeVectorized(const uint8_t *src, size_t count, float *dst) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    auto v = _mm_loadl_epi64((const __m128i *)(src + i));
+    storeNormalized(dst + i, _mm256_cvtepu8_epi32(v), UINT8_MAX, false);
+  }
+  return i;
+}
+
+size_t normalizeVectorized(const int16_t *src, size_t count, float *dst) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    auto v = _mm_loadu_si128((const __m128i *)(src + i));
+    storeNormalized(dst + i, _mm256_cvtepi16_epi32(v), INT16_MAX, true);
+  }
+  return i;
+}
+
+size_t normalizeVectorized(const uint16_t *src, size_t count, float *dst) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    auto v = _mm_loadu_si128((const __m128i *)(src + i));
+    storeNormalized(dst + i, _mm256_cvtepu16_epi32(v), UINT16_MAX, false);
+  }
+  return i;
+}
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+// SSE2 is part of x86-64, and its unpacks are enough to widen the
+// components, so these kernels need no SSE4.1.
+inline void storeNormalized(float *dst, __m128i values, float scale,
+                            bool isSigned) {
+  auto f = _mm_div_ps(_mm_cvtepi32_ps(values), _mm_set1_ps(scale));
+  if (isSigned)
+    f = _mm_max_ps(f, _mm_set1_ps(-1.0f));
+  _mm_storeu_ps(dst, f);
+}
+
+// Widen 8 16-bit lanes into two vectors of 32-bit lanes.
+inline void storeNormalized16(float *dst, __m128i v, float scale,
+                              bool isSigned) {
+  if (isSigned) {
+    storeNormalized(dst, _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16), scale,
+                    true);
+    storeNormalized(dst + 4, _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16),
+                    scale, true);
+  } else {
+    auto zero = _mm_setzero_si128();
+    storeNormalized(dst, _mm_unpacklo_epi16(v, zero), scale, false);
+    storeNormalized(dst + 4, _mm_unpackhi_epi16(v, zero), scale, false);
+  }
+}
+
+size_t normalizeVectorized(const int8_t *src, size_t count, float *dst) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    auto v = _mm_loadu_si128((const __m128i *)(src + i));
+    storeNormalized16(dst + i, _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8),
+                      INT8_MAX, true);
+    storeNormalized16(dst + i + 8,
+                      _mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8), INT8_MAX,
+                      true);
+  }
+  return i;
+}
+
+size_t normalizeVectorized(const uint8_t *src, size_t count, float *dst) {
+  size_t i = 0;
+  auto zero = _mm_setzero_si128();
+  for (; i + 16 <= count; i += 16) {
+    auto v = _mm_loadu_si128((const __m128i *)(src + i));
+    storeNormalized16(dst + i, _mm_unpacklo_epi8(v, zero), UINT8_MAX, false);
+    storeNormalized16(dst + i + 8, _mm_unpackhi_epi8(v, zero), UINT8_MAX,
+                      false);
+  }
+  return i;
+}
+
+size_t normalizeVectorized(const int16_t *src, size_t count, float *dst) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    auto v = _mm_loadu_si128((const __m128i *)(src + i));
+    storeNormalized16(dst + i, v, INT16_MAX, true);
+  }
+  return i;
+}
+
+size_t normalizeVectorized(const uint16_t *src, size_t count, float *dst) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    auto v = _mm_loadu_si128((const __m128i *)(src + i));
+    storeNormalized16(dst + i, v, UINT16_MAX, false);
+  }
+  return i;
+}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+inline void storeNormalized(float *dst, int32x4_t values, float scale,
+                            bool isSigned) {
+  auto f = vdivq_f32(vcvtq_f32_s32(values), vdupq_n_f32(scale));
+  if (isSigned)
+    f = vmaxq_f32(f, vdupq_n_f32(-1.0f));
+  vst1q_f32(dst, f);
+}
+
+inline void storeNormalized(float *dst, int16x8_t v, float scale) {
+  storeNormalized(dst, vmovl_s16(vget_low_s16(v)), scale, true);
+  storeNormalized(dst + 4, vmovl_s16(vget_high_s16(v)), scale, true);
+}
+
+inline void storeNormalized(float *dst, uint16x8_t v, float scale) {
+  storeNormalized(dst, vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(v))),
+                  scale, false);
+  storeNormalized(dst + 4,
+                  vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(v))), scale,
+                  false);
+}
+
+size_t normalizeVectorized(const int8_t *src, size_t count, float *dst) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    auto v = vld1q_s8(src + i);
+    storeNormalized(dst + i, vmovl_s8(vget_low_s8(v)), INT8_MAX);
+    storeNormalized(dst + i + 8, vmovl_s8(vget_high_s8(v)), INT8_MAX);
+  }
+  return i;
+}
+
+size_t normalizeVectorized(const uint8_t *src, size_t count, float *dst) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    auto v = vld1q_u8(src + i);
+    storeNormalized(dst + i, vmovl_u8(vget_low_u8(v)), UINT8_MAX);
+    storeNormalized(dst + i + 8, vmovl_u8(vget_high_u8(v)), UINT8_MAX);
+  }
+  return i;
+}
+
+size_t normalizeVectorized(const int16_t *src, size_t count, float *dst) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    storeNormalized(dst + i, vld1q_s16(src + i), INT16_MAX);
+  return i;
+}
+
+size_t normalizeVectorized(const uint16_t *src, size_t count, float *dst) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    storeNormalized(dst + i, vld1q_u16(src + i), UINT16_MAX);
+  return i;
+}
+
+#else
+
+template <typename T>
+size_t normalizeVectorized(const T *src, size_t count, float *dst) {
+  return 0;
+}
+
+#endif
+
+/*
+ * Copies for the gather kernels: 16 bytes, and two 8-byte elements joined
+ * into one 16-byte store.
+ */
+#if defined(__SSE2__) || defined(_M_X64)
+
+inline void copy16(uint8_t *dst, const uint8_t *src) {
+  _mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+}
+
+inline void copy8x2(uint8_t *dst, const uint8_t *a, const uint8_t *b) {
+  _mm_storeu_si128((__m128i *)dst,
+                   _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)a),
+                                      _mm_loadl_epi64((const __m128i *)b)));
+}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+inline void copy16(uint8_t *dst, const uint8_t *src) {
+  vst1q_u8(dst, vld1q_u8(src));
+}
+
+inline void copy8x2(uint8_t *dst, const uint8_t *a, const uint8_t *b) {
+  vst1q_u8(dst, vcombine_u8(vld1_u8(a), vld1_u8(b)));
+}
+
+#else
+
+inline void copy16(uint8_t *dst, const uint8_t *src) {
+  std::memcpy(dst, src, 16);
+}
+
+inline void copy8x2(uint8_t *dst, const uint8_t *a, const uint8_t *b) {
+  std::memcpy(dst, a, 8);
+  std::memcpy(dst + 8, b, 8);
+}
+
+#endif
+
+// A copy of constant size compiles to plain loads and stores.
+template <size_t Size>
+void gatherFixed(const uint8_t *src, size_t byteStride, size_t count,
+                 uint8_t *dst) {
+  for (size_t i = 0; i < count; i++)
+    std::memcpy(dst + i * Size, src + i * byteStride, Size);
+}
+
+void gather8(const uint8_t *src, size_t byteStride, size_t count,
+             uint8_t *dst) {
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2)
+    copy8x2(dst + i * 8, src + i * byteStride, src + (i + 1) * byteStride);
+  gatherFixed<8>(src + i * byteStride, byteStride, count - i, dst + i * 8);
+}
+
+// Every element but the last is copied with 16 bytes: the 4 bytes read past
+// it belong to the next element, and the 4 bytes written past it are
+// overwritten by the next copy.
+void gather12(const uint8_t *src, size_t byteStride, size_t count,
+              uint8_t *dst) {
+  if (count == 0)
+    return;
+  for (size_t i = 0; i + 1 < count; i++)
+    copy16(dst + i * 12, src + i * byteStride);
+  std::memcpy(dst + (count - 1) * 12, src + (count - 1) * byteStride, 12);
+}
+
+void gather16(const uint8_t *src, size_t byteStride, size_t count,
+              uint8_t *dst) {
+  for (size_t i = 0; i < count; i++)
+    copy16(dst + i * 16, src + i * byteStride);
+}
+
+/*
+ * Rounds to the nearest half, ties to even, like the F16C and NEON
+ * conversions, including subnormal halves.
+ */
+inline uint16_t halfOfFloat(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  uint16_t sign = (bits >> 16) & 0x8000;
+  uint32_t abs = bits & 0x7fffffff;
+  if (abs > 0x7f800000)
+    return sign | 0x7e00;
+  // 65520 and above round to infinity
+  if (abs >= 0x477ff000)
+    return sign | 0x7c00;
+  // below 2^-14 the half is subnormal, in units of 2^-24
+  if (abs < 0x38800000)
+    return sign | (uint16_t)std::nearbyint(std::fabs(value) * 16777216.0f);
+  uint32_t half = (abs >> 13) - (112 << 10);
+  uint32_t rest = abs & 0x1fff;
+  half += rest > 0x1000 || (rest == 0x1000 && (half & 1));
+  return sign | (uint16_t)half;
+}
+
+template <typename T>
+void normalize(const void *src, size_t count, float *dst) {
+  const T *values = (const T *)src;
+  for (size_t i = normalizeVectorized(values, count, dst); i < count; i++)
+    dst[i] = normalizeScalar(values[i]);
+}
+
+} // namespace
+
+void normalizeComponents(const void *src, size_t count,
+                         json::Accessor::ComponentType componentType,
+                         float *dst) {
+  switch (componentType) {
+  case json::Accessor::ComponentType::BYTE:
+    normalize<int8_t>(src, count, dst);
+    break;
+  case json::Accessor::ComponentType::UNSIGNED_BYTE:
+    normalize<uint8_t>(src, count, dst);
+    break;
+  case json::Accessor::ComponentType::SHORT:
+    normalize<int16_t>(src, count, dst);
+    break;
+  case json::Accessor::ComponentType::UNSIGNED_SHORT:
+    normalize<uint16_t>(src, count, dst);
+    break;
+  case json::Accessor::ComponentType::UNSIGNED_INT: {
+    const uint32_t *values = (const uint32_t *)src;
+    for (size_t i = 0; i < count; i++)
+      dst[i] = normalizeScalar(values[i]);
+    break;
+  }
+  case json::Accessor::ComponentType::FLOAT:
+    std::memcpy(dst, src, sizeof(float) * count);
+    break;
+  }
+}
+
+void floatsToHalfs(const float *src, size_t count, uint16_t *dst) {
+  size_t i = 0;
+#if defined(__F16C__)
+  for (; i + 8 <= count; i += 8) {
+    __m128i halfs = _mm256_cvtps_ph(_mm256_loadu_ps(src + i),
+                                    _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128((__m128i *)(dst + i), halfs);
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  for (; i + 4 <= count; i += 4) {
+    float16x4_t halfs = vcvt_f16_f32(vld1q_f32(src + i));
+    vst1_u16(dst + i, vreinterpret_u16_f16(halfs));
+  }
+#endif
+  for (; i < count; i++)
+    dst[i] = halfOfFloat(src[i]);
+}
+
+void gatherElements(const void *src, size_t byteStride, size_t elementSize,
+                    size_t count, void *dst) {
+  const uint8_t *s = (const uint8_t *)src;
+  uint8_t *d = (uint8_t *)dst;
+  if (byteStride == elementSize) {
+    std::memcpy(d, s, elementSize * count);
+    return;
+  }
+  switch (elementSize) {
+  case 1:
+    gatherFixed<1>(s, byteStride, count, d);
+    break;
+  case 2:
+    gatherFixed<2>(s, byteStride, count, d);
+    break;
+  case 4:
+    gatherFixed<4>(s, byteStride, count, d);
+    break;
+  case 6:
+    gatherFixed<6>(s, byteStride, count, d);
+    break;
+  case 8:
+    gather8(s, byteStride, count, d);
+    break;
+  case 12:
+    gather12(s, byteStride, count, d);
+    break;
+  case 16:
+    gather16(s, byteStride, count, d);
+    break;
+  default:
+    for (size_t i = 0; i < count; i++)
+      std::memcpy(d + i * elementSize, s + i * byteStride, elementSize);
+    break;
+  }
+}
+
+void deinterleave(const void *src, size_t byteStride, size_t count,
+                  const std::vector<InterleavedElement> &elements) {
+  // Split blocks of vertices that stay in the L1 cache while every element
+  // is gathered from them.
+  const size_t blockBytes = 16 * 1024;
+  const size_t block = std::max<size_t>(1, blockBytes / byteStride);
+  const uint8_t *s = (const uint8_t *)src;
+  for (size_t begin = 0; begin < count; begin += block) {
+    auto n = std::min(block, count - begin);
+    for (const auto &element : elements) {
+      gatherElements(s + begin * byteStride + element.byteOffset, byteStride,
+                     element.elementSize, n,
+                     (uint8_t *)element.dst + begin * element.elementSize);
+    }
+  }
+}
+
+Buffer normalizeBuffer(const Buffer &binary, const json::Accessor &accessor) {
+  auto count =
+      (size_t)json::Accessor::componentsCountOfType(accessor.type) *
+      accessor.count;
+  Buffer res(sizeof(float) * count);
+  normalizeComponents(binary.data(), count, accessor.componentType,
+                      (float *)res.data());
+  return res;
+}
+
+} // namespace gltf2
@@ -0,0 +1,65 @@
+#include "DracoDecoder.h"
+#include "GLTFException.h"
+#include "draco/compression/decode.h"
+#include "draco/core/decoder_buffer.h"
+#include <optional>
+
+namespace gltf2 {
+
+static void skipAttributeTransforms(draco::Decoder &decoder,
+                                    MeshAttributes skipped) {
+  // skipped attributes are left quantized; tangents, joints and weights are
+  // all GENERIC attributes
+  if (contains(skipped, MeshAttributes::Normal))
+    decoder.SetSkipAttributeTransform(draco::GeometryAttribute::NORMAL);
+  if (contains(skipped, MeshAttributes::Texcoords))
+    decoder.SetSkipAttributeTransform(draco::GeometryAttribute::TEX_COORD);
+  if (contains(skipped, MeshAttributes::Colors))
+    decoder.SetSkipAttributeTransform(draco::GeometryAttribute::COLOR);
+  if (contains(skipped, MeshAttributes::Tangent) &&
+      contains(skipped, MeshAttributes::Joints) &&
+      contains(skipped, MeshAttributes::Weights))
+    decoder.SetSkipAttributeTransform(draco::GeometryAttribute::GENERIC);
+}
+
+/**
+ * @brief The decoder of the calling thread, configured for `skipped`.
+ */
+static draco::Decoder &threadDecoder(MeshAttributes skipped) {
+  thread_local std::optional<draco::Decoder> decoder;
+  thread_local MeshAttributes decoderSkipped = MeshAttributes::None;
+  if (!decoder || decoderSkipped != skipped) {
+    decoder.emplace();
+    skipAttributeTransforms(*decoder, skipped);
+    decoderSkipped = skipped;
+  }
+  return *decoder;
+}
+
+std::unique_ptr<draco::Mesh> DracoDecoder::decode(const uint8_t *data,
+                                                  size_t bytes) const {
+  draco::DecoderBuffer buffer;
+  buffer.Init((const char *)data, bytes);
+  auto statusOrMesh =
+      threadDecoder(_skippedAttributes).DecodeMeshFromBuffer(&buffer);
+  if (!statusOrMesh.ok()) {
+    throw InvalidFormatException("failed to decode Draco mesh: " +
+                                 statusOrMesh.status().error_msg_string());
+  }
+  auto mesh = std::move(statusOrMesh).value();
+  if (!mesh)
+    throw InvalidFormatException("failed to decode Draco mesh");
+  return mesh;
+}
+
+std::vector<std::unique_ptr<draco::Mesh>>
+DracoDecoder::decodeAll(const std::vector<BufferView> &bufferViews,
+                        Executor &executor) const {
+  std::vector<std::unique_ptr<draco::Mesh>> meshes(bufferViews.size());
+  executor.parallelFor(bufferViews.size(), [&](size_t i) {
+    meshes[i] = decode(bufferViews[i]);
+  });
+  return meshes;
+}
+
+} // namespace gltf2
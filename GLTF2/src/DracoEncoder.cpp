@@ -0,0 +1,287 @@
+#include "DracoEncoder.h"
+#include "GLTFException.h"
+#include "GLTFExtension.h"
+#include "PrimitiveRewriter.h"
+#include "draco/compression/expert_encode.h"
+#include "draco/core/encoder_buffer.h"
+#include "draco/mesh/mesh.h"
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+
+namespace gltf2 {
+
+static draco::DataType dracoDataType(json::Accessor::ComponentType type) {
+  switch (type) {
+  case json::Accessor::ComponentType::BYTE:
+    return draco::DT_INT8;
+  case json::Accessor::ComponentType::UNSIGNED_BYTE:
+    return draco::DT_UINT8;
+  case json::Accessor::ComponentType::SHORT:
+    return draco::DT_INT16;
+  case json::Accessor::ComponentType::UNSIGNED_SHORT:
+    return draco::DT_UINT16;
+  case json::Accessor::ComponentType::UNSIGNED_INT:
+    return draco::DT_UINT32;
+  case json::Accessor::ComponentType::FLOAT:
+    return draco::DT_FLOAT32;
+  }
+  return draco::DT_INVALID;
+}
+
+/**
+ * @brief Add the faces of a triangle list, or of the vertices in order when
+ * the primitive has no element.
+ */
+static void setFaces(draco::Mesh &mesh,
+                     const std::optional<MeshPrimitiveElement> &element) {
+  auto vertexCount = mesh.num_points();
+  auto setEach = [&mesh, vertexCount](size_t count, auto indexAt) {
+    mesh.SetNumFaces(count / 3);
+    for (size_t i = 0; i < count / 3; i++) {
+      draco::Mesh::Face face;
+      for (size_t j = 0; j < 3; j++) {
+        uint32_t index = indexAt(i * 3 + j);
+        if (index >= vertexCount)
+          throw InputException("Draco mesh index out of range");
+        face[j] = draco::PointIndex(index);
+      }
+      mesh.SetFace(draco::FaceIndex((uint32_t)i), face);
+    }
+  };
+  if (!element) {
+    setEach(vertexCount, [](size_t i) { return (uint32_t)i; });
+    return;
+  }
+  const auto *data = element->buffer.data();
+  switch (element->componentType) {
+  case json::Accessor::ComponentType::UNSIGNED_BYTE:
+    setEach(element->buffer.size(), [data](size_t i) { return data[i]; });
+    break;
+  case json::Accessor::ComponentType::UNSIGNED_SHORT: {
+    const auto *indices = (const uint16_t *)data;
+    setEach(element->buffer.size() / 2,
+            [indices](size_t i) { return indices[i]; });
+    break;
+  }
+  case json::Accessor::ComponentType::UNSIGNED_INT: {
+    const auto *indices = (const uint32_t *)data;
+    setEach(element->buffer.size() / 4,
+            [indices](size_t i) { return indices[i]; });
+    break;
+  }
+  default:
+    throw InputException("Draco mesh indices must be unsigned integers");
+  }
+}
+
+/**
+ * @brief Add a source to the mesh as an attribute of `type`.
+ * @return The id of the attribute in the mesh.
+ */
+static int addAttribute(draco::Mesh &mesh, draco::GeometryAttribute::Type type,
+                        const MeshPrimitiveSource &source) {
+  if (source.vectorCount != mesh.num_points())
+    throw InputException("Draco mesh attributes must have the same count");
+  auto elementSize =
+      json::Accessor::sizeOfComponentType(source.componentType) *
+      source.componentsPerVector;
+  draco::GeometryAttribute attribute;
+  attribute.Init(type, nullptr, source.componentsPerVector,
+                 dracoDataType(source.componentType), source.normalized,
+                 elementSize, 0);
+  auto id = mesh.AddAttribute(attribute, true, mesh.num_points());
+  auto *buffer = mesh.attribute(id)->buffer();
+  if (source.sparse) {
+    source.sparse->densify(buffer->data());
+  } else {
+    buffer->Write(0, source.buffer.data(),
+                  std::min<size_t>(source.buffer.size(),
+                                   (size_t)elementSize * source.vectorCount));
+  }
+  return id;
+}
+
+DracoEncodedPrimitive
+DracoEncoder::encode(const MeshPrimitive &primitive) const {
+  const auto &sources = primitive.sources;
+  if (!sources.position)
+    throw InputException("Draco mesh primitive has no positions");
+  if (primitive.element && primitive.element->primitiveMode !=
+                               json::MeshPrimitive::Mode::TRIANGLES)
+    throw InputException("Draco mesh primitive must be a triangle list");
+
+  draco::Mesh mesh;
+  mesh.set_num_points(sources.position->vectorCount);
+  setFaces(mesh, primitive.element);
+
+  DracoEncodedPrimitive encoded;
+  auto &ids = encoded.extension.attributes;
+  // the attribute ids and bits of the float attributes to quantize
+  std::vector<std::pair<int, int>> quantized;
+  auto add = [&](draco::GeometryAttribute::Type type,
+                 const MeshPrimitiveSource &source, int bits) {
+    auto id = addAttribute(mesh, type, source);
+    if (bits > 0 &&
+        source.componentType == json::Accessor::ComponentType::FLOAT)
+      quantized.emplace_back(id, bits);
+    return mesh.attribute(id)->unique_id();
+  };
+  auto addEach = [&](draco::GeometryAttribute::Type type,
+                     const std::vector<MeshPrimitiveSource> &sources, int bits,
+                     std::optional<std::vector<uint32_t>> &uniqueIds) {
+    if (sources.empty())
+      return;
+    uniqueIds.emplace();
+    for (const auto &source : sources)
+      uniqueIds->push_back(add(type, source, bits));
+  };
+  const auto &bits = _options.quantization;
+  ids.position = add(draco::GeometryAttribute::POSITION, *sources.position,
+                     bits.position);
+  if (sources.normal)
+    ids.normal =
+        add(draco::GeometryAttribute::NORMAL, *sources.normal, bits.normal);
+  // tangents, joints and weights are GENERIC attributes, as DracoDecoder
+  // expects
+  if (sources.tangent)
+    ids.tangent = add(draco::GeometryAttribute::GENERIC, *sources.tangent,
+                      bits.tangent);
+  addEach(draco::GeometryAttribute::TEX_COORD, sources.texcoords,
+          bits.texcoord, ids.texcoords);
+  addEach(draco::GeometryAttribute::COLOR, sources.colors, bits.color,
+          ids.colors);
+  addEach(draco::GeometryAttribute::GENERIC, sources.joints, 0, ids.joints);
+  addEach(draco::GeometryAttribute::GENERIC, sources.weights, bits.weights,
+          ids.weights);
+
+  draco::ExpertEncoder encoder(mesh);
+  encoder.SetSpeedOptions(_options.encodingSpeed, _options.decodingSpeed);
+  for (const auto &[id, attributeBits] : quantized)
+    encoder.SetAttributeQuantization(id, attributeBits);
+  // edgebreaker reorders the vertices, which morph targets are indexed by
+  encoder.SetEncodingMethod(primitive.targets.empty()
+                                ? draco::MESH_EDGEBREAKER_ENCODING
+                                : draco::MESH_SEQUENTIAL_ENCODING);
+  encoder.SetTrackEncodedProperties(true);
+  draco::EncoderBuffer buffer;
+  auto status = encoder.EncodeToBuffer(&buffer);
+  if (!status.ok()) {
+    throw InputException(
+        ("Failed to encode Draco mesh: " + status.error_msg_string()).c_str());
+  }
+  const auto *data = (const uint8_t *)buffer.data();
+  encoded.data.assign(data, data + buffer.size());
+  encoded.vertexCount = (uint32_t)encoder.num_encoded_points();
+  encoded.indexCount = (uint32_t)encoder.num_encoded_faces() * 3;
+  return encoded;
+}
+
+std::vector<DracoEncodedPrimitive>
+DracoEncoder::encodeAll(const std::vector<const MeshPrimitive *> &primitives,
+                        Executor &executor) const {
+  std::vector<DracoEncodedPrimitive> encoded(primitives.size());
+  executor.parallelFor(primitives.size(), [&](size_t i) {
+    encoded[i] = encode(*primitives[i]);
+  });
+  return encoded;
+}
+
+/**
+ * @brief Widen the bounds of quantized positions by one quantization step,
+ * so that they contain the positions decoded from the Draco mesh as well as
+ * the source ones.
+ */
+static void widenQuantizedBounds(json::Accessor &accessor, int bits) {
+  if (!accessor.min || !accessor.max)
+    return;
+  auto &min = *accessor.min;
+  auto &max = *accessor.max;
+  // Draco quantizes every component over the largest extent
+  float extent = 0;
+  for (size_t i = 0; i < min.size(); i++)
+    extent = std::max(extent, max[i] - min[i]);
+  auto step = extent / (float)((1u << bits) - 1);
+  for (size_t i = 0; i < min.size(); i++) {
+    min[i] -= step;
+    max[i] += step;
+  }
+}
+
+/**
+ * @brief Point the attributes and indices of a compressed primitive to new
+ * accessors without bufferViews, whose counts are those of the Draco mesh.
+ */
+static void rewritePrimitive(PrimitiveRewriter &rewriter,
+                             json::MeshPrimitive &primitive,
+                             const MeshPrimitive &loaded,
+                             DracoEncodedPrimitive &encoded,
+                             int positionBits) {
+  auto count = encoded.vertexCount;
+  primitive.attributes = rewriter.addSources(loaded.sources, count, false);
+  if (positionBits > 0 && loaded.sources.position->componentType ==
+                              json::Accessor::ComponentType::FLOAT) {
+    widenQuantizedBounds(
+        rewriter.json().accessors->at(*primitive.attributes.position),
+        positionBits);
+  }
+
+  json::Accessor indices;
+  indices.componentType = count > std::numeric_limits<uint16_t>::max()
+                              ? json::Accessor::ComponentType::UNSIGNED_INT
+                              : json::Accessor::ComponentType::UNSIGNED_SHORT;
+  indices.count = encoded.indexCount;
+  indices.type = json::Accessor::Type::SCALAR;
+  primitive.indices = rewriter.addAccessor(indices);
+
+  auto &extension = primitive.dracoExtension.emplace(encoded.extension);
+  extension.bufferView = rewriter.addBufferView(std::move(encoded.data));
+}
+
+static void addExtension(json::Json &json, const std::string &name) {
+  auto add = [&name](std::optional<std::vector<std::string>> &names) {
+    if (!names)
+      names.emplace();
+    if (std::find(names->begin(), names->end(), name) == names->end())
+      names->push_back(name);
+  };
+  add(json.extensionsUsed);
+  add(json.extensionsRequired);
+}
+
+GLBWriter DracoEncoder::compress(const GLTFData &data,
+                                 Executor &executor) const {
+  PrimitiveRewriter rewriter(data);
+  auto &json = rewriter.json();
+  // the mesh and primitive indices of the primitives to compress
+  std::vector<std::pair<uint32_t, uint32_t>> indices;
+  std::vector<const MeshPrimitive *> primitives;
+  if (json.meshes) {
+    for (uint32_t i = 0; i < json.meshes->size(); i++) {
+      const auto &mesh = json.meshes->at(i);
+      for (uint32_t j = 0; j < mesh.primitives.size(); j++) {
+        const auto &primitive = data.meshPrimitiveAt(i, j);
+        if (mesh.primitives[j].modeValue() !=
+                json::MeshPrimitive::Mode::TRIANGLES ||
+            !primitive.sources.position)
+          continue;
+        indices.emplace_back(i, j);
+        primitives.push_back(&primitive);
+      }
+    }
+  }
+  auto encoded = encodeAll(primitives, executor);
+
+  for (size_t i = 0; i < encoded.size(); i++) {
+    auto [mesh, primitive] = indices[i];
+    rewritePrimitive(rewriter, json.meshes->at(mesh).primitives[primitive],
+                     *primitives[i], encoded[i],
+                     _options.quantization.position);
+  }
+  if (!encoded.empty())
+    addExtension(json, GLTFExtensionKHRDracoMeshCompression);
+  return rewriter.write();
+}
+
+} // namespace gltf2
@@ -0,0 +1,117 @@
+#include "Executor.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace gltf2 {
+
+namespace {
+
+struct ParallelForState {
+  const std::function<void(size_t)> *fn;
+  size_t count;
+  std::atomic<size_t> next{0};
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t done = 0;
+  std::exception_ptr exception;
+
+  /**
+   * Run calls until none are left. Helpers that start after the last call
+   * was claimed return without touching `fn`, which may be gone by then.
+   */
+  void work() {
+    for (size_t i = next++; i < count; i = next++) {
+      std::exception_ptr e;
+      try {
+        (*fn)(i);
+      } catch (...) {
+        e = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      if (e && !exception)
+        exception = e;
+      if (++done == count)
+        cv.notify_all();
+    }
+  }
+};
+
+} // namespace
+
+void Executor::parallelFor(size_t count,
+                           const std::function<void(size_t)> &fn,
+                           TaskPriority priority) {
+  if (count == 0)
+    return;
+  if (count == 1) {
+    fn(0);
+    return;
+  }
+
+  auto state = std::make_shared<ParallelForState>();
+  state->fn = &fn;
+  state->count = count;
+  auto helpers = std::min(count - 1, concurrency());
+  for (size_t i = 0; i < helpers; i++)
+    submit([state] { state->work(); }, priority);
+  state->work();
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->cv.wait(lock, [&] { return state->done == count; });
+  if (state->exception)
+    std::rethrow_exception(state->exception);
+}
+
+ThreadPoolExecutor::ThreadPoolExecutor(size_t threads) {
+  threads = std::max<size_t>(threads, 1);
+  _threads.reserve(threads);
+  for (size_t i = 0; i < threads; i++)
+    _threads.emplace_back([this] { run(); });
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _cv.notify_all();
+  for (auto &thread : _threads)
+    thread.join();
+}
+
+void ThreadPoolExecutor::submit(std::function<void()> fn,
+                                TaskPriority priority) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _queues[static_cast<size_t>(priority)].push_back(std::move(fn));
+  }
+  _cv.notify_one();
+}
+
+void ThreadPoolExecutor::run() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    auto queue = std::find_if(_queues.rbegin(), _queues.rend(),
+                              [](const auto &queue) { return !queue.empty(); });
+    if (queue == _queues.rend()) {
+      if (_stop)
+        return;
+      _cv.wait(lock);
+      continue;
+    }
+    auto fn = std::move(queue->front());
+    queue->pop_front();
+    lock.unlock();
+    fn();
+    lock.lock();
+  }
+}
+
+Executor &defaultExecutor() {
+  static ThreadPoolExecutor executor;
+  return executor;
+}
+
+} // namespace gltf2
@@ -0,0 +1,255 @@
+#include "GLBWriter.h"
+#include "GLTFException.h"
+#include "GLTFExtension.h"
+#include "JsonEncoder.h"
+#include "nlohmann/json.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define GLTF2_HAS_WRITEV 1
+#endif
+
+namespace gltf2 {
+
+static const uint8_t zeroPadding[64] = {};
+
+static uint64_t alignedOffset(uint64_t offset, uint32_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+static void removeExtension(json::Json &json, const std::string &name) {
+  auto remove = [&name](std::optional<std::vector<std::string>> &names) {
+    if (!names)
+      return;
+    names->erase(std::remove(names->begin(), names->end(), name),
+                 names->end());
+    if (names->empty())
+      names.reset();
+  };
+  remove(json.extensionsUsed);
+  remove(json.extensionsRequired);
+}
+
+GLBWriter::GLBWriter(json::Json json) : _json(std::move(json)) {
+  _json.buffers.reset();
+  _json.bufferViews.reset();
+  // the re-added bufferViews hold plain data
+  removeExtension(_json, GLTFExtensionEXTMeshoptCompression);
+}
+
+uint32_t GLBWriter::addBufferView(const uint8_t *data, uint32_t bytes,
+                                  uint32_t alignment,
+                                  std::optional<uint32_t> byteStride,
+                                  std::optional<uint32_t> target,
+                                  std::optional<std::string> name) {
+  alignment = std::lcm(std::max(alignment, 1u), GLBChunkAlignment);
+
+  // share the range of an identical payload if its offset is aligned enough
+  auto hash = std::hash<std::string_view>()(
+      std::string_view(reinterpret_cast<const char *>(data), bytes));
+  std::optional<uint32_t> offset;
+  auto range = _segmentsByHash.equal_range(hash);
+  for (auto it = range.first; it != range.second; it++) {
+    const auto &segment = _segments[it->second];
+    if (segment.bytes == bytes && segment.offset % alignment == 0 &&
+        (bytes == 0 || std::memcmp(segment.data, data, bytes) == 0)) {
+      offset = segment.offset;
+      break;
+    }
+  }
+
+  if (!offset) {
+    auto begin = alignedOffset(_binLength, alignment);
+    if (begin + bytes > std::numeric_limits<uint32_t>::max()) {
+      throw InputException("BIN chunk exceeds 4 GiB");
+    }
+    offset = static_cast<uint32_t>(begin);
+    _segmentsByHash.emplace(hash, _segments.size());
+    _segments.push_back({data, bytes, *offset});
+    _binLength = *offset + bytes;
+  }
+
+  json::BufferView bufferView;
+  bufferView.buffer = 0;
+  bufferView.byteOffset = *offset;
+  bufferView.byteLength = bytes;
+  bufferView.byteStride = byteStride;
+  bufferView.target = target;
+  bufferView.name = name;
+  _bufferViews.push_back(bufferView);
+  return _bufferViews.size() - 1;
+}
+
+uint32_t GLBWriter::addBufferView(Buffer &&buffer, uint32_t alignment,
+                                  std::optional<uint32_t> byteStride,
+                                  std::optional<uint32_t> target,
+                                  std::optional<std::string> name) {
+  if (buffer.size() > std::numeric_limits<uint32_t>::max()) {
+    throw InputException("BIN chunk exceeds 4 GiB");
+  }
+  const auto &owned = retainBuffer(std::move(buffer));
+  return addBufferView(owned.data(), owned.size(), alignment, byteStride,
+                       target, name);
+}
+
+std::string GLBWriter::encodeJsonChunk() const {
+  auto json = _json;
+  if (!_bufferViews.empty()) {
+    json::Buffer buffer;
+    buffer.byteLength = _binLength;
+    json.buffers = std::vector<json::Buffer>{buffer};
+    json.bufferViews = _bufferViews;
+  }
+  auto chunk = json::JsonEncoder::encode(json).dump();
+  chunk.append(alignedOffset(chunk.size(), GLBChunkAlignment) - chunk.size(),
+               ' ');
+  return chunk;
+}
+
+std::vector<GLBWriter::Chunk> GLBWriter::chunks(const std::string &jsonChunk,
+                                                Heads &heads) const {
+  bool hasBin = !_bufferViews.empty();
+  uint32_t binChunkLength = alignedOffset(_binLength, GLBChunkAlignment);
+
+  uint64_t length = sizeof(GLBHeader) + sizeof(GLBChunkHead) + jsonChunk.size();
+  if (hasBin)
+    length += sizeof(GLBChunkHead) + binChunkLength;
+  if (length > std::numeric_limits<uint32_t>::max()) {
+    throw InputException("GLB file exceeds 4 GiB");
+  }
+
+  heads.header = {GLBHeaderMagic, GLBVersion, static_cast<uint32_t>(length)};
+  heads.json = {static_cast<uint32_t>(jsonChunk.size()), GLBChunkTypeJSON};
+  heads.bin = {binChunkLength, GLBChunkTypeBIN};
+
+  std::vector<Chunk> chunks;
+  chunks.reserve(4 + _segments.size() * 2);
+  auto appendPadding = [&chunks](size_t bytes) {
+    while (bytes > 0) {
+      auto length = std::min(bytes, sizeof(zeroPadding));
+      chunks.push_back({zeroPadding, length});
+      bytes -= length;
+    }
+  };
+  chunks.push_back({reinterpret_cast<const uint8_t *>(&heads.header),
+                    sizeof(GLBHeader)});
+  chunks.push_back({reinterpret_cast<const uint8_t *>(&heads.json),
+                    sizeof(GLBChunkHead)});
+  chunks.push_back(
+      {reinterpret_cast<const uint8_t *>(jsonChunk.data()), jsonChunk.size()});
+  if (hasBin) {
+    chunks.push_back({reinterpret_cast<const uint8_t *>(&heads.bin),
+                      sizeof(GLBChunkHead)});
+    uint32_t cursor = 0;
+    for (const auto &segment : _segments) {
+      appendPadding(segment.offset - cursor);
+      if (segment.bytes > 0)
+        chunks.push_back({segment.data, segment.bytes});
+      cursor = segment.offset + segment.bytes;
+    }
+    appendPadding(binChunkLength - cursor);
+  }
+  return chunks;
+}
+
+void GLBWriter::write(std::ostream &os) const {
+  Heads heads;
+  auto jsonChunk = encodeJsonChunk();
+  for (const auto &chunk : chunks(jsonChunk, heads)) {
+    os.write(reinterpret_cast<const char *>(chunk.data), chunk.bytes);
+  }
+  if (!os) {
+    throw InputException("Failed to write glb data");
+  }
+}
+
+#ifdef GLTF2_HAS_WRITEV
+
+static void writeAll(int fd, std::vector<iovec> &iov) {
+  size_t head = 0;
+  while (head < iov.size()) {
+    auto count = static_cast<int>(std::min<size_t>(iov.size() - head, IOV_MAX));
+    auto written = ::writev(fd, &iov[head], count);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      throw InputException("Failed to write file");
+    }
+    // skip fully written vectors and advance into a partially written one
+    auto remaining = static_cast<size_t>(written);
+    while (head < iov.size() && remaining >= iov[head].iov_len) {
+      remaining -= iov[head].iov_len;
+      head++;
+    }
+    if (remaining > 0) {
+      iov[head].iov_base = static_cast<char *>(iov[head].iov_base) + remaining;
+      iov[head].iov_len -= remaining;
+    }
+  }
+}
+
+void GLBWriter::write(const std::filesystem::path &path) const {
+  Heads heads;
+  auto jsonChunk = encodeJsonChunk();
+  auto chunks = this->chunks(jsonChunk, heads);
+
+  std::vector<iovec> iov;
+  iov.reserve(chunks.size());
+  for (const auto &chunk : chunks) {
+    iov.push_back({const_cast<uint8_t *>(chunk.data), chunk.bytes});
+  }
+
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw InputException("Failed to open file");
+  }
+  try {
+    writeAll(fd, iov);
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  if (::close(fd) != 0) {
+    throw InputException("Failed to write file");
+  }
+}
+
+#else
+
+void GLBWriter::write(const std::filesystem::path &path) const {
+  std::ofstream fs(path, std::ios::binary | std::ios::trunc);
+  if (!fs)
+    throw InputException("Failed to open file");
+  write(fs);
+}
+
+#endif
+
+GLBWriter GLBWriter::fromData(const GLTFData &data) {
+  GLBWriter writer(data.json());
+  if (!data.json().bufferViews)
+    return writer;
+
+  const auto &bufferViews = *data.json().bufferViews;
+  for (uint32_t i = 0; i < bufferViews.size(); i++) {
+    const auto &bufferView = bufferViews[i];
+    const auto &payload = data.bufferViewAt(i);
+    writer.addBufferView(payload.data, payload.bytes, GLBChunkAlignment,
+                         bufferView.byteStride, bufferView.target,
+                         bufferView.name);
+  }
+  return writer;
+}
+
+} // namespace gltf2
@@ -1,90 +1,159 @@
+#include "AccessorConversion.h"
+#include "DracoDecoder.h"
 #include "GLTFData.h"
 #include "GLTFException.h"
 #include "GLTFExtension.h"
 #include "JsonDecoder.h"
+#include "MeshPrimitiveHelpers.h"
+#include "MeshOptimizer.h"
+#include "MeshoptDecoder.h"
+#include "VertexWelder.h"
 #include "boost/url.hpp"
 #include "cppcodec/base64_rfc4648.hpp"
-#include "draco/compression/decode.h"
-#include "draco/core/decoder_buffer.h"
 #include "nlohmann/json.hpp"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
 
 namespace gltf2 {
 
-static void waitFutures(std::vector<std::future<void>> &futures) {
-  for (auto &future : futures) {
-    future.get();
-  }
+using Phase = LoadStatsRecorder::Phase;
+
+std::future<void> GLTFData::eagerLoad() {
+  return submit([this] {
+    clear();
+    checkMemoryBudget();
+
+    loadPhase(LoadPhase::Buffers);
+    loadPhase(LoadPhase::BufferViews); // depends buffer
+
+    executor().parallelFor(2, [this](size_t i) {
+      loadPhase(i == 0 ? LoadPhase::AccessorBuffers : LoadPhase::ImageBuffers);
+    });
+
+    loadPhase(LoadPhase::MeshPrimitives); // depends accessor
+  });
 }
 
-static float normalize(const void *bytes, int index,
-                       json::Accessor::ComponentType compType) {
-  switch (compType) {
-  case json::Accessor::ComponentType::BYTE: {
-    int8_t value = *((int8_t *)bytes + index);
-    float f = (float)value;
-    return f > 0 ? f / (float)INT8_MAX : f / (float)INT8_MIN;
-  }
-  case json::Accessor::ComponentType::UNSIGNED_BYTE: {
-    uint8_t value = *((uint8_t *)bytes + index);
-    float f = (float)value;
-    return f / (float)UINT8_MAX;
-  }
-  case json::Accessor::ComponentType::SHORT: {
-    int16_t value = *((int16_t *)bytes + index);
-    float f = (float)value;
-    return f > 0 ? f / (float)INT16_MAX : f / (float)INT16_MIN;
-  }
-  case json::Accessor::ComponentType::UNSIGNED_SHORT: {
-    uint16_t value = *((uint16_t *)bytes + index);
-    float f = (float)value;
-    return f / (float)UINT16_MAX;
-  }
-  case json::Accessor::ComponentType::UNSIGNED_INT: {
-    uint32_t value = *((uint32_t *)bytes + index);
-    float f = (float)value;
-    return f / (float)UINT32_MAX;
-  }
-  case json::Accessor::ComponentType::FLOAT: {
-    return *((float *)bytes + index);
+std::future<void> GLTFData::loadBuffers() {
+  return submit([this] { loadPhase(LoadPhase::Buffers); });
+}
+
+std::future<void> GLTFData::loadBufferViews() {
+  return submit([this] { loadPhase(LoadPhase::BufferViews); });
+}
+
+std::future<void> GLTFData::loadAccessorBuffers() {
+  return submit([this] { loadPhase(LoadPhase::AccessorBuffers); });
+}
+
+std::future<void> GLTFData::loadImageBuffers() {
+  return submit([this] { loadPhase(LoadPhase::ImageBuffers); });
+}
+
+std::future<void> GLTFData::loadMeshPrimitives() {
+  return submit([this] { loadPhase(LoadPhase::MeshPrimitives); });
+}
+
+template <typename T, typename Results>
+void GLTFData::loadEach(Phase phase, const char *name,
+                        const std::optional<std::vector<T>> &items,
+                        Results &results,
+                        void (GLTFData::*loadAt)(uint32_t)) {
+  LoadStatsRecorder::WallScope scope(*_stats, phase);
+  TraceScope trace(_options.tracer.get(), name);
+  if (!items.has_value())
+    return;
+
+  results.resize(items->size());
+  forEach(phase, items->size(),
+          [this, loadAt](uint32_t index) { (this->*loadAt)(index); });
+}
+
+void GLTFData::loadPhase(LoadPhase phase) {
+  switch (phase) {
+  case LoadPhase::Buffers:
+    loadEach(Phase::Buffers, "loadBuffers", json().buffers, _buffers,
+             &GLTFData::loadBufferAt);
+    break;
+  case LoadPhase::BufferViews:
+    loadEach(Phase::BufferViews, "loadBufferViews", json().bufferViews,
+             _bufferViews, &GLTFData::loadBufferViewAt);
+    break;
+  case LoadPhase::AccessorBuffers: {
+    LoadStatsRecorder::WallScope scope(*_stats, Phase::AccessorBuffers);
+    TraceScope trace(_options.tracer.get(), "loadAccessorBuffers");
+    if (!json().accessors)
+      break;
+    _accessorBuffers.resize(json().accessors->size());
+    if (_options.keepQuantizedAttributes)
+      _quantizedAccessors = quantizedAccessors();
+    else
+      _quantizedAccessors.clear();
+    // accessors interleaved in one bufferView are split in one pass
+    auto groups = accessorGroups();
+    forEach(Phase::AccessorBuffers, groups.size(), [&](uint32_t i) {
+      if (groups[i].size() == 1)
+        loadAccessorBufferAt(groups[i][0]);
+      else
+        deinterleaveAccessorBuffersAt(groups[i]);
+    });
+    break;
   }
+  case LoadPhase::ImageBuffers:
+    loadEach(Phase::ImageBuffers, "loadImageBuffers", json().images,
+             _imageBuffers, &GLTFData::loadImageBufferAt);
+    break;
+  case LoadPhase::MeshPrimitives:
+    decodeDracoMeshes();
+    loadEach(Phase::MeshPrimitives, "loadMeshPrimitives", json().meshes,
+             _meshPrimitives, &GLTFData::loadMeshPrimitiveAtMesh);
+    _dracoMeshes.clear();
+    break;
   }
 }
 
-static Buffer normalizeBuffer(const Buffer &binary,
-                              const json::Accessor &accessor) {
-  auto compCount = json::Accessor::componentsCountOfType(accessor.type);
-  auto length = sizeof(float) * compCount * accessor.count;
-  std::vector<float> values(compCount * accessor.count);
-  for (int i = 0; i < accessor.count; i++) {
-    for (int j = 0; j < compCount; j++) {
-      int index = i * compCount + j;
-      float value = normalize(binary.data(), index, accessor.componentType);
-      values[index] = value;
-    }
+void GLTFData::checkMemoryBudget() const {
+  if (!_options.memoryBudget)
+    return;
+  auto estimate = estimateMemory().total();
+  if (estimate > *_options.memoryBudget) {
+    throw MemoryBudgetException(format(
+        "the document needs an estimated %llu bytes, the budget is %llu",
+        (unsigned long long)estimate,
+        (unsigned long long)*_options.memoryBudget));
   }
-  Buffer res(length);
-  std::memcpy(res.data(), values.data(), length);
-  return res;
 }
 
-std::future<void> GLTFData::eagerLoad() {
-  return std::async(std::launch::async, [this] {
-    clear();
-
-    loadBuffers().get();
-    loadBufferViews().get(); // depends buffer
+template <typename T>
+static bool isLoadedEach(size_t count,
+                         const std::vector<std::unique_ptr<T>> &results) {
+  return results.size() == count &&
+         std::all_of(results.begin(), results.end(),
+                     [](const auto &result) { return result != nullptr; });
+}
 
-    std::vector<std::future<void>> futures;
-    futures.push_back(loadAccessorBuffers());
-    futures.push_back(loadImageBuffers());
-    waitFutures(futures);
+template <typename T>
+static size_t countOf(const std::optional<std::vector<T>> &items) {
+  return items ? items->size() : 0;
+}
 
-    loadMeshPrimitives().get(); // depends accessor
-  });
+bool GLTFData::isLoaded() const {
+  if (!isLoadedEach(countOf(json().buffers), _buffers) ||
+      !isLoadedEach(countOf(json().bufferViews), _bufferViews) ||
+      !isLoadedEach(countOf(json().accessors), _accessorBuffers) ||
+      !isLoadedEach(countOf(json().images), _imageBuffers) ||
+      _meshPrimitives.size() != countOf(json().meshes))
+    return false;
+  for (size_t i = 0; i < _meshPrimitives.size(); i++) {
+    if (!isLoadedEach(json().meshes->at(i).primitives.size(),
+                      _meshPrimitives[i]))
+      return false;
+  }
+  return true;
 }
 
 void GLTFData::clear() {
@@ -93,349 +162,563 @@ void GLTFData::clear() {
   _accessorBuffers.clear();
   _imageBuffers.clear();
   _meshPrimitives.clear();
+  _dracoMeshes.clear();
+  _stats->reset();
+  _memory->reset();
 }
 
-std::future<void> GLTFData::loadBuffers() {
-  return std::async(std::launch::async, [this] {
-    if (!json().buffers.has_value())
-      return;
-
-    auto count = json().buffers->size();
-    _buffers.resize(count);
-
-    std::vector<std::future<void>> futures;
-    futures.reserve(count);
+Executor &GLTFData::executor() const {
+  return _options.executor ? *_options.executor : defaultExecutor();
+}
 
-    for (uint32_t i = 0; i < count; i++) {
-      futures.push_back(loadBufferAt(i));
+std::future<void> GLTFData::submit(std::function<void()> fn) const {
+  auto promise = std::make_shared<std::promise<void>>();
+  auto future = promise->get_future();
+  executor().submit([promise, fn = std::move(fn)] {
+    try {
+      fn();
+      promise->set_value();
+    } catch (...) {
+      promise->set_exception(std::current_exception());
     }
-    waitFutures(futures);
   });
+  return future;
 }
 
-std::future<void> GLTFData::loadBufferAt(uint32_t index) {
-  return std::async(std::launch::async, [this, index] {
-    _buffers[index] = std::make_unique<Buffer>(_file.getBuffer(index));
+void GLTFData::forEach(Phase phase, size_t count,
+                       const std::function<void(uint32_t)> &fn) const {
+  executor().parallelFor(count, [this, phase, &fn](size_t i) {
+    LoadStatsRecorder::CpuScope scope(*_stats, phase);
+    fn((uint32_t)i);
   });
 }
 
-std::future<void> GLTFData::loadBufferViews() {
-  return std::async(std::launch::async, [this] {
-    if (!json().bufferViews.has_value())
-      return;
+LoadStats GLTFData::stats() const {
+  auto stats = _stats->stats();
+  stats.parse = _file.stats().parse;
+  stats.bytesFromFiles += _file.stats().bytesFromFiles;
+  return stats;
+}
 
-    auto count = json().bufferViews->size();
-    _bufferViews.resize(count);
+static bool isDataUri(const std::string &uri) {
+  return uri.rfind("data:", 0) == 0;
+}
 
-    std::vector<std::future<void>> futures;
-    futures.reserve(count);
+static uint64_t bytesOfSources(const MeshPrimitiveSources &sources) {
+  uint64_t bytes = 0;
+  for (const auto &source :
+       {sources.position, sources.normal, sources.tangent}) {
+    if (source)
+      bytes += source->buffer.size();
+  }
+  for (const auto *array : {&sources.texcoords, &sources.colors,
+                            &sources.joints, &sources.weights}) {
+    for (const auto &source : *array)
+      bytes += source.buffer.size();
+  }
+  return bytes;
+}
 
-    for (uint32_t i = 0; i < count; i++) {
-      futures.push_back(loadBufferViewAt(i));
-    }
-    waitFutures(futures);
-  });
+void GLTFData::loadBufferAt(uint32_t index) {
+  TraceScope trace(_options.tracer.get(), "loadBufferAt", index);
+  const auto &buffer = json().buffers->at(index);
+  _memory->reserve(buffer.byteLength, "buffer");
+  if (buffer.isMeshoptFallback()) {
+    // the compressed bufferViews are decoded into it by loadBufferViewAt
+    _buffers[index] = std::make_unique<Buffer>(buffer.byteLength);
+    _stats->add(LoadStatsRecorder::Bytes::Buffers, buffer.byteLength);
+    return;
+  }
+  _buffers[index] = std::make_unique<Buffer>(_file.getBuffer(buffer));
+  auto bytes = _buffers[index]->size();
+  trace.setBytes(bytes);
+  _stats->add(LoadStatsRecorder::Bytes::Buffers, bytes);
+  if (buffer.uri) {
+    _stats->add(isDataUri(*buffer.uri)
+                    ? LoadStatsRecorder::Bytes::FromDataUris
+                    : LoadStatsRecorder::Bytes::FromFiles,
+                bytes);
+  }
 }
 
-std::future<void> GLTFData::loadBufferViewAt(uint32_t index) {
+void GLTFData::loadBufferViewAt(uint32_t index) {
   const auto &bufferView = json().bufferViews->at(index);
-  return std::async(std::launch::async, [this, index, &bufferView] {
-    uint8_t *begin = (uint8_t *)_buffers[bufferView.buffer]->data() +
-                     bufferView.byteOffset.value_or(0);
-    _bufferViews[index] =
-        std::make_unique<BufferView>(begin, bufferView.byteLength);
-  });
+  TraceScope trace(_options.tracer.get(), "loadBufferViewAt", index);
+  trace.setBytes(bufferView.byteLength);
+  const auto &buffer = *_buffers[bufferView.buffer];
+  if ((uint64_t)bufferView.byteOffset.value_or(0) + bufferView.byteLength >
+      buffer.size()) {
+    throw InvalidFormatException(
+        format("bufferView %u is out of the range of buffer %u", index,
+               bufferView.buffer));
+  }
+  uint8_t *begin = (uint8_t *)_buffers[bufferView.buffer]->data() +
+                   bufferView.byteOffset.value_or(0);
+  if (bufferView.meshoptExtension)
+    decodeMeshoptBufferViewAt(index, begin);
+  _bufferViews[index] =
+      std::make_unique<BufferView>(begin, bufferView.byteLength);
 }
 
-std::future<void> GLTFData::loadAccessorBuffers() {
-  return std::async(std::launch::async, [this] {
-    if (!json().accessors.has_value())
-      return;
+void GLTFData::decodeMeshoptBufferViewAt(uint32_t index, uint8_t *dst) {
+  const auto &bufferView = json().bufferViews->at(index);
+  const auto &extension = *bufferView.meshoptExtension;
+  TraceScope trace(_options.tracer.get(), "decodeMeshoptBufferView", index);
+  trace.setBytes(extension.byteLength);
+  if (extension.buffer >= _buffers.size()) {
+    throw InvalidFormatException(
+        format("buffer index %u out of range", extension.buffer));
+  }
+  decodeMeshoptBufferView(bufferView, index, *_buffers[extension.buffer],
+                          dst);
+  _stats->increment(LoadStatsRecorder::Count::MeshoptBufferViews);
+}
 
-    auto count = json().accessors->size();
-    _accessorBuffers.resize(count);
+static uint32_t elementSizeOfAccessor(const json::Accessor &accessor) {
+  return json::Accessor::sizeOfComponentType(accessor.componentType) *
+         json::Accessor::componentsCountOfType(accessor.type);
+}
 
-    std::vector<std::future<void>> futures;
-    futures.reserve(count);
+static bool isNormalizedToFloat(const json::Accessor &accessor) {
+  return accessor.normalized.value_or(false) &&
+         accessor.componentType != json::Accessor::ComponentType::FLOAT &&
+         accessor.componentType != json::Accessor::ComponentType::UNSIGNED_INT;
+}
 
-    for (uint32_t i = 0; i < count; i++) {
-      futures.push_back(loadAccessorBufferAt(i));
+void GLTFData::reserveAccessorAt(uint32_t index) {
+  const auto &accessor = json().accessors->at(index);
+  auto typeSize = elementSizeOfAccessor(accessor);
+  if (accessor.bufferView.has_value() && accessor.count > 0) {
+    const auto &bufferView = json().bufferViews->at(*accessor.bufferView);
+    auto byteStride = bufferView.byteStride.value_or(typeSize);
+    if ((uint64_t)accessor.byteOffset.value_or(0) +
+            (uint64_t)byteStride * (accessor.count - 1) + typeSize >
+        bufferView.byteLength) {
+      throw InvalidFormatException(
+          format("accessor %u is out of the range of bufferView %u", index,
+                 *accessor.bufferView));
     }
-    waitFutures(futures);
-  });
+  }
+  if (accessor.sparse) {
+    const auto &sparse = *accessor.sparse;
+    auto indexSize = json::Accessor::sizeOfComponentType(
+        (json::Accessor::ComponentType)sparse.indices.componentType);
+    if ((uint64_t)sparse.indices.byteOffset.value_or(0) +
+                (uint64_t)indexSize * sparse.count >
+            json().bufferViews->at(sparse.indices.bufferView).byteLength ||
+        (uint64_t)sparse.values.byteOffset.value_or(0) +
+                (uint64_t)typeSize * sparse.count >
+            json().bufferViews->at(sparse.values.bufferView).byteLength) {
+      throw InvalidFormatException(format(
+          "sparse accessor %u is out of the range of its bufferViews",
+          index));
+    }
+  }
+  if (keepsSparseAt(index)) {
+    _memory->reserve((uint64_t)(sizeof(uint32_t) + typeSize) *
+                         accessor.sparse->count,
+                     "sparse accessor");
+  } else if (isNormalizedToFloat(accessor) && !normalizesAccessorAt(index)) {
+    _memory->reserve((uint64_t)typeSize * accessor.count, "accessor");
+  } else {
+    _memory->reserve(accessorMemory(accessor), "accessor");
+  }
 }
 
-std::future<void> GLTFData::loadAccessorBufferAt(uint32_t index) {
-  const auto &accessor = json().accessors->at(index);
-  return std::async(std::launch::async, [this, index, &accessor] {
-    auto compTypeSize =
-        json::Accessor::sizeOfComponentType(accessor.componentType);
-    auto compCount = json::Accessor::componentsCountOfType(accessor.type);
-    auto typeSize = compTypeSize * compCount;
-    auto length = typeSize * accessor.count;
-    Buffer binary(length);
-    bool normalized = false;
-
-    // fill data
-    if (accessor.bufferView.has_value()) {
-      const auto &bufferView = json().bufferViews->at(*accessor.bufferView);
-      const char *dstBase = (const char *)binary.data();
-      const char *srcBase =
-          (const char *)_bufferViews[*accessor.bufferView]->data +
-          accessor.byteOffset.value_or(0);
-      auto byteStride = bufferView.byteStride.value_or(typeSize);
-      if (byteStride != typeSize) {
-        // copy with byteStride
-        for (int i = 0; i < accessor.count; i++) {
-          const char *dst = dstBase + i * typeSize;
-          const char *src = srcBase + i * byteStride;
-          std::memcpy((void *)dst, src, typeSize);
+bool GLTFData::normalizesAccessorAt(uint32_t index) const {
+  return isNormalizedToFloat(json().accessors->at(index)) &&
+         !(index < _quantizedAccessors.size() && _quantizedAccessors[index]);
+}
+
+bool GLTFData::keepsSparseAt(uint32_t index) const {
+  return _options.keepSparseAccessors && json().accessors->at(index).sparse &&
+         !normalizesAccessorAt(index);
+}
+
+std::vector<bool> GLTFData::quantizedAccessors() const {
+  std::vector<bool> quantized(json().accessors->size());
+  auto add = [&](const std::optional<uint32_t> &accessor) {
+    if (accessor && *accessor < quantized.size())
+      quantized[*accessor] = true;
+  };
+  if (!json().meshes)
+    return quantized;
+  for (const auto &mesh : *json().meshes) {
+    for (const auto &primitive : mesh.primitives) {
+      if (primitive.dracoExtension)
+        continue;
+      const auto &attributes = primitive.attributes;
+      add(attributes.position);
+      add(attributes.normal);
+      add(attributes.tangent);
+      if (attributes.texcoords) {
+        for (auto texcoord : *attributes.texcoords)
+          add(texcoord);
+      }
+      if (primitive.targets) {
+        for (const auto &target : *primitive.targets) {
+          add(target.position);
+          add(target.normal);
+          add(target.tangent);
         }
-      } else {
-        // copy all
-        std::memcpy((void *)dstBase, srcBase, length);
       }
     }
+  }
+  return quantized;
+}
 
-    // sparse
-    if (accessor.sparse) {
-      const auto &sparse = *accessor.sparse;
-      const auto indices = indicesForAccessorSparse(sparse);
-      const auto valuesData = _bufferViews[sparse.values.bufferView]->data +
-                              sparse.values.byteOffset.value_or(0);
-      const char *dstBase = (const char *)binary.data();
-      const char *srcBase = (const char *)valuesData;
-      for (int i = 0; i < sparse.count; i++) {
-        auto index = indices[i];
-        const char *dst = dstBase + typeSize * index;
-        const char *src = srcBase + typeSize * i;
-        std::memcpy((void *)dst, src, typeSize);
+std::vector<std::vector<uint32_t>> GLTFData::accessorGroups() const {
+  std::vector<std::vector<uint32_t>> groups;
+  // interleaved accessors by bufferView and count
+  std::map<std::pair<uint32_t, uint32_t>, size_t> interleaved;
+  for (uint32_t i = 0; i < json().accessors->size(); i++) {
+    const auto &accessor = json().accessors->at(i);
+    if (accessor.bufferView && !accessor.sparse &&
+        !normalizesAccessorAt(i) && accessor.count > 0) {
+      const auto &bufferView = json().bufferViews->at(*accessor.bufferView);
+      auto typeSize = elementSizeOfAccessor(accessor);
+      if (bufferView.byteStride.value_or(typeSize) > typeSize) {
+        auto key = std::make_pair(*accessor.bufferView, accessor.count);
+        auto it = interleaved.find(key);
+        if (it != interleaved.end()) {
+          groups[it->second].push_back(i);
+          continue;
+        }
+        interleaved.emplace(key, groups.size());
       }
     }
+    groups.push_back({i});
+  }
+  return groups;
+}
 
-    // normalize
-    if (accessor.normalized.value_or(false) &&
-        accessor.componentType != json::Accessor::ComponentType::FLOAT &&
-        accessor.componentType != json::Accessor::ComponentType::UNSIGNED_INT) {
-      binary = normalizeBuffer(binary, accessor);
-      normalized = true;
-    }
+void GLTFData::deinterleaveAccessorBuffersAt(
+    const std::vector<uint32_t> &indices) {
+  const auto &first = json().accessors->at(indices.front());
+  auto bufferViewIndex = *first.bufferView;
+  TraceScope trace(_options.tracer.get(), "deinterleaveAccessorBuffers",
+                   bufferViewIndex);
+  for (auto index : indices)
+    reserveAccessorAt(index);
+
+  std::vector<Buffer> binaries(indices.size());
+  std::vector<InterleavedElement> elements(indices.size());
+  for (size_t i = 0; i < indices.size(); i++) {
+    const auto &accessor = json().accessors->at(indices[i]);
+    auto typeSize = elementSizeOfAccessor(accessor);
+    binaries[i].resize((size_t)typeSize * accessor.count);
+    elements[i] = {accessor.byteOffset.value_or(0), typeSize,
+                   binaries[i].data()};
+  }
+  deinterleave(_bufferViews[bufferViewIndex]->data,
+               *json().bufferViews->at(bufferViewIndex).byteStride,
+               first.count, elements);
+
+  uint64_t bytes = 0;
+  for (size_t i = 0; i < indices.size(); i++) {
+    bytes += binaries[i].size();
+    _accessorBuffers[indices[i]] =
+        std::make_unique<AccessorBuffer>(std::move(binaries[i]), false);
+  }
+  _stats->add(LoadStatsRecorder::Bytes::Accessors, bytes);
+  trace.setBytes(bytes);
+}
 
+void GLTFData::loadAccessorBufferAt(uint32_t index) {
+  const auto &accessor = json().accessors->at(index);
+  TraceScope trace(_options.tracer.get(), "loadAccessorBufferAt", index);
+  auto compCount = json::Accessor::componentsCountOfType(accessor.type);
+  auto typeSize = elementSizeOfAccessor(accessor);
+  auto length = (uint64_t)typeSize * accessor.count;
+  reserveAccessorAt(index);
+
+  bool normalize = normalizesAccessorAt(index);
+
+  // gather and normalize in one pass
+  if (normalize && accessor.bufferView.has_value() && !accessor.sparse) {
+    const auto &bufferView = json().bufferViews->at(*accessor.bufferView);
+    Buffer binary(sizeof(float) * compCount * accessor.count);
+    convertAccessor(_bufferViews[*accessor.bufferView]->data +
+                        accessor.byteOffset.value_or(0),
+                    bufferView.byteStride.value_or(typeSize), accessor,
+                    (float *)binary.data(), true);
+    _stats->increment(LoadStatsRecorder::Count::NormalizedAccessors);
+    _stats->add(LoadStatsRecorder::Bytes::Accessors, binary.size());
+    trace.setBytes(binary.size());
     _accessorBuffers[index] =
-        std::make_unique<AccessorBuffer>(binary, normalized);
-  });
-}
+        std::make_unique<AccessorBuffer>(std::move(binary), true);
+    return;
+  }
 
-std::future<void> GLTFData::loadImageBuffers() {
-  return std::async(std::launch::async, [this] {
-    if (!json().images.has_value())
+  // a sparse accessor is its base with the values scattered over it
+  Buffer binary;
+  if (accessor.sparse) {
+    _stats->increment(LoadStatsRecorder::Count::SparseAccessors);
+    auto sparse = sparseAccessorBufferAt(index);
+    if (keepsSparseAt(index)) {
+      auto bytes =
+          sparse.values.size() + sparse.indices.size() * sizeof(uint32_t);
+      _stats->add(LoadStatsRecorder::Bytes::Accessors, bytes);
+      trace.setBytes(bytes);
+      _accessorBuffers[index] = std::make_unique<AccessorBuffer>(
+          std::make_shared<const SparseAccessorBuffer>(std::move(sparse)));
       return;
+    }
+    binary = sparse.toBuffer();
+  } else {
+    binary.resize(length);
+    if (accessor.bufferView.has_value()) {
+      const auto &bufferView = json().bufferViews->at(*accessor.bufferView);
+      gatherElements(_bufferViews[*accessor.bufferView]->data +
+                         accessor.byteOffset.value_or(0),
+                     bufferView.byteStride.value_or(typeSize), typeSize,
+                     accessor.count, binary.data());
+    }
+  }
 
-    auto count = json().images->size();
-    _imageBuffers.resize(count);
+  // normalize
+  if (normalize) {
+    binary = normalizeBuffer(binary, accessor);
+    _stats->increment(LoadStatsRecorder::Count::NormalizedAccessors);
+  }
 
-    std::vector<std::future<void>> futures;
-    futures.reserve(count);
+  _stats->add(LoadStatsRecorder::Bytes::Accessors, binary.size());
+  trace.setBytes(binary.size());
 
-    for (uint32_t i = 0; i < count; i++) {
-      futures.push_back(loadImageBufferAt(i));
-    }
-    waitFutures(futures);
-  });
+  _accessorBuffers[index] =
+      std::make_unique<AccessorBuffer>(std::move(binary), normalize);
 }
 
-std::future<void> GLTFData::loadImageBufferAt(uint32_t index) {
+void GLTFData::loadImageBufferAt(uint32_t index) {
   const auto &image = json().images->at(index);
-  return std::async(std::launch::async, [this, index, &image] {
-    if (image.uri.has_value()) {
-      _imageBuffers[index] =
-          std::make_unique<Buffer>(_file.bufferFromUri(*image.uri));
-    } else {
-      _imageBuffers[index] = std::make_unique<Buffer>(
-          _bufferViews[image.bufferView.value_or(0)]->toBuffer());
-    }
-  });
+  TraceScope trace(_options.tracer.get(), "loadImageBufferAt", index);
+  if (image.uri.has_value()) {
+    // the size of an image file is only known once it has been read
+    auto buffer = _file.bufferFromUri(*image.uri);
+    _memory->reserve(buffer.size(), "image");
+    _imageBuffers[index] = std::make_unique<Buffer>(std::move(buffer));
+    _stats->add(isDataUri(*image.uri)
+                    ? LoadStatsRecorder::Bytes::FromDataUris
+                    : LoadStatsRecorder::Bytes::FromFiles,
+                _imageBuffers[index]->size());
+  } else {
+    const auto &bufferView = *_bufferViews[image.bufferView.value_or(0)];
+    _memory->reserve(bufferView.bytes, "image");
+    _imageBuffers[index] = std::make_unique<Buffer>(bufferView.toBuffer());
+  }
+  _stats->add(LoadStatsRecorder::Bytes::Images,
+              _imageBuffers[index]->size());
+  trace.setBytes(_imageBuffers[index]->size());
 }
 
 std::vector<uint32_t>
 GLTFData::indicesForAccessorSparse(const json::AccessorSparse &sparse) const {
-  std::vector<uint32_t> data(sparse.count);
+  std::vector<uint32_t> indices(sparse.count);
   const uint8_t *ptr = _bufferViews[sparse.indices.bufferView]->data +
                        sparse.indices.byteOffset.value_or(0);
-  for (int i = 0; i < sparse.count; i++) {
-    switch (sparse.indices.componentType) {
-    case json::AccessorSparseIndices::ComponentType::UNSIGNED_BYTE:
-      data.push_back(*ptr);
-      ptr += sizeof(uint8_t);
-      break;
+  switch (sparse.indices.componentType) {
+  case json::AccessorSparseIndices::ComponentType::UNSIGNED_BYTE:
+    convertAccessor<uint8_t, uint32_t, 1>(ptr, sizeof(uint8_t), sparse.count,
+                                          indices.data());
+    break;
+  case json::AccessorSparseIndices::ComponentType::UNSIGNED_SHORT:
+    convertAccessor<uint16_t, uint32_t, 1>(ptr, sizeof(uint16_t),
+                                           sparse.count, indices.data());
+    break;
+  case json::AccessorSparseIndices::ComponentType::UNSIGNED_INT:
+    std::memcpy(indices.data(), ptr, sizeof(uint32_t) * sparse.count);
+    break;
+  }
+  return indices;
+}
 
-    case json::AccessorSparseIndices::ComponentType::UNSIGNED_SHORT:
-      data.push_back(*reinterpret_cast<const uint16_t *>(ptr));
-      ptr += sizeof(uint16_t);
-      break;
+SparseAccessorBuffer GLTFData::sparseAccessorBufferAt(uint32_t index) const {
+  const auto &accessor = json().accessors->at(index);
+  const auto &sparse = *accessor.sparse;
+  SparseAccessorBuffer res;
+  res.count = accessor.count;
+  res.elementSize = elementSizeOfAccessor(accessor);
+  if (accessor.bufferView) {
+    res.base = _bufferViews[*accessor.bufferView]->data +
+               accessor.byteOffset.value_or(0);
+    res.baseStride = json()
+                         .bufferViews->at(*accessor.bufferView)
+                         .byteStride.value_or(res.elementSize);
+  }
 
-    case json::AccessorSparseIndices::ComponentType::UNSIGNED_INT:
-      data.push_back(*reinterpret_cast<const uint32_t *>(ptr));
-      ptr += sizeof(uint32_t);
-      break;
+  res.indices = indicesForAccessorSparse(sparse);
+  for (auto i : res.indices) {
+    if (i >= accessor.count) {
+      throw InvalidFormatException(
+          format("sparse index %u is out of the range of accessor", i));
+    }
+  }
+  const uint8_t *values = _bufferViews[sparse.values.bufferView]->data +
+                          sparse.values.byteOffset.value_or(0);
+  if (std::is_sorted(res.indices.begin(), res.indices.end())) {
+    res.values.assign(values, values + (size_t)res.elementSize * sparse.count);
+  } else {
+    // the spec requires increasing indices; sort them with their values
+    std::vector<uint32_t> order(sparse.count);
+    for (uint32_t i = 0; i < sparse.count; i++)
+      order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) {
+      return res.indices[a] < res.indices[b];
+    });
+    std::vector<uint32_t> indices(sparse.count);
+    res.values.resize((size_t)res.elementSize * sparse.count);
+    for (uint32_t i = 0; i < sparse.count; i++) {
+      indices[i] = res.indices[order[i]];
+      std::memcpy(res.values.data() + (size_t)res.elementSize * i,
+                  values + (size_t)res.elementSize * order[i],
+                  res.elementSize);
     }
+    res.indices = std::move(indices);
   }
-  return data;
+  return res;
 }
 
-std::future<void> GLTFData::loadMeshPrimitives() {
-  return std::async(std::launch::async, [this] {
-    if (!json().meshes.has_value())
-      return;
-
-    auto meshCount = json().meshes->size();
-    _meshPrimitives.resize(meshCount);
+float MeshPrimitiveSource::dequantizationScale() const {
+  if (!normalized)
+    return 1.0f;
+  switch (componentType) {
+  case json::Accessor::ComponentType::BYTE:
+    return 1.0f / INT8_MAX;
+  case json::Accessor::ComponentType::UNSIGNED_BYTE:
+    return 1.0f / UINT8_MAX;
+  case json::Accessor::ComponentType::SHORT:
+    return 1.0f / INT16_MAX;
+  case json::Accessor::ComponentType::UNSIGNED_SHORT:
+    return 1.0f / UINT16_MAX;
+  case json::Accessor::ComponentType::UNSIGNED_INT:
+    return 1.0f / UINT32_MAX;
+  case json::Accessor::ComponentType::FLOAT:
+    return 1.0f;
+  }
+  return 1.0f;
+}
 
-    std::vector<std::future<void>> meshFutures;
-    meshFutures.reserve(meshCount);
+Buffer MeshPrimitiveSource::toFloatBuffer() const {
+  if (componentType == json::Accessor::ComponentType::FLOAT && !sparse)
+    return buffer;
+  const auto dense = sparse ? sparse->toBuffer() : Buffer();
+  const auto &src = sparse ? dense : buffer;
+  auto elementSize = json::Accessor::sizeOfComponentType(componentType) *
+                     componentsPerVector;
+  Buffer res(sizeof(float) * componentsPerVector * vectorCount);
+  accessorConverter<float>(componentType,
+                           typeOfComponents(componentsPerVector),
+                           normalized)(src.data(), elementSize, vectorCount,
+                                       (float *)res.data());
+  return res;
+}
 
-    for (uint32_t i = 0; i < meshCount; i++) {
-      meshFutures.push_back(loadMeshPrimitiveAtMesh(i));
-    }
-    waitFutures(meshFutures);
-  });
+void SparseAccessorBuffer::densify(uint8_t *dst) const {
+  if (base)
+    gatherElements(base, baseStride, elementSize, count, dst);
+  else
+    std::memset(dst, 0, (size_t)count * elementSize);
+  for (size_t i = 0; i < indices.size(); i++) {
+    std::memcpy(dst + (size_t)indices[i] * elementSize,
+                values.data() + i * elementSize, elementSize);
+  }
 }
 
-std::future<void> GLTFData::loadMeshPrimitiveAtMesh(uint32_t meshIndex) {
-  return std::async(std::launch::async, [this, meshIndex] {
-    const auto &mesh = json().meshes->at(meshIndex);
-    auto primitivesCount = mesh.primitives.size();
-    _meshPrimitives[meshIndex].resize(primitivesCount);
+void GLTFData::loadMeshPrimitiveAtMesh(uint32_t meshIndex) {
+  const auto &mesh = json().meshes->at(meshIndex);
+  auto primitivesCount = mesh.primitives.size();
+  _meshPrimitives[meshIndex].resize(primitivesCount);
 
-    std::vector<std::future<void>> futures;
-    futures.reserve(primitivesCount);
+  forEach(Phase::MeshPrimitives, primitivesCount,
+          [this, meshIndex](uint32_t primitiveIndex) {
+            loadMeshPrimitiveAt(meshIndex, primitiveIndex);
+          });
+}
 
-    for (uint32_t primitiveIndex = 0; primitiveIndex < primitivesCount;
-         primitiveIndex++) {
-      futures.push_back(loadMeshPrimitiveAt(meshIndex, primitiveIndex));
-    }
-    waitFutures(futures);
-  });
+uint32_t primitiveCountOfMode(json::MeshPrimitive::Mode mode,
+                              uint32_t indicesCount) {
+  switch (mode) {
+  case json::MeshPrimitive::Mode::POINTS:
+    return indicesCount;
+  case json::MeshPrimitive::Mode::LINES:
+    return indicesCount / 2;
+  case json::MeshPrimitive::Mode::LINE_LOOP:
+    return indicesCount;
+  case json::MeshPrimitive::Mode::LINE_STRIP:
+    return indicesCount - 1;
+  case json::MeshPrimitive::Mode::TRIANGLES:
+    return indicesCount / 3;
+  case json::MeshPrimitive::Mode::TRIANGLE_STRIP:
+    return indicesCount - 2;
+  case json::MeshPrimitive::Mode::TRIANGLE_FAN:
+    return indicesCount - 2;
+  }
+  return 0;
 }
 
-std::future<void> GLTFData::loadMeshPrimitiveAt(uint32_t meshIndex,
-                                                uint32_t primitiveIndex) {
+void GLTFData::loadMeshPrimitiveAt(uint32_t meshIndex,
+                                   uint32_t primitiveIndex) {
   const auto &primitive =
       json().meshes->at(meshIndex).primitives.at(primitiveIndex);
-  return std::async(std::launch::async, [this, meshIndex, primitiveIndex,
-                                         &primitive] {
-    MeshPrimitive meshPrimitive;
-    if (primitive.dracoExtension) {
-      meshPrimitive =
-          meshPrimitiveFromDracoExtension(*primitive.dracoExtension).get();
-    } else {
-      std::vector<std::future<void>> futures;
-      if (primitive.attributes.position) {
-        futures.push_back(std::async(std::launch::async, [this, &meshPrimitive,
-                                                          &primitive] {
-          meshPrimitive.sources.position =
-              meshPrimitiveSourceFromAccessor(*primitive.attributes.position);
-        }));
-      }
-      if (primitive.attributes.normal) {
-        futures.push_back(
-            std::async(std::launch::async, [this, &meshPrimitive, &primitive] {
-              meshPrimitive.sources.normal =
-                  meshPrimitiveSourceFromAccessor(*primitive.attributes.normal);
-            }));
-      }
-      if (primitive.attributes.tangent) {
-        futures.push_back(std::async(std::launch::async, [this, &meshPrimitive,
-                                                          &primitive] {
-          meshPrimitive.sources.tangent =
-              meshPrimitiveSourceFromAccessor(*primitive.attributes.tangent);
-        }));
-      }
-      if (primitive.attributes.texcoords) {
-        futures.push_back(
-            std::async(std::launch::async, [this, &meshPrimitive, &primitive] {
-              for (auto index : *primitive.attributes.texcoords) {
-                meshPrimitive.sources.texcoords.push_back(
-                    meshPrimitiveSourceFromAccessor(index));
-              }
-            }));
-      }
-      if (primitive.attributes.colors) {
-        futures.push_back(
-            std::async(std::launch::async, [this, &meshPrimitive, &primitive] {
-              for (auto index : *primitive.attributes.colors) {
-                meshPrimitive.sources.colors.push_back(
-                    meshPrimitiveSourceFromAccessor(index));
-              }
-            }));
-      }
-      if (primitive.attributes.joints) {
-        futures.push_back(
-            std::async(std::launch::async, [this, &meshPrimitive, &primitive] {
-              for (auto index : *primitive.attributes.joints) {
-                meshPrimitive.sources.joints.push_back(
-                    meshPrimitiveSourceFromAccessor(index));
-              }
-            }));
-      }
-      if (primitive.attributes.weights) {
-        futures.push_back(
-            std::async(std::launch::async, [this, &meshPrimitive, &primitive] {
-              for (auto index : *primitive.attributes.weights) {
-                meshPrimitive.sources.weights.push_back(
-                    meshPrimitiveSourceFromAccessor(index));
-              }
-            }));
-      }
-
-      if (primitive.indices) {
-        futures.push_back(
-            std::async(std::launch::async, [this, &meshPrimitive, &primitive] {
-              MeshPrimitiveElement element;
-              auto &accessor = json().accessors->at(*primitive.indices);
-              element.buffer = accessorBufferAt(*primitive.indices).buffer;
-              element.primitiveMode = primitive.modeValue();
-              auto indicesCount = accessor.count;
-              switch (primitive.modeValue()) {
-              case json::MeshPrimitive::Mode::POINTS:
-                element.primitiveCount = indicesCount;
-                break;
-              case json::MeshPrimitive::Mode::LINES:
-                element.primitiveCount = indicesCount / 2;
-                break;
-              case json::MeshPrimitive::Mode::LINE_LOOP:
-                element.primitiveCount = indicesCount;
-                break;
-              case json::MeshPrimitive::Mode::LINE_STRIP:
-                element.primitiveCount = indicesCount - 1;
-                break;
-              case json::MeshPrimitive::Mode::TRIANGLES:
-                element.primitiveCount = indicesCount / 3;
-                break;
-              case json::MeshPrimitive::Mode::TRIANGLE_STRIP:
-                element.primitiveCount = indicesCount - 2;
-                break;
-              case json::MeshPrimitive::Mode::TRIANGLE_FAN:
-                element.primitiveCount = indicesCount - 2;
-                break;
-              }
-              element.componentType = accessor.componentType;
-              meshPrimitive.element = element;
-            }));
-      }
-
-      waitFutures(futures);
+  TraceScope trace(_options.tracer.get(), "loadMeshPrimitiveAt", meshIndex,
+                   primitiveIndex);
+  MeshPrimitive meshPrimitive;
+  auto estimate = gltf2::estimateMemory(json(), primitive);
+  if (primitive.dracoExtension) {
+    meshPrimitive = meshPrimitiveFromDracoExtension(primitive);
+    // the decoded size is only known after decoding
+    auto decoded = bytesOfSources(meshPrimitive.sources);
+    if (meshPrimitive.element)
+      decoded += meshPrimitive.element->buffer.size();
+    _memory->reserve(decoded + estimate.morphTargets, "mesh primitive");
+  } else {
+    _memory->reserve(estimate.total(), "mesh primitive");
+    meshPrimitive.sources = meshPrimitiveSourcesFromTarget(
+        primitive.attributes, &primitive.attributes);
+
+    if (primitive.indices) {
+      MeshPrimitiveElement element;
+      auto &accessor = json().accessors->at(*primitive.indices);
+      const auto &indices = accessorBufferAt(*primitive.indices);
+      // indices kept as a sparse overlay are only dense in the element
+      element.buffer =
+          indices.sparse ? indices.sparse->toBuffer() : indices.buffer;
+      element.primitiveMode = primitive.modeValue();
+      element.primitiveCount =
+          primitiveCountOfMode(primitive.modeValue(), accessor.count);
+      element.componentType = accessor.componentType;
+      meshPrimitive.element = element;
     }
+  }
 
-    if (primitive.targets.has_value()) {
-      for (const auto &target : *primitive.targets) {
-        meshPrimitive.targets.push_back(meshPrimitiveSourcesFromTarget(target));
-      }
+  if (primitive.targets.has_value()) {
+    for (const auto &target : *primitive.targets) {
+      meshPrimitive.targets.push_back(meshPrimitiveSourcesFromTarget(target));
+      _stats->add(LoadStatsRecorder::Bytes::MorphTargets,
+                  bytesOfSources(meshPrimitive.targets.back()));
     }
+  }
 
-    _meshPrimitives[meshIndex][primitiveIndex] =
-        std::make_unique<MeshPrimitive>(meshPrimitive);
-  });
+  if (_options.vertexWeld) {
+    TraceScope weldTrace(_options.tracer.get(), "weldMeshPrimitive", meshIndex,
+                         primitiveIndex);
+    VertexWelder(*_options.vertexWeld)
+        .weld(meshPrimitive, primitive.modeValue(), executor());
+  }
+  if (_options.meshOptimization) {
+    TraceScope optimizeTrace(_options.tracer.get(), "optimizeMeshPrimitive",
+                             meshIndex, primitiveIndex);
+    MeshOptimizer(*_options.meshOptimization).optimize(meshPrimitive);
+  }
+
+  auto bytes = bytesOfSources(meshPrimitive.sources);
+  if (meshPrimitive.element)
+    bytes += meshPrimitive.element->buffer.size();
+  _stats->add(LoadStatsRecorder::Bytes::Primitives, bytes);
+  trace.setBytes(bytes);
+
+  _meshPrimitives[meshIndex][primitiveIndex] =
+      std::make_unique<MeshPrimitive>(std::move(meshPrimitive));
 }
 
 MeshPrimitiveSource
@@ -451,6 +734,8 @@ GLTFData::meshPrimitiveSourceFromAccessor(uint32_t index) const {
       isFloat ? json::Accessor::ComponentType::FLOAT : accessor.componentType;
 
   source.buffer = accessorBuffer.buffer;
+  source.sparse = accessorBuffer.sparse;
+  source.normalized = !isFloat && accessor.normalized.value_or(false);
   source.vectorCount = accessor.count;
   source.componentsPerVector =
       json::Accessor::componentsCountOfType(accessor.type);
@@ -459,43 +744,45 @@ GLTFData::meshPrimitiveSourceFromAccessor(uint32_t index) const {
 }
 
 MeshPrimitiveSources GLTFData::meshPrimitiveSourcesFromTarget(
-    const json::MeshPrimitiveTarget &target) const {
+    const json::MeshPrimitiveTarget &target,
+    const json::MeshPrimitiveAttributes *attributes) const {
   MeshPrimitiveSources sources;
-  std::vector<std::future<void>> futures;
-
-  if (target.position) {
-    futures.push_back(std::async(std::launch::async, [this, &sources, &target] {
-      sources.position = meshPrimitiveSourceFromAccessor(*target.position);
-    }));
-  }
-  if (target.normal) {
-    futures.push_back(std::async(std::launch::async, [this, &sources, &target] {
-      sources.normal = meshPrimitiveSourceFromAccessor(*target.normal);
-    }));
-  }
-  if (target.tangent) {
-    futures.push_back(std::async(std::launch::async, [this, &sources, &target] {
-      sources.tangent = meshPrimitiveSourceFromAccessor(*target.tangent);
-    }));
-  }
-  waitFutures(futures);
-  return sources;
-}
-
-static std::unique_ptr<draco::Mesh>
-decodeDracoMesh(const BufferView &bufferView) {
-  draco::DecoderBuffer buffer;
-  buffer.Init((const char *)bufferView.data, bufferView.bytes);
-
-  draco::Decoder decoder;
-  auto status_or_mesh = decoder.DecodeMeshFromBuffer(&buffer);
-  if (!status_or_mesh.ok()) {
-    std::cerr << "Failed to decode Draco mesh: "
-              << status_or_mesh.status().error_msg() << std::endl;
-    return nullptr;
+  // pairs of an accessor and the source it is loaded into
+  std::vector<std::pair<uint32_t, MeshPrimitiveSource *>> loads;
+
+  auto skipped = _options.skippedAttributes;
+  auto add = [&loads, skipped](const std::optional<uint32_t> &accessor,
+                               std::optional<MeshPrimitiveSource> &source,
+                               MeshAttributes attribute) {
+    if (accessor && !contains(skipped, attribute))
+      loads.emplace_back(*accessor, &source.emplace());
+  };
+  add(target.position, sources.position, MeshAttributes::None);
+  add(target.normal, sources.normal, MeshAttributes::Normal);
+  add(target.tangent, sources.tangent, MeshAttributes::Tangent);
+
+  if (attributes) {
+    auto addArray = [&loads, skipped](
+                        const std::optional<std::vector<uint32_t>> &accessors,
+                        std::vector<MeshPrimitiveSource> &array,
+                        MeshAttributes attribute) {
+      if (!accessors || contains(skipped, attribute))
+        return;
+      array.resize(accessors->size());
+      for (size_t i = 0; i < accessors->size(); i++)
+        loads.emplace_back(accessors->at(i), &array[i]);
+    };
+    addArray(attributes->texcoords, sources.texcoords,
+             MeshAttributes::Texcoords);
+    addArray(attributes->colors, sources.colors, MeshAttributes::Colors);
+    addArray(attributes->joints, sources.joints, MeshAttributes::Joints);
+    addArray(attributes->weights, sources.weights, MeshAttributes::Weights);
   }
 
-  return std::move(status_or_mesh).value();
+  forEach(Phase::MeshPrimitives, loads.size(), [this, &loads](uint32_t i) {
+    *loads[i].second = meshPrimitiveSourceFromAccessor(loads[i].first);
+  });
+  return sources;
 }
 
 static json::Accessor::ComponentType
@@ -510,6 +797,7 @@ convertDracoDataTypeToGLTFComponentType(draco::DataType dracoType) {
   case draco::DT_UINT16:
     return json::Accessor::ComponentType::UNSIGNED_SHORT;
   case draco::DT_INT32:
+  case draco::DT_UINT32:
     return json::Accessor::ComponentType::UNSIGNED_INT;
   case draco::DT_FLOAT32:
     return json::Accessor::ComponentType::FLOAT;
@@ -518,70 +806,195 @@ convertDracoDataTypeToGLTFComponentType(draco::DataType dracoType) {
   }
 }
 
+template <size_t Size>
+static void gatherMappedValues(const draco::PointAttribute &attr,
+                               uint32_t count, size_t elementSize,
+                               uint8_t *dst) {
+  const uint8_t *base = attr.GetAddress(draco::AttributeValueIndex(0));
+  auto stride = attr.byte_stride();
+  for (draco::PointIndex i(0); i < count; ++i) {
+    const uint8_t *src = base + attr.mapped_index(i).value() * stride;
+    std::memcpy(dst, src, Size ? Size : elementSize);
+    dst += Size ? Size : elementSize;
+  }
+}
+
+/**
+ * @brief Copy the value of every point of a decoded Draco attribute to `dst`:
+ * in bulk when the points map to the values one to one, or in one pass over
+ * the index map otherwise.
+ */
+static void copyDracoAttributeValues(const draco::PointAttribute &attr,
+                                     uint32_t count, size_t elementSize,
+                                     uint8_t *dst) {
+  if (attr.is_mapping_identity()) {
+    gatherElements(attr.GetAddress(draco::AttributeValueIndex(0)),
+                   attr.byte_stride(), elementSize, count, dst);
+    return;
+  }
+  switch (elementSize) {
+  case 4:
+    gatherMappedValues<4>(attr, count, elementSize, dst);
+    break;
+  case 8:
+    gatherMappedValues<8>(attr, count, elementSize, dst);
+    break;
+  case 12:
+    gatherMappedValues<12>(attr, count, elementSize, dst);
+    break;
+  case 16:
+    gatherMappedValues<16>(attr, count, elementSize, dst);
+    break;
+  default:
+    gatherMappedValues<0>(attr, count, elementSize, dst);
+    break;
+  }
+}
+
+/**
+ * @brief Copy the Draco attribute with `uniqueId` out of the decoded mesh.
+ * Normalized integers are converted to floats unless `keepNormalized`.
+ * @throws InvalidFormatException If the mesh has no such attribute.
+ */
 static MeshPrimitiveSource
-processDracoMeshPrimitiveSource(const std::unique_ptr<draco::Mesh> &dracoMesh,
-                                draco::GeometryAttribute::Type type) {
-  const draco::PointAttribute *attr = dracoMesh->GetNamedAttribute(type);
-  auto vectorCount = dracoMesh->num_points();
-  auto componentsPerVector = attr->num_components();
-  auto bytesPerComponent = draco::DataTypeLength(attr->data_type());
-  auto length = vectorCount * componentsPerVector * bytesPerComponent;
-  Buffer data(length);
-  for (draco::PointIndex i(0); i < dracoMesh->num_points(); ++i) {
-    uint8_t *bytes =
-        data.data() + i.value() * componentsPerVector * bytesPerComponent;
-    attr->GetMappedValue(i, bytes);
+processDracoMeshPrimitiveSource(const draco::Mesh &dracoMesh,
+                                uint32_t uniqueId, bool keepNormalized) {
+  const auto *attr = dracoMesh.GetAttributeByUniqueId(uniqueId);
+  if (!attr) {
+    throw InvalidFormatException("Draco mesh has no attribute with id " +
+                                 std::to_string(uniqueId));
   }
+  auto vectorCount = dracoMesh.num_points();
+  auto componentsPerVector = attr->num_components();
+  auto componentSize = draco::DataTypeLength(attr->data_type());
+  auto elementSize = componentsPerVector * componentSize;
   MeshPrimitiveSource source;
-  source.buffer = data;
+  source.buffer.resize((size_t)vectorCount * elementSize);
+  copyDracoAttributeValues(*attr, vectorCount, elementSize,
+                           source.buffer.data());
   source.vectorCount = vectorCount;
   source.componentsPerVector = componentsPerVector;
   source.componentType =
       convertDracoDataTypeToGLTFComponentType(attr->data_type());
+  source.normalized =
+      attr->normalized() && (size_t)componentSize < sizeof(float);
+  if (source.normalized && !keepNormalized) {
+    source.buffer = source.toFloatBuffer();
+    source.componentType = json::Accessor::ComponentType::FLOAT;
+    source.normalized = false;
+  }
   return source;
 }
 
-std::future<MeshPrimitive> GLTFData::meshPrimitiveFromDracoExtension(
-    const json::MeshPrimitiveDracoExtension &extension) const {
-  return std::async(std::launch::async, [this, &extension] {
-    auto dracoMesh = decodeDracoMesh(bufferViewAt(extension.bufferView));
-    auto primitiveCount = dracoMesh->num_faces();
-    auto indicesCount = primitiveCount * 3;
-    Buffer indicesData(sizeof(uint32_t) * indicesCount);
-    for (draco::FaceIndex i(0); i < dracoMesh->num_faces(); i++) {
-      const auto &face = dracoMesh->face(i);
-      uint32_t indices[3] = {face[0].value(), face[1].value(), face[2].value()};
-      auto offset = sizeof(uint32_t) * 3 * i.value();
-      std::memcpy(indicesData.data() + offset, indices, sizeof(uint32_t) * 3);
-    }
-    MeshPrimitiveElement element;
-    element.buffer = indicesData;
-    element.primitiveMode = json::MeshPrimitive::Mode::TRIANGLES;
-    element.primitiveCount = primitiveCount;
-    element.componentType = json::Accessor::ComponentType::UNSIGNED_INT;
-
-    MeshPrimitiveSources sources;
-    for (int i = 0; i < dracoMesh->num_attributes(); i++) {
-      const auto *attr = dracoMesh->attribute(i);
-      auto source =
-          processDracoMeshPrimitiveSource(dracoMesh, attr->attribute_type());
-      if (attr->attribute_type() == draco::GeometryAttribute::POSITION) {
-        sources.position = source;
-      } else if (attr->attribute_type() == draco::GeometryAttribute::NORMAL) {
-        sources.normal = source;
-      } else if (attr->attribute_type() == draco::GeometryAttribute::COLOR) {
-        sources.colors.push_back(source);
-      } else if (attr->attribute_type() ==
-                 draco::GeometryAttribute::TEX_COORD) {
-        sources.texcoords.push_back(source);
+void GLTFData::decodeDracoMeshes() {
+  _dracoMeshes.clear();
+  if (!json().meshes)
+    return;
+  std::vector<uint32_t> bufferViews;
+  for (const auto &mesh : *json().meshes) {
+    for (const auto &primitive : mesh.primitives) {
+      if (!primitive.dracoExtension)
+        continue;
+      auto index = primitive.dracoExtension->bufferView;
+      if (index >= _bufferViews.size()) {
+        throw InvalidFormatException(
+            format("bufferView index %u out of range", index));
       }
+      bufferViews.push_back(index);
     }
-
-    MeshPrimitive primitive;
-    primitive.sources = sources;
-    primitive.element = element;
-    return primitive;
+  }
+  if (bufferViews.empty())
+    return;
+  // primitives may share a Draco mesh
+  std::sort(bufferViews.begin(), bufferViews.end());
+  bufferViews.erase(std::unique(bufferViews.begin(), bufferViews.end()),
+                    bufferViews.end());
+
+  LoadStatsRecorder::WallScope scope(*_stats, Phase::DracoDecode);
+  TraceScope trace(_options.tracer.get(), "decodeDracoMeshes");
+  _dracoMeshes.resize(_bufferViews.size());
+  DracoDecoder decoder(_options.skippedAttributes);
+  forEach(Phase::DracoDecode, bufferViews.size(), [&](uint32_t i) {
+    auto index = bufferViews[i];
+    TraceScope trace(_options.tracer.get(), "decodeDracoMesh", index);
+    const auto &bufferView = bufferViewAt(index);
+    trace.setBytes(bufferView.bytes);
+    _dracoMeshes[index] = decoder.decode(bufferView);
+    _stats->increment(LoadStatsRecorder::Count::DracoPrimitives);
   });
 }
 
+MeshPrimitive GLTFData::meshPrimitiveFromDracoExtension(
+    const json::MeshPrimitive &primitive) const {
+  const auto &extension = *primitive.dracoExtension;
+  const auto &dracoMesh = _dracoMeshes.at(extension.bufferView);
+  auto primitiveCount = dracoMesh->num_faces();
+  auto indicesCount = primitiveCount * 3;
+  // the faces are stored contiguously as 3 uint32_t point indices each
+  static_assert(sizeof(draco::Mesh::Face) == sizeof(uint32_t) * 3,
+                "draco::Mesh::Face is not 3 packed uint32_t");
+  MeshPrimitiveElement element;
+  element.buffer.resize(sizeof(uint32_t) * indicesCount);
+  if (primitiveCount > 0) {
+    std::memcpy(element.buffer.data(), &dracoMesh->face(draco::FaceIndex(0)),
+                element.buffer.size());
+  }
+  element.primitiveMode = json::MeshPrimitive::Mode::TRIANGLES;
+  element.primitiveCount = primitiveCount;
+  element.componentType = json::Accessor::ComponentType::UNSIGNED_INT;
+
+  // the extension maps attributes to the unique ids of Draco attributes;
+  // the other attributes of the primitive are stored uncompressed
+  const auto &ids = extension.attributes;
+  const auto &accessors = primitive.attributes;
+  auto skipped = _options.skippedAttributes;
+  bool keepQuantized = _options.keepQuantizedAttributes;
+  auto load = [&](const std::optional<uint32_t> &id,
+                  const std::optional<uint32_t> &accessor,
+                  bool keepNormalized) -> std::optional<MeshPrimitiveSource> {
+    if (id)
+      return processDracoMeshPrimitiveSource(*dracoMesh, *id, keepNormalized);
+    if (accessor)
+      return meshPrimitiveSourceFromAccessor(*accessor);
+    return std::nullopt;
+  };
+  using Indices = std::optional<std::vector<uint32_t>>;
+  auto loadArray = [&](const Indices &idArray, const Indices &accessorArray,
+                       bool keepNormalized,
+                       std::vector<MeshPrimitiveSource> &to) {
+    auto count = std::max(idArray ? idArray->size() : 0,
+                          accessorArray ? accessorArray->size() : 0);
+    for (size_t i = 0; i < count; i++) {
+      std::optional<uint32_t> id, accessor;
+      if (idArray && i < idArray->size())
+        id = idArray->at(i);
+      if (accessorArray && i < accessorArray->size())
+        accessor = accessorArray->at(i);
+      if (auto source = load(id, accessor, keepNormalized))
+        to.push_back(std::move(*source));
+    }
+  };
+
+  MeshPrimitiveSources sources;
+  sources.position = load(ids.position, accessors.position, keepQuantized);
+  if (!contains(skipped, MeshAttributes::Normal))
+    sources.normal = load(ids.normal, accessors.normal, keepQuantized);
+  if (!contains(skipped, MeshAttributes::Tangent))
+    sources.tangent = load(ids.tangent, accessors.tangent, keepQuantized);
+  if (!contains(skipped, MeshAttributes::Texcoords))
+    loadArray(ids.texcoords, accessors.texcoords, keepQuantized,
+              sources.texcoords);
+  if (!contains(skipped, MeshAttributes::Colors))
+    loadArray(ids.colors, accessors.colors, false, sources.colors);
+  if (!contains(skipped, MeshAttributes::Joints))
+    loadArray(ids.joints, accessors.joints, false, sources.joints);
+  if (!contains(skipped, MeshAttributes::Weights))
+    loadArray(ids.weights, accessors.weights, false, sources.weights);
+
+  MeshPrimitive meshPrimitive;
+  meshPrimitive.sources = std::move(sources);
+  meshPrimitive.element = std::move(element);
+  return meshPrimitive;
+}
+
 } // namespace gltf2
@@ -0,0 +1,43 @@
+#include "GLTFDocument.h"
+#include "GLTFException.h"
+
+namespace gltf2 {
+
+GLTFDocumentPtr GLTFDocument::load(GLTFFile &&file, LoadOptions options) {
+  return freeze(GLTFData::load(std::move(file), std::move(options)));
+}
+
+GLTFDocumentPtr GLTFDocument::freeze(GLTFData &&data) {
+  if (!data.isLoaded())
+    throw InputException("Only fully loaded data can be frozen");
+  return GLTFDocumentPtr(new GLTFDocument(std::move(data)));
+}
+
+std::shared_ptr<const json::Json> GLTFDocument::sharedJson() const {
+  return share(json());
+}
+
+std::shared_ptr<const Buffer> GLTFDocument::bufferAt(uint32_t index) const {
+  return share(*_data.buffers().at(index));
+}
+
+std::shared_ptr<const AccessorBuffer>
+GLTFDocument::accessorBufferAt(uint32_t index) const {
+  return share(*_data.accessorBuffers().at(index));
+}
+
+std::shared_ptr<const Buffer>
+GLTFDocument::imageBufferAt(uint32_t index) const {
+  return share(*_data.imageBuffers().at(index));
+}
+
+std::shared_ptr<const json::Mesh> GLTFDocument::meshAt(uint32_t index) const {
+  return share(json().meshes.value().at(index));
+}
+
+std::shared_ptr<const MeshPrimitive>
+GLTFDocument::meshPrimitiveAt(uint32_t meshIndex, uint32_t index) const {
+  return share(*_data.meshPrimitivesAt(meshIndex).at(index));
+}
+
+} // namespace gltf2
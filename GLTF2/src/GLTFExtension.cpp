@@ -22,8 +22,12 @@ const std::string GLTFExtensionKHRMaterialsTransmission =
     "KHR_materials_transmission";
 const std::string GLTFExtensionKHRMaterialsUnlit = "KHR_materials_unlit";
 const std::string GLTFExtensionKHRMaterialsVolume = "KHR_materials_volume";
+const std::string GLTFExtensionKHRMeshQuantization = "KHR_mesh_quantization";
 const std::string GLTFExtensionKHRTextureTransform = "KHR_texture_transform";
 
+const std::string GLTFExtensionEXTMeshoptCompression =
+    "EXT_meshopt_compression";
+
 const std::string GLTFExtensionVRM = "VRM";
 const std::string GLTFExtensionVRMCvrm = "VRMC_vrm";
 const std::string GLTFExtensionVRMCSpringBone = "VRMC_springBone";
@@ -1,3 +1,4 @@
+#include "GLBFormat.h"
 #include "GLTFData.h"
 #include "GLTFException.h"
 #include "GLTFExtension.h"
@@ -14,21 +15,6 @@
 
 namespace gltf2 {
 
-static const uint32_t GLBHeaderMagic = 0x46546C67;
-static const uint32_t GLBChunkTypeJSON = 0x4E4F534A;
-static const uint32_t GLBChunkTypeBIN = 0x004E4942;
-
-struct GLBHeader {
-  uint32_t magic = 0;
-  uint32_t version = 0;
-  uint32_t length = 0;
-};
-
-struct GLBChunkHead {
-  uint32_t length = 0;
-  uint32_t type = 0;
-};
-
 static uint32_t peekMagic(std::istream &fs) {
   uint32_t magic;
   if (!fs.read(reinterpret_cast<char *>(&magic), sizeof(uint32_t))) {
@@ -72,7 +58,8 @@ static json::Json readGLBJson(std::istream &fs) {
 
 static std::optional<Buffer> readGLBBin(std::istream &fs) {
   std::optional<Buffer> bin;
-  if (!fs.eof()) {
+  // the BIN chunk is optional, e.g. when every buffer has a uri
+  if (fs.peek() != std::char_traits<char>::eof()) {
     GLBChunkHead chunkHead1;
     if (!fs.read(reinterpret_cast<char *>(&chunkHead1), sizeof(GLBChunkHead))) {
       throw InputException("Failed to read chunk head");
@@ -85,7 +72,7 @@ static std::optional<Buffer> readGLBBin(std::istream &fs) {
     if (fs.gcount() != chunkHead1.length) {
       throw InputException("Failed to read bin data");
     }
-    bin = binBuf;
+    bin = std::move(binBuf);
   }
   return bin;
 }
@@ -100,13 +87,25 @@ GLTFFile GLTFFile::parseFile(const std::filesystem::path &path) {
 }
 
 GLTFFile GLTFFile::parseStream(std::istream &&fs,
-                               const std::optional<std::filesystem::path> path,
-                               const std::optional<Buffer> bin) {
+                               std::optional<std::filesystem::path> path,
+                               std::optional<Buffer> bin) {
+  auto wallStart = std::chrono::steady_clock::now();
+  auto cpuStart = threadCpuTime();
+  auto withStats = [&](GLTFFile &&file, uint64_t bytes) {
+    file._stats.parse.wall = std::chrono::steady_clock::now() - wallStart;
+    file._stats.parse.cpu = threadCpuTime() - cpuStart;
+    file._stats.bytesFromFiles = bytes;
+    return std::move(file);
+  };
+
   if (peekMagic(fs) == GLBHeaderMagic) {
     // GLB
     auto json = readGLBJson(fs);
+    auto jsonEnd = static_cast<uint64_t>(fs.tellg());
     auto bin = readGLBBin(fs);
-    return GLTFFile(json, path, bin);
+    auto bytes = jsonEnd + (bin ? sizeof(GLBChunkHead) + bin->size() : 0);
+    return withStats(
+        GLTFFile(std::move(json), std::move(path), std::move(bin)), bytes);
   } else {
     // GLTF
     std::string raw((std::istreambuf_iterator<char>(fs)),
@@ -114,7 +113,9 @@ GLTFFile GLTFFile::parseStream(std::istream &&fs,
     try {
       auto data = nlohmann::json::parse(raw);
       auto json = json::JsonDecoder::decode(data);
-      return GLTFFile(json, path, bin);
+      return withStats(
+          GLTFFile(std::move(json), std::move(path), std::move(bin)),
+          raw.size());
     } catch (nlohmann::json::exception e) {
       throw InputException(e.what());
     }
@@ -0,0 +1,211 @@
+#include "GLTFPrune.h"
+#include "GLTFException.h"
+#include "JsonReferences.h"
+#include <array>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+namespace gltf2 {
+
+static const size_t referenceKindCount =
+    static_cast<size_t>(json::ReferenceKind::Texture) + 1;
+
+using Marks = std::array<std::vector<bool>, referenceKindCount>;
+
+template <typename T>
+static uint32_t countOf(const std::optional<std::vector<T>> &array) {
+  return array ? array->size() : 0;
+}
+
+static uint32_t countOf(const json::Json &json, json::ReferenceKind kind) {
+  switch (kind) {
+  case json::ReferenceKind::Accessor:
+    return countOf(json.accessors);
+  case json::ReferenceKind::Buffer:
+    return countOf(json.buffers);
+  case json::ReferenceKind::BufferView:
+    return countOf(json.bufferViews);
+  case json::ReferenceKind::Camera:
+    return countOf(json.cameras);
+  case json::ReferenceKind::Image:
+    return countOf(json.images);
+  case json::ReferenceKind::Material:
+    return countOf(json.materials);
+  case json::ReferenceKind::Mesh:
+    return countOf(json.meshes);
+  case json::ReferenceKind::Node:
+    return countOf(json.nodes);
+  case json::ReferenceKind::Sampler:
+    return countOf(json.samplers);
+  case json::ReferenceKind::Skin:
+    return countOf(json.skins);
+  case json::ReferenceKind::Texture:
+    return countOf(json.textures);
+  }
+  return 0;
+}
+
+static Marks markReachable(const json::Json &json) {
+  Marks marks;
+  for (size_t i = 0; i < referenceKindCount; i++) {
+    marks[i].resize(countOf(json, static_cast<json::ReferenceKind>(i)));
+  }
+
+  std::vector<std::pair<json::ReferenceKind, uint32_t>> queue;
+  auto mark = [&marks, &queue](json::ReferenceKind kind, uint32_t index) {
+    auto &kindMarks = marks[static_cast<size_t>(kind)];
+    if (index >= kindMarks.size()) {
+      throw InvalidFormatException("index " + std::to_string(index) +
+                                   " out of range");
+    }
+    if (!kindMarks[index]) {
+      kindMarks[index] = true;
+      queue.emplace_back(kind, index);
+    }
+  };
+
+  // roots
+  if (json.scenes) {
+    for (const auto &scene : *json.scenes)
+      json::forEachSceneReference(scene, mark);
+  } else {
+    for (uint32_t i = 0; i < countOf(json.nodes); i++)
+      mark(json::ReferenceKind::Node, i);
+  }
+  if (json.animations) {
+    for (const auto &animation : *json.animations)
+      json::forEachAnimationReference(animation, mark);
+  }
+  json::forEachExtensionReference(json, mark);
+
+  // VRM 0.x binds material values by material name
+  if (json.vrm0 && json.vrm0->blendShapeMaster &&
+      json.vrm0->blendShapeMaster->blendShapeGroups && json.materials) {
+    std::unordered_set<std::string> names;
+    for (const auto &group : *json.vrm0->blendShapeMaster->blendShapeGroups) {
+      if (!group.materialValues)
+        continue;
+      for (const auto &materialValue : *group.materialValues) {
+        if (materialValue.materialName)
+          names.insert(*materialValue.materialName);
+      }
+    }
+    for (uint32_t i = 0; i < json.materials->size(); i++) {
+      const auto &name = json.materials->at(i).name;
+      if (name && names.count(*name))
+        mark(json::ReferenceKind::Material, i);
+    }
+  }
+
+  while (!queue.empty()) {
+    auto [kind, index] = queue.back();
+    queue.pop_back();
+    switch (kind) {
+    case json::ReferenceKind::Accessor:
+      json::forEachAccessorReference(json.accessors->at(index), mark);
+      break;
+    case json::ReferenceKind::BufferView:
+      json::forEachBufferViewReference(json.bufferViews->at(index), mark);
+      break;
+    case json::ReferenceKind::Image:
+      json::forEachImageReference(json.images->at(index), mark);
+      break;
+    case json::ReferenceKind::Material:
+      json::forEachMaterialReference(json.materials->at(index), mark);
+      break;
+    case json::ReferenceKind::Mesh:
+      json::forEachMeshReference(json.meshes->at(index), mark);
+      break;
+    case json::ReferenceKind::Node:
+      json::forEachNodeReference(json.nodes->at(index), mark);
+      break;
+    case json::ReferenceKind::Skin:
+      json::forEachSkinReference(json.skins->at(index), mark);
+      break;
+    case json::ReferenceKind::Texture:
+      json::forEachTextureReference(json.textures->at(index), mark);
+      break;
+    case json::ReferenceKind::Buffer:
+    case json::ReferenceKind::Camera:
+    case json::ReferenceKind::Sampler:
+      break;
+    }
+  }
+  return marks;
+}
+
+/**
+ * @brief Removes the unmarked elements of an array, keeping the order of the
+ * others, and returns the number of removed elements.
+ */
+template <typename T>
+static uint32_t compact(std::optional<std::vector<T>> &array,
+                        const std::vector<bool> &marks) {
+  if (!array)
+    return 0;
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < array->size(); i++) {
+    if (marks[i]) {
+      if (kept != i)
+        array->at(kept) = std::move(array->at(i));
+      kept++;
+    }
+  }
+  auto removed = array->size() - kept;
+  array->resize(kept);
+  return removed;
+}
+
+PruneResult GLTFPrune::prune(json::Json &json) {
+  auto marks = markReachable(json);
+  auto marksOf = [&marks](json::ReferenceKind kind) -> std::vector<bool> & {
+    return marks[static_cast<size_t>(kind)];
+  };
+
+  std::array<std::vector<uint32_t>, referenceKindCount> remap;
+  for (size_t i = 0; i < referenceKindCount; i++) {
+    remap[i].resize(marks[i].size());
+    uint32_t next = 0;
+    for (uint32_t j = 0; j < marks[i].size(); j++) {
+      if (marks[i][j])
+        remap[i][j] = next++;
+    }
+  }
+
+  PruneResult result;
+  result.accessors =
+      compact(json.accessors, marksOf(json::ReferenceKind::Accessor));
+  result.buffers = compact(json.buffers, marksOf(json::ReferenceKind::Buffer));
+  result.bufferViews =
+      compact(json.bufferViews, marksOf(json::ReferenceKind::BufferView));
+  result.cameras = compact(json.cameras, marksOf(json::ReferenceKind::Camera));
+  result.images = compact(json.images, marksOf(json::ReferenceKind::Image));
+  result.materials =
+      compact(json.materials, marksOf(json::ReferenceKind::Material));
+  result.meshes = compact(json.meshes, marksOf(json::ReferenceKind::Mesh));
+  result.nodes = compact(json.nodes, marksOf(json::ReferenceKind::Node));
+  result.samplers =
+      compact(json.samplers, marksOf(json::ReferenceKind::Sampler));
+  result.skins = compact(json.skins, marksOf(json::ReferenceKind::Skin));
+  result.textures =
+      compact(json.textures, marksOf(json::ReferenceKind::Texture));
+
+  // every remaining object only refers to marked objects
+  json::forEachReference(json,
+                         [&remap](json::ReferenceKind kind, uint32_t &index) {
+                           index = remap[static_cast<size_t>(kind)][index];
+                         });
+  return result;
+}
+
+GLTFFile GLTFPrune::prune(GLTFFile &&file, PruneResult *result) {
+  auto json = std::move(file._json);
+  auto pruned = prune(json);
+  if (result)
+    *result = pruned;
+  return GLTFFile(std::move(json), std::move(file._path),
+                  std::move(file._bin));
+}
+
+} // namespace gltf2
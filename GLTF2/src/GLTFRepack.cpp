@@ -0,0 +1,219 @@
+#include "GLTFRepack.h"
+#include "GLTFException.h"
+#include "JsonReferences.h"
+#include "MeshoptDecoder.h"
+#include <functional>
+#include <string>
+
+namespace gltf2 {
+
+static std::vector<bool> referencedBufferViews(const json::Json &json) {
+  std::vector<bool> referenced(json.bufferViews ? json.bufferViews->size() : 0);
+  json::forEachReference(json, [&referenced](json::ReferenceKind kind,
+                                             uint32_t index) {
+    if (kind != json::ReferenceKind::BufferView)
+      return;
+    if (index >= referenced.size()) {
+      throw InvalidFormatException("bufferView index " +
+                                   std::to_string(index) + " out of range");
+    }
+    referenced[index] = true;
+  });
+  return referenced;
+}
+
+static std::optional<json::Image::MimeType>
+imageMimeType(const json::Image &image, const Buffer &data) {
+  if (image.mimeType)
+    return image.mimeType;
+  if (image.uri && image.uri->rfind("data:", 0) == 0) {
+    auto end = image.uri->find_first_of(";,");
+    if (end != std::string::npos) {
+      auto mimeType =
+          json::Image::MimeTypeFromString(image.uri->substr(5, end - 5));
+      if (mimeType)
+        return mimeType;
+    }
+  }
+  static const uint8_t pngSignature[] = {0x89, 'P', 'N', 'G'};
+  static const uint8_t jpegSignature[] = {0xFF, 0xD8, 0xFF};
+  if (data.size() >= sizeof(pngSignature) &&
+      std::equal(std::begin(pngSignature), std::end(pngSignature),
+                 data.begin()))
+    return json::Image::MimeType::PNG;
+  if (data.size() >= sizeof(jpegSignature) &&
+      std::equal(std::begin(jpegSignature), std::end(jpegSignature),
+                 data.begin()))
+    return json::Image::MimeType::JPEG;
+  return std::nullopt;
+}
+
+/**
+ * @brief Adds the referenced bufferViews and the given URI images of `json`
+ * to a writer created from it and rewrites all references to them.
+ *
+ * @param buffers The contents of each buffer, or nullptr if none of the
+ * referenced bufferViews are stored in it.
+ * @param images The contents of each image that should be embedded, or
+ * nullptr to leave the image as is.
+ * @param decoded The decoded contents of each EXT_meshopt_compression
+ * bufferView, or nullptr to take the bufferView from its buffer.
+ */
+static void repackJson(GLBWriter &writer, const json::Json &json,
+                       const std::vector<const Buffer *> &buffers,
+                       const std::vector<const Buffer *> &images,
+                       const std::vector<const Buffer *> &decoded = {}) {
+  auto referenced = referencedBufferViews(json);
+
+  std::vector<uint32_t> remap(referenced.size());
+  for (uint32_t i = 0; i < referenced.size(); i++) {
+    if (!referenced[i])
+      continue;
+    const auto &bufferView = json.bufferViews->at(i);
+    if (i < decoded.size() && decoded[i]) {
+      remap[i] = writer.addBufferView(
+          decoded[i]->data(), bufferView.byteLength, GLBChunkAlignment,
+          bufferView.byteStride, bufferView.target, bufferView.name);
+      continue;
+    }
+    const auto *buffer = buffers.at(bufferView.buffer);
+    auto offset = bufferView.byteOffset.value_or(0);
+    if (!buffer || (uint64_t)offset + bufferView.byteLength > buffer->size()) {
+      throw InvalidFormatException("bufferView " + std::to_string(i) +
+                                   " out of range of buffer " +
+                                   std::to_string(bufferView.buffer));
+    }
+    remap[i] = writer.addBufferView(buffer->data() + offset,
+                                    bufferView.byteLength, GLBChunkAlignment,
+                                    bufferView.byteStride, bufferView.target,
+                                    bufferView.name);
+  }
+  json::forEachReference(
+      writer.json(), [&remap](json::ReferenceKind kind, uint32_t &index) {
+        if (kind == json::ReferenceKind::BufferView)
+          index = remap[index];
+      });
+
+  if (writer.json().images) {
+    auto &jsonImages = *writer.json().images;
+    for (uint32_t i = 0; i < jsonImages.size(); i++) {
+      auto &image = jsonImages[i];
+      if (!image.uri || !images.at(i))
+        continue;
+      auto mimeType = imageMimeType(image, *images[i]);
+      if (!mimeType)
+        continue;
+      image.bufferView =
+          writer.addBufferView(images[i]->data(), images[i]->size());
+      image.mimeType = mimeType;
+      image.uri.reset();
+    }
+  }
+}
+
+/**
+ * @brief Which buffers hold the given bufferViews, or their compressed data
+ * if they use EXT_meshopt_compression.
+ */
+static std::vector<bool> buffersOfBufferViews(const json::Json &json,
+                                              const std::vector<bool> &views) {
+  std::vector<bool> buffers(json.buffers ? json.buffers->size() : 0);
+  for (uint32_t i = 0; i < views.size(); i++) {
+    if (!views[i])
+      continue;
+    const auto &bufferView = json.bufferViews->at(i);
+    auto buffer = bufferView.meshoptExtension
+                      ? bufferView.meshoptExtension->buffer
+                      : bufferView.buffer;
+    if (buffer >= buffers.size()) {
+      throw InvalidFormatException("buffer index " + std::to_string(buffer) +
+                                   " out of range");
+    }
+    buffers[buffer] = true;
+  }
+  return buffers;
+}
+
+GLBWriter GLTFRepack::repack(const GLTFFile &file, Executor &executor) {
+  const auto &json = file.json();
+  auto referenced = referencedBufferViews(json);
+  auto usedBuffers = buffersOfBufferViews(json, referenced);
+  auto imageCount = json.images ? json.images->size() : 0;
+
+  std::vector<std::optional<Buffer>> buffers(usedBuffers.size());
+  std::vector<std::optional<Buffer>> images(imageCount);
+  std::vector<std::function<void()>> reads;
+  for (uint32_t i = 0; i < usedBuffers.size(); i++) {
+    if (!usedBuffers[i])
+      continue;
+    reads.push_back([&file, &buffers, i] { buffers[i] = file.getBuffer(i); });
+  }
+  for (uint32_t i = 0; i < imageCount; i++) {
+    const auto &image = json.images->at(i);
+    if (!image.uri)
+      continue;
+    reads.push_back([&file, &images, &image, i] {
+      images[i] = file.bufferFromUri(*image.uri);
+    });
+  }
+  executor.parallelFor(reads.size(), [&reads](size_t i) { reads[i](); });
+
+  // the fallback buffers of EXT_meshopt_compression hold no data to copy
+  std::vector<std::optional<Buffer>> decoded(referenced.size());
+  std::vector<uint32_t> compressed;
+  for (uint32_t i = 0; i < referenced.size(); i++) {
+    if (referenced[i] && json.bufferViews->at(i).meshoptExtension)
+      compressed.push_back(i);
+  }
+  executor.parallelFor(
+      compressed.size(), [&json, &buffers, &decoded, &compressed](size_t i) {
+        auto index = compressed[i];
+        const auto &bufferView = json.bufferViews->at(index);
+        auto &bytes = decoded[index].emplace(bufferView.byteLength);
+        decodeMeshoptBufferView(
+            bufferView, index,
+            *buffers[bufferView.meshoptExtension->buffer], bytes.data());
+      });
+
+  GLBWriter writer(json);
+  std::vector<const Buffer *> bufferPtrs(buffers.size());
+  for (uint32_t i = 0; i < buffers.size(); i++) {
+    if (buffers[i])
+      bufferPtrs[i] = &writer.retainBuffer(std::move(*buffers[i]));
+  }
+  std::vector<const Buffer *> imagePtrs(images.size());
+  for (uint32_t i = 0; i < images.size(); i++) {
+    if (images[i])
+      imagePtrs[i] = &writer.retainBuffer(std::move(*images[i]));
+  }
+  std::vector<const Buffer *> decodedPtrs(decoded.size());
+  for (uint32_t i = 0; i < decoded.size(); i++) {
+    if (decoded[i])
+      decodedPtrs[i] = &writer.retainBuffer(std::move(*decoded[i]));
+  }
+  repackJson(writer, json, bufferPtrs, imagePtrs, decodedPtrs);
+  return writer;
+}
+
+GLBWriter GLTFRepack::repack(const GLTFData &data) {
+  const auto &json = data.json();
+  std::vector<const Buffer *> buffers(data.buffers().size());
+  for (uint32_t i = 0; i < buffers.size(); i++) {
+    buffers[i] = data.buffers()[i].get();
+  }
+  std::vector<const Buffer *> images(data.imageBuffers().size());
+  for (uint32_t i = 0; i < images.size(); i++) {
+    if (json.images->at(i).uri)
+      images[i] = data.imageBuffers()[i].get();
+  }
+  GLBWriter writer(json);
+  repackJson(writer, json, buffers, images);
+  return writer;
+}
+
+void GLTFRepack::repack(const std::filesystem::path &src,
+                        const std::filesystem::path &dst) {
+  repack(GLTFFile::parseFile(src)).write(dst);
+}
+
+} // namespace gltf2
@@ -0,0 +1,67 @@
+#include "LoadStats.h"
+#include <ctime>
+
+namespace gltf2 {
+
+std::chrono::nanoseconds threadCpuTime() {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+    return std::chrono::seconds(ts.tv_sec) +
+           std::chrono::nanoseconds(ts.tv_nsec);
+#endif
+  return std::chrono::nanoseconds(0);
+}
+
+void LoadStatsRecorder::reset() {
+  for (auto *counters : {&_wall, &_cpu}) {
+    for (auto &counter : *counters)
+      counter.store(0, std::memory_order_relaxed);
+  }
+  for (auto &counter : _bytes)
+    counter.store(0, std::memory_order_relaxed);
+  for (auto &counter : _counts)
+    counter.store(0, std::memory_order_relaxed);
+}
+
+LoadStats LoadStatsRecorder::stats() const {
+  auto load = [](const std::atomic<uint64_t> &counter) {
+    return counter.load(std::memory_order_relaxed);
+  };
+  auto phase = [this, &load](Phase phase) {
+    auto i = static_cast<size_t>(phase);
+    PhaseTime time;
+    time.wall = std::chrono::nanoseconds(load(_wall[i]));
+    time.cpu = std::chrono::nanoseconds(load(_cpu[i]));
+    return time;
+  };
+  auto bytes = [this, &load](Bytes category) {
+    return load(_bytes[static_cast<size_t>(category)]);
+  };
+  auto count = [this, &load](Count count) {
+    return load(_counts[static_cast<size_t>(count)]);
+  };
+
+  LoadStats stats;
+  stats.buffers = phase(Phase::Buffers);
+  stats.bufferViews = phase(Phase::BufferViews);
+  stats.accessorBuffers = phase(Phase::AccessorBuffers);
+  stats.imageBuffers = phase(Phase::ImageBuffers);
+  stats.meshPrimitives = phase(Phase::MeshPrimitives);
+  stats.dracoDecode = phase(Phase::DracoDecode);
+  stats.bytesFromFiles = bytes(Bytes::FromFiles);
+  stats.bytesFromDataUris = bytes(Bytes::FromDataUris);
+  stats.bufferBytes = bytes(Bytes::Buffers);
+  stats.accessorBytes = bytes(Bytes::Accessors);
+  stats.imageBytes = bytes(Bytes::Images);
+  stats.primitiveBytes = bytes(Bytes::Primitives);
+  stats.morphTargetBytes = bytes(Bytes::MorphTargets);
+  stats.tasks = count(Count::Tasks);
+  stats.normalizedAccessors = count(Count::NormalizedAccessors);
+  stats.sparseAccessors = count(Count::SparseAccessors);
+  stats.dracoPrimitives = count(Count::DracoPrimitives);
+  stats.meshoptBufferViews = count(Count::MeshoptBufferViews);
+  return stats;
+}
+
+} // namespace gltf2
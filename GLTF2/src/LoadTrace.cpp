@@ -0,0 +1,49 @@
+#include "LoadTrace.h"
+#include "nlohmann/json.hpp"
+
+namespace gltf2 {
+
+void ChromeTraceRecorder::record(const TraceEvent &event) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _threads.emplace(event.thread, (uint32_t)_threads.size() + 1);
+  _events.push_back(event);
+}
+
+std::vector<TraceEvent> ChromeTraceRecorder::events() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _events;
+}
+
+void ChromeTraceRecorder::write(std::ostream &os) const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto micros = [this](std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration<double, std::micro>(time - _origin).count();
+  };
+
+  auto events = nlohmann::json::array();
+  for (const auto &[thread, tid] : _threads) {
+    events.push_back({{"name", "thread_name"},
+                      {"ph", "M"},
+                      {"pid", 1},
+                      {"tid", tid},
+                      {"args", {{"name", "loader " + std::to_string(tid)}}}});
+  }
+  for (const auto &event : _events) {
+    nlohmann::json args = {{"bytes", event.bytes}};
+    if (event.index)
+      args["index"] = *event.index;
+    if (event.primitiveIndex)
+      args["primitive"] = *event.primitiveIndex;
+    events.push_back({{"name", event.name},
+                      {"cat", "gltf2"},
+                      {"ph", "X"},
+                      {"ts", micros(event.begin)},
+                      {"dur", micros(event.end) - micros(event.begin)},
+                      {"pid", 1},
+                      {"tid", _threads.at(event.thread)},
+                      {"args", args}});
+  }
+  os << nlohmann::json{{"traceEvents", events}, {"displayTimeUnit", "ms"}};
+}
+
+} // namespace gltf2
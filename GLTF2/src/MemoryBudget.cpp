@@ -0,0 +1,121 @@
+#include "MemoryBudget.h"
+#include "GLTFException.h"
+#include "JsonDecoder.h"
+#include <string>
+
+namespace gltf2 {
+
+uint64_t accessorMemory(const json::Accessor &accessor) {
+  uint64_t compTypeSize =
+      json::Accessor::sizeOfComponentType(accessor.componentType);
+  if (accessor.normalized.value_or(false) &&
+      accessor.componentType != json::Accessor::ComponentType::FLOAT &&
+      accessor.componentType != json::Accessor::ComponentType::UNSIGNED_INT) {
+    compTypeSize = sizeof(float);
+  }
+  return compTypeSize * json::Accessor::componentsCountOfType(accessor.type) *
+         accessor.count;
+}
+
+static const json::Accessor &accessorAt(const json::Json &json,
+                                       uint32_t index) {
+  if (!json.accessors || index >= json.accessors->size()) {
+    throw InvalidFormatException(
+        format("accessor index %u out of range", index));
+  }
+  return (*json.accessors)[index];
+}
+
+static uint64_t accessorsMemory(const json::Json &json,
+                                const std::optional<uint32_t> &index) {
+  return index ? accessorMemory(accessorAt(json, *index)) : 0;
+}
+
+static uint64_t
+accessorsMemory(const json::Json &json,
+                const std::optional<std::vector<uint32_t>> &indices) {
+  uint64_t bytes = 0;
+  if (indices) {
+    for (auto index : *indices)
+      bytes += accessorMemory(accessorAt(json, index));
+  }
+  return bytes;
+}
+
+static uint64_t targetMemory(const json::Json &json,
+                             const json::MeshPrimitiveTarget &target) {
+  return accessorsMemory(json, target.position) +
+         accessorsMemory(json, target.normal) +
+         accessorsMemory(json, target.tangent);
+}
+
+MemoryEstimate estimateMemory(const json::Json &json,
+                              const json::MeshPrimitive &primitive) {
+  MemoryEstimate estimate;
+  const auto &attributes = primitive.attributes;
+  estimate.primitives = targetMemory(json, attributes) +
+                        accessorsMemory(json, attributes.texcoords) +
+                        accessorsMemory(json, attributes.colors) +
+                        accessorsMemory(json, attributes.joints) +
+                        accessorsMemory(json, attributes.weights) +
+                        accessorsMemory(json, primitive.indices);
+  if (primitive.targets) {
+    for (const auto &target : *primitive.targets)
+      estimate.morphTargets += targetMemory(json, target);
+  }
+  return estimate;
+}
+
+MemoryEstimate estimateMemory(const json::Json &json) {
+  MemoryEstimate estimate;
+  if (json.buffers) {
+    for (const auto &buffer : *json.buffers)
+      estimate.buffers += buffer.byteLength;
+  }
+  if (json.accessors) {
+    for (const auto &accessor : *json.accessors)
+      estimate.accessors += accessorMemory(accessor);
+  }
+  if (json.images) {
+    for (const auto &image : *json.images) {
+      if (image.uri) {
+        if (image.uri->rfind("data:", 0) == 0) {
+          auto comma = image.uri->find(',');
+          if (comma != std::string::npos)
+            estimate.images += (image.uri->size() - comma - 1) / 4 * 3;
+        }
+      } else if (image.bufferView) {
+        auto index = *image.bufferView;
+        if (!json.bufferViews || index >= json.bufferViews->size()) {
+          throw InvalidFormatException(
+              format("bufferView index %u out of range", index));
+        }
+        estimate.images += (*json.bufferViews)[index].byteLength;
+      }
+    }
+  }
+  if (json.meshes) {
+    for (const auto &mesh : *json.meshes) {
+      for (const auto &primitive : mesh.primitives) {
+        auto primitiveEstimate = estimateMemory(json, primitive);
+        estimate.primitives += primitiveEstimate.primitives;
+        estimate.morphTargets += primitiveEstimate.morphTargets;
+      }
+    }
+  }
+  return estimate;
+}
+
+void MemoryCounter::reserve(uint64_t bytes, const char *what) {
+  auto total = _bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  if (_budget && total > *_budget) {
+    _bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    throw MemoryBudgetException(std::string(what) + " needs " +
+                                std::to_string(bytes) + " bytes, " +
+                                std::to_string(total - bytes) + " of " +
+                                std::to_string(*_budget) +
+                                " bytes are in use");
+  }
+}
+
+} // namespace gltf2
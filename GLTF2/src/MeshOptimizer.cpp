@@ -0,0 +1,170 @@
+#include "MeshOptimizer.h"
+#include "MeshPrimitiveHelpers.h"
+#include "PrimitiveRewriter.h"
+#include "meshoptimizer.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+namespace gltf2 {
+
+/**
+ * @brief Call `fn(source)` for every source of a primitive and of its morph
+ * targets.
+ */
+template <typename Primitive, typename Fn>
+static void forEachSource(Primitive &primitive, Fn &&fn) {
+  auto visit = [&fn](auto &sources) {
+    if (sources.position)
+      fn(*sources.position);
+    if (sources.normal)
+      fn(*sources.normal);
+    if (sources.tangent)
+      fn(*sources.tangent);
+    for (auto *sets : {&sources.texcoords, &sources.colors, &sources.joints,
+                       &sources.weights}) {
+      for (auto &source : *sets)
+        fn(source);
+    }
+  };
+  visit(primitive.sources);
+  for (auto &target : primitive.targets)
+    visit(target);
+}
+
+static void writeIndices(const std::vector<uint32_t> &indices,
+                         MeshPrimitiveElement &element) {
+  auto *data = element.buffer.data();
+  switch (element.componentType) {
+  case json::Accessor::ComponentType::UNSIGNED_BYTE:
+    std::copy(indices.begin(), indices.end(), data);
+    break;
+  case json::Accessor::ComponentType::UNSIGNED_SHORT:
+    std::copy(indices.begin(), indices.end(), (uint16_t *)data);
+    break;
+  default:
+    std::memcpy(data, indices.data(), indices.size() * sizeof(uint32_t));
+    break;
+  }
+}
+
+/**
+ * @brief Move the vertices of a source to their new indices in `remap`, and
+ * drop those it maps to `~0u`.
+ */
+static void remapSource(MeshPrimitiveSource &source,
+                        const std::vector<uint32_t> &remap,
+                        uint32_t vertexCount) {
+  auto elementSize =
+      json::Accessor::sizeOfComponentType(source.componentType) *
+      source.componentsPerVector;
+  if (source.sparse && !source.sparse->base) {
+    // only the replaced elements move, as the others are zeros
+    const auto &sparse = *source.sparse;
+    std::vector<std::pair<uint32_t, size_t>> moved;
+    for (size_t i = 0; i < sparse.indices.size(); i++) {
+      if (remap[sparse.indices[i]] != ~0u)
+        moved.emplace_back(remap[sparse.indices[i]], i);
+    }
+    std::sort(moved.begin(), moved.end());
+    auto remapped = std::make_shared<SparseAccessorBuffer>();
+    remapped->baseStride = sparse.baseStride;
+    remapped->count = vertexCount;
+    remapped->elementSize = sparse.elementSize;
+    remapped->values.resize(moved.size() * sparse.elementSize);
+    for (size_t i = 0; i < moved.size(); i++) {
+      remapped->indices.push_back(moved[i].first);
+      std::memcpy(remapped->values.data() + i * sparse.elementSize,
+                  sparse.values.data() + moved[i].second * sparse.elementSize,
+                  sparse.elementSize);
+    }
+    source.sparse = std::move(remapped);
+    source.vectorCount = vertexCount;
+    return;
+  }
+  auto vertices = source.sparse ? source.sparse->toBuffer() : source.buffer;
+  source.buffer.resize((size_t)vertexCount * elementSize);
+  meshopt_remapVertexBuffer(source.buffer.data(), vertices.data(),
+                            source.vectorCount, elementSize, remap.data());
+  source.sparse.reset();
+  source.vectorCount = vertexCount;
+}
+
+bool MeshOptimizer::optimize(MeshPrimitive &primitive) const {
+  const auto &position = primitive.sources.position;
+  if (!primitive.element || !position ||
+      primitive.element->primitiveMode != json::MeshPrimitive::Mode::TRIANGLES)
+    return false;
+  auto vertexCount = position->vectorCount;
+  bool sameCounts = true;
+  forEachSource(primitive, [&sameCounts, vertexCount](const auto &source) {
+    sameCounts = sameCounts && source.vectorCount == vertexCount;
+  });
+  std::vector<uint32_t> indices;
+  if (!sameCounts || !readIndices(*primitive.element, indices) ||
+      indices.size() % 3 != 0 ||
+      std::any_of(indices.begin(), indices.end(),
+                  [vertexCount](uint32_t i) { return i >= vertexCount; }))
+    return false;
+
+  if (_options.vertexCache) {
+    meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(),
+                                vertexCount);
+  }
+  if (_options.overdraw) {
+    auto positions = position->toFloatBuffer();
+    meshopt_optimizeOverdraw(indices.data(), indices.data(), indices.size(),
+                             (const float *)positions.data(), vertexCount,
+                             sizeof(float) * position->componentsPerVector,
+                             _options.overdrawThreshold);
+  }
+  if (_options.vertexFetch) {
+    std::vector<uint32_t> remap(vertexCount);
+    auto usedCount = (uint32_t)meshopt_optimizeVertexFetchRemap(
+        remap.data(), indices.data(), indices.size(), vertexCount);
+    meshopt_remapIndexBuffer(indices.data(), indices.data(), indices.size(),
+                             remap.data());
+    forEachSource(primitive, [&remap, usedCount](auto &source) {
+      remapSource(source, remap, usedCount);
+    });
+  }
+  writeIndices(indices, *primitive.element);
+  return true;
+}
+
+void MeshOptimizer::optimizeAll(const std::vector<MeshPrimitive *> &primitives,
+                                Executor &executor) const {
+  executor.parallelFor(primitives.size(),
+                       [&](size_t i) { optimize(*primitives[i]); });
+}
+
+GLBWriter MeshOptimizer::write(const GLTFData &data) {
+  PrimitiveRewriter rewriter(data);
+  auto &json = rewriter.json();
+  if (json.meshes) {
+    for (uint32_t i = 0; i < json.meshes->size(); i++) {
+      auto &mesh = json.meshes->at(i);
+      for (uint32_t j = 0; j < mesh.primitives.size(); j++) {
+        auto &primitive = mesh.primitives[j];
+        const auto &loaded = data.meshPrimitiveAt(i, j);
+        if (primitive.dracoExtension || !loaded.element ||
+            !loaded.sources.position)
+          continue;
+        auto count = loaded.sources.position->vectorCount;
+        primitive.attributes = rewriter.addSources(loaded.sources, count, true);
+        primitive.indices = rewriter.addElementAccessor(*loaded.element);
+        if (!primitive.targets)
+          continue;
+        for (size_t k = 0; k < primitive.targets->size(); k++) {
+          if (k < loaded.targets.size())
+            primitive.targets->at(k) =
+                rewriter.addTarget(loaded.targets[k], count);
+        }
+      }
+    }
+  }
+  return rewriter.write();
+}
+
+} // namespace gltf2
@@ -0,0 +1,44 @@
+#include "MeshPrimitiveHelpers.h"
+
+namespace gltf2 {
+
+json::Accessor::Type typeOfComponents(uint8_t components) {
+  switch (components) {
+  case 1:
+    return json::Accessor::Type::SCALAR;
+  case 2:
+    return json::Accessor::Type::VEC2;
+  case 3:
+    return json::Accessor::Type::VEC3;
+  case 9:
+    return json::Accessor::Type::MAT3;
+  case 16:
+    return json::Accessor::Type::MAT4;
+  default:
+    return json::Accessor::Type::VEC4;
+  }
+}
+
+bool readIndices(const MeshPrimitiveElement &element,
+                 std::vector<uint32_t> &indices) {
+  const auto *data = element.buffer.data();
+  switch (element.componentType) {
+  case json::Accessor::ComponentType::UNSIGNED_BYTE:
+    indices.assign(data, data + element.buffer.size());
+    return true;
+  case json::Accessor::ComponentType::UNSIGNED_SHORT: {
+    const auto *values = (const uint16_t *)data;
+    indices.assign(values, values + element.buffer.size() / 2);
+    return true;
+  }
+  case json::Accessor::ComponentType::UNSIGNED_INT: {
+    const auto *values = (const uint32_t *)data;
+    indices.assign(values, values + element.buffer.size() / 4);
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+} // namespace gltf2
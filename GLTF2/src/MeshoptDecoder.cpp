@@ -0,0 +1,119 @@
+#include "MeshoptDecoder.h"
+#include "GLTFException.h"
+#include "JsonDecoder.h"
+#include "meshoptimizer.h"
+
+namespace gltf2 {
+
+/**
+ * @brief Decode `extension.count` elements of `extension.byteStride` bytes
+ * from `src` into `dst` and apply the filter of the extension to them.
+ * @return 0 on success, or the error code of the meshoptimizer decoder.
+ */
+static int decodeMeshopt(const json::BufferViewMeshoptExtension &extension,
+                         const uint8_t *src, uint8_t *dst) {
+  using Mode = json::BufferViewMeshoptExtension::Mode;
+  using Filter = json::BufferViewMeshoptExtension::Filter;
+  int error = 0;
+  switch (extension.mode) {
+  case Mode::ATTRIBUTES:
+    error = meshopt_decodeVertexBuffer(dst, extension.count,
+                                       extension.byteStride, src,
+                                       extension.byteLength);
+    break;
+  case Mode::TRIANGLES:
+    error = meshopt_decodeIndexBuffer(dst, extension.count,
+                                      extension.byteStride, src,
+                                      extension.byteLength);
+    break;
+  case Mode::INDICES:
+    error = meshopt_decodeIndexSequence(dst, extension.count,
+                                        extension.byteStride, src,
+                                        extension.byteLength);
+    break;
+  }
+  if (error != 0)
+    return error;
+
+  switch (extension.filterValue()) {
+  case Filter::NONE:
+    break;
+  case Filter::OCTAHEDRAL:
+    meshopt_decodeFilterOct(dst, extension.count, extension.byteStride);
+    break;
+  case Filter::QUATERNION:
+    meshopt_decodeFilterQuat(dst, extension.count, extension.byteStride);
+    break;
+  case Filter::EXPONENTIAL:
+    meshopt_decodeFilterExp(dst, extension.count, extension.byteStride);
+    break;
+  }
+  return 0;
+}
+
+/**
+ * @brief Whether the byteStride of a meshopt bufferView is allowed for its
+ * mode and filter, which the decoders rely on.
+ */
+static bool
+isValidMeshoptStride(const json::BufferViewMeshoptExtension &extension) {
+  using Mode = json::BufferViewMeshoptExtension::Mode;
+  using Filter = json::BufferViewMeshoptExtension::Filter;
+  auto stride = extension.byteStride;
+  if (extension.mode != Mode::ATTRIBUTES) {
+    if (stride != 2 && stride != 4)
+      return false;
+    if (extension.mode == Mode::TRIANGLES && extension.count % 3 != 0)
+      return false;
+    return extension.filterValue() == Filter::NONE;
+  }
+  if (stride == 0 || stride % 4 != 0 || stride > 256)
+    return false;
+  switch (extension.filterValue()) {
+  case Filter::NONE:
+    return true;
+  case Filter::OCTAHEDRAL:
+    return stride == 4 || stride == 8;
+  case Filter::QUATERNION:
+    return stride == 8;
+  case Filter::EXPONENTIAL:
+    return true;
+  }
+  return false;
+}
+
+void decodeMeshoptBufferView(const json::BufferView &bufferView,
+                             uint32_t index, const Buffer &buffer,
+                             uint8_t *dst) {
+  const auto &extension = *bufferView.meshoptExtension;
+  if (!isValidMeshoptStride(extension)) {
+    throw InvalidFormatException(
+        format("bufferView %u has an invalid byteStride %u or count %u for "
+               "its EXT_meshopt_compression mode and filter",
+               index, extension.byteStride, extension.count));
+  }
+  if ((uint64_t)extension.count * extension.byteStride >
+      bufferView.byteLength) {
+    throw InvalidFormatException(
+        format("the EXT_meshopt_compression data of bufferView %u decodes to "
+               "more than its byteLength",
+               index));
+  }
+  if ((uint64_t)extension.byteOffset.value_or(0) + extension.byteLength >
+      buffer.size()) {
+    throw InvalidFormatException(
+        format("the EXT_meshopt_compression data of bufferView %u is out of "
+               "the range of buffer %u",
+               index, extension.buffer));
+  }
+  const uint8_t *src = buffer.data() + extension.byteOffset.value_or(0);
+  auto error = decodeMeshopt(extension, src, dst);
+  if (error != 0) {
+    throw InvalidFormatException(
+        format("failed to decode the EXT_meshopt_compression data of "
+               "bufferView %u (error %d)",
+               index, error));
+  }
+}
+
+} // namespace gltf2
@@ -0,0 +1,256 @@
+#include "PrimitiveRewriter.h"
+#include "AccessorConversion.h"
+#include "GLBFormat.h"
+#include "JsonReferences.h"
+#include "MeshPrimitiveHelpers.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace gltf2 {
+
+static const uint32_t ArrayBufferTarget = 34962;
+static const uint32_t ElementArrayBufferTarget = 34963;
+
+static std::vector<bool> referencedObjects(const json::Json &json,
+                                           json::ReferenceKind kind,
+                                           size_t count) {
+  std::vector<bool> referenced(count);
+  json::forEachReference(
+      json, [&referenced, kind](json::ReferenceKind refKind, uint32_t index) {
+        if (refKind == kind && index < referenced.size())
+          referenced[index] = true;
+      });
+  return referenced;
+}
+
+/**
+ * @brief Set the bounds of the components as they are stored, without
+ * dequantizing normalized ones.
+ */
+static void setBounds(json::Accessor &accessor,
+                      const MeshPrimitiveSource &source, const uint8_t *data) {
+  auto components = source.componentsPerVector;
+  auto elementSize =
+      json::Accessor::sizeOfComponentType(source.componentType) * components;
+  std::vector<float> values((size_t)source.vectorCount * components);
+  accessorConverter<float>(source.componentType, accessor.type, false)(
+      data, elementSize, source.vectorCount, values.data());
+  auto &min = accessor.min.emplace(components,
+                                   std::numeric_limits<float>::max());
+  auto &max = accessor.max.emplace(components,
+                                   std::numeric_limits<float>::lowest());
+  for (size_t i = 0; i < values.size(); i++) {
+    min[i % components] = std::min(min[i % components], values[i]);
+    max[i % components] = std::max(max[i % components], values[i]);
+  }
+}
+
+PrimitiveRewriter::PrimitiveRewriter(const GLTFData &data)
+    : _data(data), _json(data.json()) {
+  _bufferViewCount =
+      _json.bufferViews ? (uint32_t)_json.bufferViews->size() : 0;
+  _usedAccessors =
+      referencedObjects(_json, json::ReferenceKind::Accessor,
+                        _json.accessors ? _json.accessors->size() : 0);
+}
+
+uint32_t PrimitiveRewriter::addBufferView(Payload payload,
+                                          std::optional<uint32_t> byteStride,
+                                          std::optional<uint32_t> target) {
+  if (!_json.bufferViews)
+    _json.bufferViews.emplace();
+  // the buffer and offset are those of the written payload
+  json::BufferView bufferView;
+  bufferView.buffer = 0;
+  bufferView.byteLength = payload.bytes;
+  bufferView.byteStride = byteStride;
+  bufferView.target = target;
+  _json.bufferViews->push_back(bufferView);
+  _payloads.push_back(payload);
+  return (uint32_t)_json.bufferViews->size() - 1;
+}
+
+uint32_t PrimitiveRewriter::addBufferView(const uint8_t *data, uint32_t bytes,
+                                          std::optional<uint32_t> byteStride,
+                                          std::optional<uint32_t> target) {
+  return addBufferView(Payload{data, bytes, std::nullopt}, byteStride, target);
+}
+
+uint32_t PrimitiveRewriter::addBufferView(Buffer &&buffer,
+                                          std::optional<uint32_t> byteStride,
+                                          std::optional<uint32_t> target) {
+  auto bytes = (uint32_t)buffer.size();
+  _buffers.push_back(std::move(buffer));
+  return addBufferView(Payload{nullptr, bytes, _buffers.size() - 1},
+                       byteStride, target);
+}
+
+uint32_t PrimitiveRewriter::addAccessor(const json::Accessor &accessor) {
+  if (!_json.accessors)
+    _json.accessors.emplace();
+  _json.accessors->push_back(accessor);
+  return (uint32_t)_json.accessors->size() - 1;
+}
+
+uint32_t PrimitiveRewriter::addSourceAccessor(const MeshPrimitiveSource &source,
+                                              uint32_t count, bool stored,
+                                              bool isPosition) {
+  json::Accessor accessor;
+  accessor.componentType = source.componentType;
+  if (source.normalized)
+    accessor.normalized = true;
+  accessor.count = count;
+  accessor.type = typeOfComponents(source.componentsPerVector);
+
+  Buffer dense;
+  const uint8_t *data = source.buffer.data();
+  if (source.sparse) {
+    dense = source.sparse->toBuffer();
+    data = dense.data();
+  }
+  if (isPosition)
+    setBounds(accessor, source, data);
+  if (!stored)
+    return addAccessor(accessor);
+
+  auto elementSize =
+      json::Accessor::sizeOfComponentType(source.componentType) *
+      source.componentsPerVector;
+  if (elementSize % 4 == 0) {
+    auto bytes = (uint32_t)(elementSize * count);
+    accessor.bufferView =
+        source.sparse
+            ? addBufferView(std::move(dense), std::nullopt, ArrayBufferTarget)
+            : addBufferView(data, bytes, std::nullopt, ArrayBufferTarget);
+    return addAccessor(accessor);
+  }
+  // every vertex attribute element must start at a multiple of 4 bytes
+  auto stride = (elementSize + 3) / 4 * 4;
+  Buffer padded((size_t)stride * count);
+  for (size_t i = 0; i < count; i++)
+    std::memcpy(padded.data() + i * stride, data + i * elementSize,
+                elementSize);
+  accessor.bufferView =
+      addBufferView(std::move(padded), stride, ArrayBufferTarget);
+  return addAccessor(accessor);
+}
+
+json::MeshPrimitiveAttributes
+PrimitiveRewriter::addSources(const MeshPrimitiveSources &sources,
+                              uint32_t count, bool stored) {
+  json::MeshPrimitiveAttributes attributes;
+  if (sources.position)
+    attributes.position =
+        addSourceAccessor(*sources.position, count, stored, true);
+  if (sources.normal)
+    attributes.normal = addSourceAccessor(*sources.normal, count, stored);
+  if (sources.tangent)
+    attributes.tangent = addSourceAccessor(*sources.tangent, count, stored);
+  auto addEach = [this, count,
+                  stored](const std::vector<MeshPrimitiveSource> &sources,
+                          std::optional<std::vector<uint32_t>> &indices) {
+    if (sources.empty())
+      return;
+    indices.emplace();
+    for (const auto &source : sources)
+      indices->push_back(addSourceAccessor(source, count, stored));
+  };
+  addEach(sources.texcoords, attributes.texcoords);
+  addEach(sources.colors, attributes.colors);
+  addEach(sources.joints, attributes.joints);
+  addEach(sources.weights, attributes.weights);
+  return attributes;
+}
+
+json::MeshPrimitiveTarget
+PrimitiveRewriter::addTarget(const MeshPrimitiveSources &target,
+                             uint32_t count) {
+  auto attributes = addSources(target, count, true);
+  json::MeshPrimitiveTarget result;
+  result.position = attributes.position;
+  result.normal = attributes.normal;
+  result.tangent = attributes.tangent;
+  return result;
+}
+
+uint32_t
+PrimitiveRewriter::addElementAccessor(const MeshPrimitiveElement &element) {
+  json::Accessor accessor;
+  accessor.componentType = element.componentType;
+  accessor.count = (uint32_t)(element.buffer.size() /
+                              json::Accessor::sizeOfComponentType(
+                                  element.componentType));
+  accessor.type = json::Accessor::Type::SCALAR;
+  accessor.bufferView =
+      addBufferView(element.buffer.data(), (uint32_t)element.buffer.size(),
+                    std::nullopt, ElementArrayBufferTarget);
+  return addAccessor(accessor);
+}
+
+void PrimitiveRewriter::removeReplacedAccessors() {
+  auto &accessors = *_json.accessors;
+  auto used = referencedObjects(_json, json::ReferenceKind::Accessor,
+                                accessors.size());
+  std::vector<uint32_t> remap(accessors.size());
+  std::vector<json::Accessor> kept;
+  for (uint32_t i = 0; i < accessors.size(); i++) {
+    if (i < _usedAccessors.size() && _usedAccessors[i] && !used[i])
+      continue;
+    remap[i] = (uint32_t)kept.size();
+    kept.push_back(std::move(accessors[i]));
+  }
+  accessors = std::move(kept);
+  json::forEachReference(
+      _json, [&remap](json::ReferenceKind kind, uint32_t &index) {
+        if (kind == json::ReferenceKind::Accessor)
+          index = remap[index];
+      });
+}
+
+GLBWriter PrimitiveRewriter::write() {
+  if (_json.accessors)
+    removeReplacedAccessors();
+  auto used =
+      referencedObjects(_json, json::ReferenceKind::BufferView,
+                        _json.bufferViews ? _json.bufferViews->size() : 0);
+  std::vector<json::BufferView> bufferViews;
+  if (_json.bufferViews)
+    bufferViews = *_json.bufferViews;
+  GLBWriter writer(std::move(_json));
+  std::vector<uint32_t> remap(used.size());
+  for (uint32_t i = 0; i < used.size(); i++) {
+    if (!used[i])
+      continue;
+    const auto &bufferView = bufferViews[i];
+    if (i < _bufferViewCount) {
+      const auto &payload = _data.bufferViewAt(i);
+      remap[i] = writer.addBufferView(payload.data, payload.bytes,
+                                      GLBChunkAlignment, bufferView.byteStride,
+                                      bufferView.target, bufferView.name);
+      continue;
+    }
+    const auto &payload = _payloads[i - _bufferViewCount];
+    if (payload.buffer) {
+      remap[i] = writer.addBufferView(std::move(_buffers[*payload.buffer]),
+                                      GLBChunkAlignment, bufferView.byteStride,
+                                      bufferView.target);
+    } else {
+      remap[i] = writer.addBufferView(payload.data, payload.bytes,
+                                      GLBChunkAlignment, bufferView.byteStride,
+                                      bufferView.target);
+    }
+  }
+  json::forEachReference(
+      writer.json(), [&remap](json::ReferenceKind kind, uint32_t &index) {
+        if (kind == json::ReferenceKind::BufferView)
+          index = remap[index];
+      });
+  _json = json::Json();
+  _payloads.clear();
+  _buffers.clear();
+  return writer;
+}
+
+} // namespace gltf2
@@ -0,0 +1,290 @@
+#include "VertexLayout.h"
+#include "AccessorConversion.h"
+#include "GLTFException.h"
+#include "MeshPrimitiveHelpers.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+namespace gltf2 {
+
+uint32_t componentsOfVertexFormat(VertexFormat format) {
+  switch (format) {
+  case VertexFormat::Float32:
+    return 1;
+  case VertexFormat::Float32x2:
+  case VertexFormat::Float16x2:
+  case VertexFormat::Snorm16x2:
+  case VertexFormat::Unorm16x2:
+    return 2;
+  case VertexFormat::Float32x3:
+    return 3;
+  case VertexFormat::Float32x4:
+  case VertexFormat::Float16x4:
+  case VertexFormat::Snorm16x4:
+  case VertexFormat::Unorm16x4:
+  case VertexFormat::Snorm8x4:
+  case VertexFormat::Unorm8x4:
+  case VertexFormat::Uint16x4:
+  case VertexFormat::Uint8x4:
+    return 4;
+  }
+  return 0;
+}
+
+uint32_t sizeOfVertexFormat(VertexFormat format) {
+  switch (format) {
+  case VertexFormat::Float32:
+  case VertexFormat::Float32x2:
+  case VertexFormat::Float32x3:
+  case VertexFormat::Float32x4:
+    return 4 * componentsOfVertexFormat(format);
+  case VertexFormat::Float16x2:
+  case VertexFormat::Float16x4:
+  case VertexFormat::Snorm16x2:
+  case VertexFormat::Snorm16x4:
+  case VertexFormat::Unorm16x2:
+  case VertexFormat::Unorm16x4:
+  case VertexFormat::Uint16x4:
+    return 2 * componentsOfVertexFormat(format);
+  case VertexFormat::Snorm8x4:
+  case VertexFormat::Unorm8x4:
+  case VertexFormat::Uint8x4:
+    return 4;
+  }
+  return 0;
+}
+
+namespace {
+
+/// The vertices converted at a time; the floats of a block of 4-component
+/// vertices take 4 KiB.
+const size_t blockVertices = 256;
+
+/// Stores `count` vertices of floats with `components` each into elements
+/// `stride` bytes apart at `dst`.
+using ElementStore = void (*)(const float *src, uint32_t components,
+                              size_t count, uint8_t *dst, size_t stride);
+
+inline float paddedComponent(const float *vertex, uint32_t components,
+                             size_t j) {
+  return j < components ? vertex[j] : (j == 3 ? 1.0f : 0.0f);
+}
+
+template <typename Dst, size_t N, bool Normalized>
+void storeElements(const float *src, uint32_t components, size_t count,
+                   uint8_t *dst, size_t stride) {
+  for (size_t i = 0; i < count; i++) {
+    Dst element[N];
+    for (size_t j = 0; j < N; j++) {
+      element[j] = convertComponent<float, Dst, Normalized>(
+          paddedComponent(src + i * components, components, j));
+    }
+    std::memcpy(dst + i * stride, element, sizeof(element));
+  }
+}
+
+template <size_t N>
+void storeHalfs(const float *src, uint32_t components, size_t count,
+                uint8_t *dst, size_t stride) {
+  // the caller converts the vertices in blocks of at most blockVertices
+  assert(count <= blockVertices);
+  count = std::min(count, blockVertices);
+  float padded[blockVertices * N] = {};
+  for (size_t i = 0; i < count; i++) {
+    for (size_t j = 0; j < N; j++)
+      padded[i * N + j] = paddedComponent(src + i * components, components, j);
+  }
+  uint16_t halfs[blockVertices * N] = {};
+  floatsToHalfs(padded, count * N, halfs);
+  for (size_t i = 0; i < count; i++)
+    std::memcpy(dst + i * stride, halfs + i * N, sizeof(uint16_t) * N);
+}
+
+ElementStore elementStoreOf(VertexFormat format) {
+  switch (format) {
+  case VertexFormat::Float32:
+    return &storeElements<float, 1, false>;
+  case VertexFormat::Float32x2:
+    return &storeElements<float, 2, false>;
+  case VertexFormat::Float32x3:
+    return &storeElements<float, 3, false>;
+  case VertexFormat::Float32x4:
+    return &storeElements<float, 4, false>;
+  case VertexFormat::Float16x2:
+    return &storeHalfs<2>;
+  case VertexFormat::Float16x4:
+    return &storeHalfs<4>;
+  case VertexFormat::Snorm16x2:
+    return &storeElements<int16_t, 2, true>;
+  case VertexFormat::Snorm16x4:
+    return &storeElements<int16_t, 4, true>;
+  case VertexFormat::Unorm16x2:
+    return &storeElements<uint16_t, 2, true>;
+  case VertexFormat::Unorm16x4:
+    return &storeElements<uint16_t, 4, true>;
+  case VertexFormat::Snorm8x4:
+    return &storeElements<int8_t, 4, true>;
+  case VertexFormat::Unorm8x4:
+    return &storeElements<uint8_t, 4, true>;
+  case VertexFormat::Uint16x4:
+    return &storeElements<uint16_t, 4, false>;
+  case VertexFormat::Uint8x4:
+    return &storeElements<uint8_t, 4, false>;
+  }
+  return nullptr;
+}
+
+const MeshPrimitiveSource *sourceOf(const MeshPrimitiveSources &sources,
+                                    const VertexElement &element) {
+  auto setOf = [&element](const std::vector<MeshPrimitiveSource> &sets)
+      -> const MeshPrimitiveSource * {
+    return element.set < sets.size() ? &sets[element.set] : nullptr;
+  };
+  auto optionalOf = [](const std::optional<MeshPrimitiveSource> &source) {
+    return source ? &*source : nullptr;
+  };
+  switch (element.attribute) {
+  case VertexAttribute::Position:
+    return optionalOf(sources.position);
+  case VertexAttribute::Normal:
+    return optionalOf(sources.normal);
+  case VertexAttribute::Tangent:
+    return optionalOf(sources.tangent);
+  case VertexAttribute::Texcoord:
+    return setOf(sources.texcoords);
+  case VertexAttribute::Color:
+    return setOf(sources.colors);
+  case VertexAttribute::Joints:
+    return setOf(sources.joints);
+  case VertexAttribute::Weights:
+    return setOf(sources.weights);
+  }
+  return nullptr;
+}
+
+} // namespace
+
+VertexBufferBuilder::VertexBufferBuilder(VertexLayout layout)
+    : _layout(std::move(layout)) {
+  uint32_t end = 0;
+  uint32_t vertexEnd = 0;
+  for (const auto &element : _layout.elements) {
+    auto alignment = std::max<uint32_t>(element.alignment, 1);
+    auto offset = element.offset.value_or((end + alignment - 1) / alignment *
+                                          alignment);
+    if (offset % alignment != 0)
+      throw InputException("vertex element offset is not aligned");
+    auto size = sizeOfVertexFormat(element.format);
+    for (size_t i = 0; i < _offsets.size(); i++) {
+      auto otherSize = sizeOfVertexFormat(_layout.elements[i].format);
+      if (offset < _offsets[i] + otherSize && _offsets[i] < offset + size)
+        throw InputException("vertex elements overlap");
+    }
+    _offsets.push_back(offset);
+    end = offset + size;
+    vertexEnd = std::max(vertexEnd, end);
+  }
+  auto strideAlignment = std::max<uint32_t>(_layout.strideAlignment, 1);
+  _stride = _layout.stride.value_or((vertexEnd + strideAlignment - 1) /
+                                    strideAlignment * strideAlignment);
+  if (_stride < vertexEnd)
+    throw InputException("vertex stride is smaller than a vertex");
+}
+
+void VertexBufferBuilder::build(const MeshPrimitiveSources &sources,
+                                uint32_t vertexCount, uint8_t *dst) const {
+  struct Input {
+    const uint8_t *data;
+    uint32_t elementSize;
+    uint8_t components;
+    /// Null when the source is already floats.
+    AccessorConverter<float> convert;
+    ElementStore store;
+    uint32_t offset;
+  };
+  std::vector<Input> inputs;
+  std::vector<Buffer> denseSources;
+  uint32_t writtenBytes = 0;
+  for (size_t i = 0; i < _layout.elements.size(); i++) {
+    const auto &element = _layout.elements[i];
+    const auto *source = sourceOf(sources, element);
+    if (!source)
+      continue;
+    if (source->vectorCount != vertexCount)
+      throw InputException("vertex attributes must have the same count");
+    if (source->componentsPerVector > 4)
+      throw InputException("vertex attributes have at most 4 components");
+    Input input;
+    input.data = source->buffer.data();
+    if (source->sparse) {
+      denseSources.push_back(source->sparse->toBuffer());
+      input.data = denseSources.back().data();
+    }
+    input.elementSize =
+        json::Accessor::sizeOfComponentType(source->componentType) *
+        source->componentsPerVector;
+    input.components = source->componentsPerVector;
+    input.convert = nullptr;
+    if (source->componentType != json::Accessor::ComponentType::FLOAT) {
+      input.convert = accessorConverter<float>(
+          source->componentType, typeOfComponents(source->componentsPerVector),
+          source->normalized);
+    }
+    input.store = elementStoreOf(element.format);
+    input.offset = _offsets[i];
+    inputs.push_back(input);
+    writtenBytes += sizeOfVertexFormat(element.format);
+  }
+  // padding and missing attributes are zeros
+  if (writtenBytes < _stride)
+    std::memset(dst, 0, (size_t)_stride * vertexCount);
+
+  float block[blockVertices * 4];
+  for (size_t begin = 0; begin < vertexCount; begin += blockVertices) {
+    auto count = std::min<size_t>(blockVertices, vertexCount - begin);
+    for (const auto &input : inputs) {
+      const auto *src = input.data + begin * input.elementSize;
+      const float *floats = (const float *)src;
+      if (input.convert) {
+        input.convert(src, input.elementSize, count, block);
+        floats = block;
+      }
+      input.store(floats, input.components, count,
+                  dst + begin * _stride + input.offset, _stride);
+    }
+  }
+}
+
+InterleavedVertices
+VertexBufferBuilder::build(const MeshPrimitive &primitive) const {
+  InterleavedVertices vertices;
+  const auto &position = primitive.sources.position;
+  vertices.vertexCount = position ? position->vectorCount : 0;
+  vertices.buffer.resize((size_t)_stride * vertices.vertexCount);
+  build(primitive.sources, vertices.vertexCount, vertices.buffer.data());
+  return vertices;
+}
+
+std::vector<std::vector<InterleavedVertices>>
+VertexBufferBuilder::buildAll(const GLTFData &data, Executor &executor) const {
+  std::vector<std::vector<InterleavedVertices>> meshes;
+  std::vector<std::pair<uint32_t, uint32_t>> primitives;
+  if (data.json().meshes) {
+    const auto &jsonMeshes = *data.json().meshes;
+    meshes.resize(jsonMeshes.size());
+    for (uint32_t i = 0; i < jsonMeshes.size(); i++) {
+      meshes[i].resize(jsonMeshes[i].primitives.size());
+      for (uint32_t j = 0; j < jsonMeshes[i].primitives.size(); j++)
+        primitives.emplace_back(i, j);
+    }
+  }
+  executor.parallelFor(primitives.size(), [&](size_t i) {
+    auto [mesh, primitive] = primitives[i];
+    meshes[mesh][primitive] = build(data.meshPrimitiveAt(mesh, primitive));
+  });
+  return meshes;
+}
+
+} // namespace gltf2
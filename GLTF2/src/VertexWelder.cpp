@@ -0,0 +1,318 @@
+#include "VertexWelder.h"
+#include "MeshPrimitiveHelpers.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace gltf2 {
+
+namespace {
+
+/// The vertices a task of `parallelFor` handles at a time.
+const size_t chunkVertices = 16384;
+
+const uint32_t emptySlot = std::numeric_limits<uint32_t>::max();
+
+/// A source packed into the keys of the vertices.
+struct KeyStream {
+  const uint8_t *data;
+  uint32_t elementSize;
+  uint8_t components;
+  /// The grid size of float components, or 0 to pack them as they are.
+  float epsilon;
+  uint32_t keyOffset;
+};
+
+uint32_t elementSizeOf(const MeshPrimitiveSource &source) {
+  return json::Accessor::sizeOfComponentType(source.componentType) *
+         source.componentsPerVector;
+}
+
+size_t chunksOf(size_t count) {
+  return (count + chunkVertices - 1) / chunkVertices;
+}
+
+/// Call `fn(i)` for every `i` in `[0, count)` in chunks on `executor`.
+template <typename Fn>
+void parallelForEach(Executor &executor, size_t count, Fn &&fn) {
+  executor.parallelFor(chunksOf(count), [count, &fn](size_t chunk) {
+    auto end = std::min(count, (chunk + 1) * chunkVertices);
+    for (size_t i = chunk * chunkVertices; i < end; i++)
+      fn(i);
+  });
+}
+
+uint32_t hashOfKey(const uint8_t *key, size_t size) {
+  uint64_t hash = 0x9e3779b97f4a7c15ull;
+  for (size_t i = 0; i < size; i += 4) {
+    uint32_t word;
+    std::memcpy(&word, key + i, 4);
+    hash = (hash ^ word) * 0xff51afd7ed558ccdull;
+    hash ^= hash >> 32;
+  }
+  return (uint32_t)hash;
+}
+
+/**
+ * @brief The vertex keys of a primitive in an open addressing table of vertex
+ * indices, which holds the smallest index of every set of equal keys.
+ */
+class VertexTable {
+public:
+  VertexTable(const uint8_t *keys, size_t keySize,
+              const std::vector<uint32_t> &hashes)
+      : _keys(keys), _keySize(keySize), _hashes(hashes) {
+    size_t capacity = 16;
+    while (capacity < hashes.size() * 2)
+      capacity *= 2;
+    _slots = std::make_unique<std::atomic<uint32_t>[]>(capacity);
+    _mask = capacity - 1;
+  }
+
+  void clear(Executor &executor) {
+    parallelForEach(executor, _mask + 1, [this](size_t i) {
+      _slots[i].store(emptySlot, std::memory_order_relaxed);
+    });
+  }
+
+  /// Insert a vertex concurrently with others.
+  void insert(uint32_t vertex) {
+    for (auto slot = _hashes[vertex] & _mask;; slot = (slot + 1) & _mask) {
+      auto current = _slots[slot].load();
+      if (current == emptySlot) {
+        if (_slots[slot].compare_exchange_strong(current, vertex))
+          return;
+        // another vertex took the slot first
+      }
+      if (!equals(current, vertex))
+        continue;
+      // the slot only ever holds vertices with this key
+      while (vertex < current &&
+             !_slots[slot].compare_exchange_weak(current, vertex)) {
+      }
+      return;
+    }
+  }
+
+  /// The smallest vertex with the key of an inserted vertex.
+  uint32_t find(uint32_t vertex) const {
+    for (auto slot = _hashes[vertex] & _mask;; slot = (slot + 1) & _mask) {
+      auto current = _slots[slot].load(std::memory_order_relaxed);
+      if (equals(current, vertex))
+        return current;
+    }
+  }
+
+private:
+  const uint8_t *_keys;
+  size_t _keySize;
+  const std::vector<uint32_t> &_hashes;
+  std::unique_ptr<std::atomic<uint32_t>[]> _slots;
+  size_t _mask;
+
+  bool equals(uint32_t lhs, uint32_t rhs) const {
+    return _hashes[lhs] == _hashes[rhs] &&
+           std::memcmp(_keys + lhs * _keySize, _keys + rhs * _keySize,
+                       _keySize) == 0;
+  }
+};
+
+/**
+ * @brief Call `fn(source, epsilon)` for every source of a primitive and of
+ * its morph targets, with the grid size of its float components.
+ */
+template <typename Fn>
+void forEachSource(MeshPrimitive &primitive, const VertexWeldOptions &options,
+                   Fn &&fn) {
+  auto visit = [&fn](MeshPrimitiveSources &sources, float positionEpsilon,
+                     float normalEpsilon) {
+    if (sources.position)
+      fn(*sources.position, positionEpsilon);
+    if (sources.normal)
+      fn(*sources.normal, normalEpsilon);
+    if (sources.tangent)
+      fn(*sources.tangent, 0.0f);
+    for (auto *sets : {&sources.texcoords, &sources.colors, &sources.joints,
+                       &sources.weights}) {
+      for (auto &source : *sets)
+        fn(source, 0.0f);
+    }
+  };
+  visit(primitive.sources, options.positionEpsilon, options.normalEpsilon);
+  // morph targets displace welded vertices alike only if they are equal
+  for (auto &target : primitive.targets)
+    visit(target, 0.0f, 0.0f);
+}
+
+/**
+ * @brief The narrowest of `type` and wider index types whose maximum value,
+ * reserved for primitive restart, is above the indices.
+ */
+json::Accessor::ComponentType indexTypeOf(json::Accessor::ComponentType type,
+                                          uint32_t vertexCount) {
+  if (type == json::Accessor::ComponentType::UNSIGNED_BYTE &&
+      vertexCount <= std::numeric_limits<uint8_t>::max())
+    return type;
+  if (type != json::Accessor::ComponentType::UNSIGNED_INT &&
+      vertexCount <= std::numeric_limits<uint16_t>::max())
+    return json::Accessor::ComponentType::UNSIGNED_SHORT;
+  return json::Accessor::ComponentType::UNSIGNED_INT;
+}
+
+Buffer bufferOfIndices(const std::vector<uint32_t> &indices,
+                       json::Accessor::ComponentType type) {
+  Buffer buffer(indices.size() * json::Accessor::sizeOfComponentType(type));
+  switch (type) {
+  case json::Accessor::ComponentType::UNSIGNED_BYTE:
+    std::copy(indices.begin(), indices.end(), buffer.data());
+    break;
+  case json::Accessor::ComponentType::UNSIGNED_SHORT:
+    std::copy(indices.begin(), indices.end(), (uint16_t *)buffer.data());
+    break;
+  default:
+    std::memcpy(buffer.data(), indices.data(), buffer.size());
+    break;
+  }
+  return buffer;
+}
+
+} // namespace
+
+bool VertexWelder::weld(MeshPrimitive &primitive,
+                        json::MeshPrimitive::Mode mode,
+                        Executor &executor) const {
+  const auto &position = primitive.sources.position;
+  if (!position || position->vectorCount == 0)
+    return false;
+  auto vertexCount = position->vectorCount;
+
+  std::vector<Buffer> denseSources;
+  std::vector<KeyStream> streams;
+  uint32_t keySize = 0;
+  bool sameCounts = true;
+  auto addStream = [&](const MeshPrimitiveSource &source, float epsilon) {
+    sameCounts = sameCounts && source.vectorCount == vertexCount;
+    KeyStream stream;
+    stream.data = source.buffer.data();
+    if (source.sparse) {
+      denseSources.push_back(source.sparse->toBuffer());
+      stream.data = denseSources.back().data();
+    }
+    stream.elementSize = elementSizeOf(source);
+    stream.components = source.componentsPerVector;
+    stream.epsilon =
+        source.componentType == json::Accessor::ComponentType::FLOAT ? epsilon
+                                                                     : 0.0f;
+    stream.keyOffset = keySize;
+    // snapped components are 64-bit grid coordinates
+    keySize +=
+        stream.epsilon > 0.0f ? 8 * stream.components : stream.elementSize;
+    streams.push_back(stream);
+  };
+  forEachSource(primitive, _options, addStream);
+  std::vector<uint32_t> indices;
+  if (!sameCounts ||
+      (primitive.element && !readIndices(*primitive.element, indices)) ||
+      std::any_of(indices.begin(), indices.end(),
+                  [vertexCount](uint32_t i) { return i >= vertexCount; }))
+    return false;
+  keySize = (keySize + 3) / 4 * 4;
+
+  // pack and hash the keys, zeroing the padding
+  Buffer keys((size_t)vertexCount * keySize);
+  std::vector<uint32_t> hashes(vertexCount);
+  parallelForEach(executor, vertexCount, [&](size_t i) {
+    auto *key = keys.data() + i * keySize;
+    std::memset(key, 0, keySize);
+    for (const auto &stream : streams) {
+      const auto *element = stream.data + i * stream.elementSize;
+      if (stream.epsilon == 0.0f) {
+        std::memcpy(key + stream.keyOffset, element, stream.elementSize);
+        continue;
+      }
+      for (size_t c = 0; c < stream.components; c++) {
+        float value;
+        std::memcpy(&value, element + c * 4, 4);
+        auto cell = (int64_t)std::floor((double)value / stream.epsilon + 0.5);
+        std::memcpy(key + stream.keyOffset + c * 8, &cell, 8);
+      }
+    }
+    hashes[i] = hashOfKey(key, keySize);
+  });
+
+  VertexTable table(keys.data(), keySize, hashes);
+  table.clear(executor);
+  parallelForEach(executor, vertexCount,
+                  [&table](size_t i) { table.insert((uint32_t)i); });
+  // every vertex refers to the first vertex with its key
+  std::vector<uint32_t> remap(vertexCount);
+  parallelForEach(executor, vertexCount,
+                  [&](size_t i) { remap[i] = table.find((uint32_t)i); });
+
+  // number the kept vertices in order: count them per chunk, then offset
+  // each chunk by the counts of those before it
+  auto chunks = chunksOf(vertexCount);
+  std::vector<uint32_t> chunkOffsets(chunks + 1);
+  executor.parallelFor(chunks, [&](size_t chunk) {
+    auto end = std::min<size_t>(vertexCount, (chunk + 1) * chunkVertices);
+    uint32_t kept = 0;
+    for (size_t i = chunk * chunkVertices; i < end; i++)
+      kept += remap[i] == i;
+    chunkOffsets[chunk + 1] = kept;
+  });
+  for (size_t chunk = 0; chunk < chunks; chunk++)
+    chunkOffsets[chunk + 1] += chunkOffsets[chunk];
+  auto weldedCount = chunkOffsets[chunks];
+  // the new index of every kept vertex
+  std::vector<uint32_t> welded(vertexCount, emptySlot);
+  executor.parallelFor(chunks, [&](size_t chunk) {
+    auto end = std::min<size_t>(vertexCount, (chunk + 1) * chunkVertices);
+    auto next = chunkOffsets[chunk];
+    for (size_t i = chunk * chunkVertices; i < end; i++) {
+      if (remap[i] == i)
+        welded[i] = next++;
+    }
+  });
+  // the first vertex of a key is always numbered by now
+  parallelForEach(executor, vertexCount,
+                  [&](size_t i) { remap[i] = welded[remap[i]]; });
+
+  auto weldSource = [&](MeshPrimitiveSource &source, float) {
+    auto elementSize = elementSizeOf(source);
+    auto vertices =
+        source.sparse ? source.sparse->toBuffer() : std::move(source.buffer);
+    source.buffer = Buffer((size_t)weldedCount * elementSize);
+    parallelForEach(executor, vertexCount, [&](size_t i) {
+      if (welded[i] != emptySlot) {
+        std::memcpy(source.buffer.data() + (size_t)welded[i] * elementSize,
+                    vertices.data() + i * elementSize, elementSize);
+      }
+    });
+    source.sparse.reset();
+    source.vectorCount = weldedCount;
+  };
+  if (weldedCount < vertexCount)
+    forEachSource(primitive, _options, weldSource);
+
+  if (!primitive.element) {
+    MeshPrimitiveElement element;
+    element.primitiveMode = mode;
+    element.primitiveCount = primitiveCountOfMode(mode, vertexCount);
+    element.componentType = json::Accessor::ComponentType::UNSIGNED_BYTE;
+    primitive.element = element;
+    indices = std::move(remap);
+  } else {
+    for (auto &index : indices)
+      index = remap[index];
+  }
+  auto &element = *primitive.element;
+  element.componentType = indexTypeOf(element.componentType, weldedCount);
+  element.buffer = bufferOfIndices(indices, element.componentType);
+  return true;
+}
+
+} // namespace gltf2
@@ -0,0 +1,435 @@
+#include "AccessorConversion.h"
+#include "DracoDecoder.h"
+#include "GLTF2.h"
+#include "GLTFGenerator.h"
+#include "JsonDecoder.h"
+#include "config.h"
+#include "nlohmann/json.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace gltf2;
+
+namespace {
+
+/**
+ * @brief A glTF or GLB file read into memory once, so that the benchmarks do
+ * not measure the file system.
+ */
+struct Input {
+  std::string name;
+  std::filesystem::path path;
+  std::string bytes;
+  // the JSON fixtures of the tests refer to buffers that do not exist
+  bool loadable;
+
+  GLTFFile parse() const {
+    return GLTFFile::parseStream(std::istringstream(bytes), path);
+  }
+
+  /**
+   * @brief The JSON text of the file, which is the JSON chunk of a GLB.
+   */
+  std::string jsonText() const {
+    uint32_t magic = 0;
+    if (bytes.size() >= sizeof(magic))
+      std::memcpy(&magic, bytes.data(), sizeof(magic));
+    if (magic != GLBHeaderMagic)
+      return bytes;
+    GLBChunkHead head;
+    auto offset = sizeof(GLBHeader);
+    if (bytes.size() < offset + sizeof(head))
+      return "";
+    std::memcpy(&head, bytes.data() + offset, sizeof(head));
+    return bytes.substr(offset + sizeof(head), head.length);
+  }
+};
+
+std::string readFile(const std::filesystem::path &path) {
+  std::ifstream fs(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(fs), std::istreambuf_iterator<char>()};
+}
+
+void collectInputs(const std::filesystem::path &dir, const std::string &prefix,
+                   bool loadable, std::vector<Input> &inputs) {
+  std::error_code ec;
+  if (!std::filesystem::is_directory(dir, ec))
+    return;
+  std::vector<std::filesystem::path> paths;
+  for (const auto &entry :
+       std::filesystem::recursive_directory_iterator(dir, ec)) {
+    auto ext = entry.path().extension();
+    if (entry.is_regular_file() &&
+        (ext == ".gltf" || ext == ".glb" || ext == ".json"))
+      paths.push_back(entry.path());
+  }
+  std::sort(paths.begin(), paths.end());
+  for (const auto &path : paths) {
+    auto name = prefix + "/" +
+                std::filesystem::relative(path, dir).replace_extension().string();
+    inputs.push_back({name, path, readFile(path), loadable});
+  }
+}
+
+/**
+ * @brief Generates a synthetic input, or nothing if the options cannot be
+ * generated in this build, e.g. without a Draco encoder.
+ */
+std::optional<Input> syntheticInput(const std::string &name,
+                                    const gen::GeneratorOptions &options,
+                                    bool dataUri = false) {
+  try {
+    auto asset = gen::GLTFGenerator::generate(options);
+    if (dataUri) {
+      return Input{"synthetic/" + name, "synthetic/" + name + ".gltf",
+                   asset.gltf(), true};
+    }
+    std::stringstream ss;
+    asset.glb().write(ss);
+    return Input{"synthetic/" + name, "synthetic/" + name + ".glb", ss.str(),
+                 true};
+  } catch (const std::exception &e) {
+    std::cerr << "skipping synthetic/" << name << ": " << e.what()
+              << std::endl;
+    return std::nullopt;
+  }
+}
+
+std::vector<Input> syntheticInputs() {
+  std::vector<std::pair<std::string, gen::GeneratorOptions>> cases;
+  for (uint32_t vertices : {1u << 10, 1u << 14, 1u << 18}) {
+    gen::GeneratorOptions options;
+    options.vertices = vertices;
+    cases.emplace_back("vertices" + std::to_string(vertices), options);
+  }
+  for (uint32_t branching : {0, 1}) {
+    gen::GeneratorOptions options;
+    options.nodes = 10000;
+    options.branching = branching;
+    options.meshes = 64;
+    options.vertices = 16;
+    cases.emplace_back(branching == 0 ? "nodes10000-flat" : "nodes10000-chain",
+                       options);
+  }
+  {
+    gen::GeneratorOptions options;
+    options.vertices = 1 << 14;
+    options.morphTargets = 8;
+    options.sparseCount = 256;
+    cases.emplace_back("morph-sparse", options);
+  }
+  {
+    gen::GeneratorOptions options;
+    options.vertices = 1 << 14;
+    options.joints = 64;
+    options.animationChannels = 256;
+    cases.emplace_back("skinned-animated", options);
+  }
+  {
+    gen::GeneratorOptions options;
+    options.meshes = 4;
+    options.vertices = 1 << 12;
+    options.rig = gen::Rig::VRM1;
+    options.springChains = 32;
+    cases.emplace_back("vrm1-springs", options);
+  }
+  {
+    gen::GeneratorOptions options;
+    options.vertices = 1 << 14;
+    options.draco = true;
+    cases.emplace_back("draco", options);
+  }
+
+  std::vector<Input> inputs;
+  for (const auto &[name, options] : cases) {
+    if (auto input = syntheticInput(name, options))
+      inputs.push_back(std::move(*input));
+  }
+  gen::GeneratorOptions options;
+  options.vertices = 1 << 14;
+  if (auto input = syntheticInput("data-uri", options, true))
+    inputs.push_back(std::move(*input));
+  return inputs;
+}
+
+/**
+ * @brief The bufferViews of the KHR_draco_mesh_compression meshes, each once.
+ */
+std::vector<uint32_t> dracoBufferViews(const json::Json &json) {
+  std::vector<uint32_t> indices;
+  if (!json.meshes)
+    return indices;
+  for (const auto &mesh : *json.meshes) {
+    for (const auto &primitive : mesh.primitives) {
+      if (primitive.dracoExtension)
+        indices.push_back(primitive.dracoExtension->bufferView);
+    }
+  }
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+  return indices;
+}
+
+// Phases
+
+void BM_JsonParse(benchmark::State &state, const Input *input) {
+  auto text = input->jsonText();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(nlohmann::json::parse(text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+void BM_JsonDecode(benchmark::State &state, const Input *input) {
+  auto j = nlohmann::json::parse(input->jsonText());
+  try {
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(json::JsonDecoder::decode(j));
+    }
+  } catch (const std::exception &e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+void BM_ParseFile(benchmark::State &state, const Input *input) {
+  try {
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(input->parse());
+    }
+    state.SetBytesProcessed(state.iterations() * input->bytes.size());
+  } catch (const std::exception &e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+enum class Phase {
+  Buffers,
+  BufferViews,
+  AccessorBuffers,
+  ImageBuffers,
+  MeshPrimitives
+};
+
+std::future<void> runPhase(GLTFData &data, Phase phase) {
+  switch (phase) {
+  case Phase::Buffers:
+    return data.loadBuffers();
+  case Phase::BufferViews:
+    return data.loadBufferViews();
+  case Phase::AccessorBuffers:
+    return data.loadAccessorBuffers();
+  case Phase::ImageBuffers:
+    return data.loadImageBuffers();
+  case Phase::MeshPrimitives:
+    return data.loadMeshPrimitives();
+  }
+  return {};
+}
+
+/**
+ * @brief Measures one phase of `GLTFData::eagerLoad`, with the phases it
+ * depends on run once beforehand.
+ */
+void BM_LoadPhase(benchmark::State &state, const Input *input, Phase phase) {
+  try {
+    GLTFData data(input->parse());
+    for (auto before = Phase::Buffers; before < phase;
+         before = static_cast<Phase>(static_cast<int>(before) + 1)) {
+      runPhase(data, before).get();
+    }
+    for (auto _ : state) {
+      runPhase(data, phase).get();
+    }
+  } catch (const std::exception &e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+/**
+ * @brief Measures decoding the Draco meshes alone, without copying their
+ * attributes into mesh primitives.
+ */
+void BM_DracoDecode(benchmark::State &state, const Input *input) {
+  try {
+    GLTFData data(input->parse());
+    data.loadBuffers().get();
+    data.loadBufferViews().get();
+    std::vector<BufferView> bufferViews;
+    for (auto index : dracoBufferViews(data.json()))
+      bufferViews.push_back(data.bufferViewAt(index));
+    DracoDecoder decoder;
+    uint64_t bytes = 0;
+    for (const auto &bufferView : bufferViews)
+      bytes += bufferView.bytes;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(
+          decoder.decodeAll(bufferViews, defaultExecutor()));
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+  } catch (const std::exception &e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+void BM_EagerLoad(benchmark::State &state, const Input *input) {
+  try {
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(GLTFData::load(input->parse()));
+    }
+    state.SetBytesProcessed(state.iterations() * input->bytes.size());
+  } catch (const std::exception &e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+void BM_NormalizeBuffer(benchmark::State &state,
+                        json::Accessor::ComponentType componentType) {
+  json::Accessor accessor;
+  accessor.componentType = componentType;
+  accessor.type = json::Accessor::Type::VEC3;
+  accessor.count = state.range(0);
+  accessor.normalized = true;
+
+  Buffer binary(accessor.count * 3 *
+                json::Accessor::sizeOfComponentType(componentType));
+  std::mt19937 rng(accessor.count);
+  std::uniform_int_distribution<int> byte(0, 255);
+  for (auto &b : binary)
+    b = byte(rng);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(normalizeBuffer(binary, accessor));
+  }
+  state.SetBytesProcessed(state.iterations() * binary.size());
+  state.SetItemsProcessed(state.iterations() * accessor.count * 3);
+}
+
+void BM_GatherElements(benchmark::State &state, size_t elementSize) {
+  // one attribute of vertices with a position, normal and texcoord
+  const size_t byteStride = 32;
+  size_t count = state.range(0);
+  Buffer vertices(byteStride * count, 1);
+  Buffer dst(elementSize * count);
+
+  for (auto _ : state) {
+    gatherElements(vertices.data(), byteStride, elementSize, count,
+                   dst.data());
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetBytesProcessed(state.iterations() * dst.size());
+}
+
+void BM_Deinterleave(benchmark::State &state) {
+  const size_t byteStride = 32;
+  size_t count = state.range(0);
+  Buffer vertices(byteStride * count, 1);
+  Buffer positions(12 * count), normals(12 * count), texcoords(8 * count);
+  const std::vector<InterleavedElement> elements = {
+      {0, 12, positions.data()},
+      {12, 12, normals.data()},
+      {24, 8, texcoords.data()}};
+
+  for (auto _ : state) {
+    deinterleave(vertices.data(), byteStride, count, elements);
+    benchmark::DoNotOptimize(positions.data());
+  }
+  state.SetBytesProcessed(state.iterations() * vertices.size());
+}
+
+const std::pair<const char *, Phase> phases[] = {
+    {"LoadBuffers", Phase::Buffers},
+    {"LoadBufferViews", Phase::BufferViews},
+    {"LoadAccessorBuffers", Phase::AccessorBuffers},
+    {"LoadImageBuffers", Phase::ImageBuffers},
+    {"LoadMeshPrimitives", Phase::MeshPrimitives}};
+
+void registerInput(const Input *input) {
+  benchmark::RegisterBenchmark(("JsonParse/" + input->name).c_str(),
+                               BM_JsonParse, input);
+  benchmark::RegisterBenchmark(("JsonDecode/" + input->name).c_str(),
+                               BM_JsonDecode, input);
+  benchmark::RegisterBenchmark(("ParseFile/" + input->name).c_str(),
+                               BM_ParseFile, input);
+  if (!input->loadable)
+    return;
+  // loading runs on other threads, so only the wall time is meaningful
+  for (const auto &[name, phase] : phases) {
+    benchmark::RegisterBenchmark(
+        (std::string(name) + "/" + input->name).c_str(), BM_LoadPhase, input,
+        phase)
+        ->UseRealTime();
+  }
+  benchmark::RegisterBenchmark(("EagerLoad/" + input->name).c_str(),
+                               BM_EagerLoad, input)
+      ->UseRealTime();
+
+  bool draco = false;
+  try {
+    draco = !dracoBufferViews(input->parse().json()).empty();
+  } catch (const std::exception &) {
+  }
+  if (draco) {
+    benchmark::RegisterBenchmark(("DracoDecode/" + input->name).c_str(),
+                                 BM_DracoDecode, input)
+        ->UseRealTime();
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  std::vector<Input> inputs;
+  collectInputs(SAMPLE_MODELS_PATH, "sample-models", true, inputs);
+  collectInputs(FIXTURES_PATH, "fixtures", false, inputs);
+  // additional models, e.g. a checkout of glTF-Sample-Assets
+  if (const char *models = std::getenv("GLTF2_BENCHMARK_MODELS"))
+    collectInputs(models, "models", true, inputs);
+  for (auto &input : syntheticInputs())
+    inputs.push_back(std::move(input));
+
+  for (const auto &input : inputs) {
+    registerInput(&input);
+  }
+
+  const std::pair<const char *, json::Accessor::ComponentType>
+      componentTypes[] = {
+          {"BYTE", json::Accessor::ComponentType::BYTE},
+          {"UNSIGNED_BYTE", json::Accessor::ComponentType::UNSIGNED_BYTE},
+          {"SHORT", json::Accessor::ComponentType::SHORT},
+          {"UNSIGNED_SHORT", json::Accessor::ComponentType::UNSIGNED_SHORT}};
+  for (const auto &[name, componentType] : componentTypes) {
+    benchmark::RegisterBenchmark(
+        (std::string("NormalizeBuffer/") + name).c_str(), BM_NormalizeBuffer,
+        componentType)
+        ->RangeMultiplier(16)
+        ->Range(1 << 10, 1 << 18);
+  }
+
+  for (size_t elementSize : {4, 8, 12, 16}) {
+    benchmark::RegisterBenchmark(
+        ("GatherElements/" + std::to_string(elementSize)).c_str(),
+        BM_GatherElements, elementSize)
+        ->RangeMultiplier(16)
+        ->Range(1 << 10, 1 << 22);
+  }
+  benchmark::RegisterBenchmark("Deinterleave", BM_Deinterleave)
+      ->RangeMultiplier(16)
+      ->Range(1 << 10, 1 << 22);
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,787 @@
+#include "GLTFGenerator.h"
+#include "GLTFException.h"
+#include "GLTFExtension.h"
+#include "JsonEncoder.h"
+#include "cppcodec/base64_rfc4648.hpp"
+#include "draco/compression/encode.h"
+#include "draco/mesh/mesh.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace gltf2 {
+namespace gen {
+
+static const uint32_t arrayBuffer = 34962;
+static const uint32_t elementArrayBuffer = 34963;
+
+/**
+ * @brief SplitMix64. Unlike the distributions of <random>, its sequence is
+ * the same on every standard library.
+ */
+class Random {
+public:
+  explicit Random(uint64_t seed) : _state(seed) {}
+
+  uint64_t next() {
+    uint64_t z = (_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+
+  float uniform(float min, float max) {
+    return min + (max - min) * static_cast<float>(next() >> 40) / (1 << 24);
+  }
+
+  uint32_t below(uint32_t n) {
+    return static_cast<uint32_t>(((next() >> 32) * n) >> 32);
+  }
+
+private:
+  uint64_t _state;
+};
+
+struct MeshData {
+  uint32_t vertexCount;
+  std::vector<float> positions;
+  std::vector<float> normals;
+  std::vector<float> texcoords;
+  std::vector<uint16_t> joints;
+  std::vector<float> weights;
+  std::vector<uint32_t> indices;
+};
+
+/**
+ * @brief A grid of at least `vertices` vertices in the unit square, with
+ * randomly displaced heights and normals.
+ */
+static MeshData gridMesh(uint32_t vertices, Random &random) {
+  uint32_t width = std::max<uint32_t>(
+      2, static_cast<uint32_t>(std::ceil(std::sqrt((double)vertices))));
+  uint32_t height = std::max<uint32_t>(2, (vertices + width - 1) / width);
+
+  MeshData mesh;
+  mesh.vertexCount = width * height;
+  mesh.positions.reserve(mesh.vertexCount * 3);
+  mesh.normals.reserve(mesh.vertexCount * 3);
+  mesh.texcoords.reserve(mesh.vertexCount * 2);
+  for (uint32_t z = 0; z < height; z++) {
+    for (uint32_t x = 0; x < width; x++) {
+      float u = (float)x / (width - 1), v = (float)z / (height - 1);
+      mesh.positions.insert(mesh.positions.end(),
+                            {u, random.uniform(-0.05f, 0.05f), v});
+      float nx = random.uniform(-0.2f, 0.2f), nz = random.uniform(-0.2f, 0.2f);
+      float length = std::sqrt(nx * nx + 1 + nz * nz);
+      mesh.normals.insert(mesh.normals.end(),
+                          {nx / length, 1 / length, nz / length});
+      mesh.texcoords.insert(mesh.texcoords.end(), {u, v});
+    }
+  }
+  mesh.indices.reserve((width - 1) * (height - 1) * 6);
+  for (uint32_t z = 0; z + 1 < height; z++) {
+    for (uint32_t x = 0; x + 1 < width; x++) {
+      uint32_t i = z * width + x;
+      mesh.indices.insert(mesh.indices.end(), {i, i + width, i + 1, i + 1,
+                                               i + width, i + width + 1});
+    }
+  }
+  return mesh;
+}
+
+static void addSkinWeights(MeshData &mesh, uint32_t joints, Random &random) {
+  mesh.joints.resize(mesh.vertexCount * 4);
+  mesh.weights.resize(mesh.vertexCount * 4);
+  for (uint32_t i = 0; i < mesh.vertexCount * 4; i += 4) {
+    float sum = 0;
+    for (uint32_t j = 0; j < 4; j++) {
+      mesh.joints[i + j] = random.below(joints);
+      mesh.weights[i + j] = random.uniform(0.01f, 1);
+      sum += mesh.weights[i + j];
+    }
+    for (uint32_t j = 0; j < 4; j++)
+      mesh.weights[i + j] /= sum;
+  }
+}
+
+/**
+ * @brief Picks `count` sorted, distinct vertices out of `vertexCount`.
+ */
+static std::vector<uint32_t> sparseIndices(uint32_t count, uint32_t vertexCount,
+                                           Random &random) {
+  count = std::min(count, vertexCount);
+  std::vector<uint32_t> indices(count);
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t begin = (uint64_t)i * vertexCount / count;
+    uint32_t end = (uint64_t)(i + 1) * vertexCount / count;
+    indices[i] = begin + random.below(end - begin);
+  }
+  return indices;
+}
+
+static void minMax(const std::vector<float> &values, uint32_t components,
+                   std::vector<float> &min, std::vector<float> &max) {
+  min.assign(components, std::numeric_limits<float>::max());
+  max.assign(components, std::numeric_limits<float>::lowest());
+  for (size_t i = 0; i < values.size(); i++) {
+    min[i % components] = std::min(min[i % components], values[i]);
+    max[i % components] = std::max(max[i % components], values[i]);
+  }
+}
+
+/**
+ * @brief Lays out the payloads of a document in buffers of at most
+ * `GeneratorOptions::maxBufferBytes`.
+ */
+class Builder {
+public:
+  Builder(const GeneratorOptions &options)
+      : _options(options), _random(options.seed), _bins(1) {
+    _json.asset.version = "2.0";
+    _json.asset.generator = "GLTF2Generator";
+  }
+
+  GeneratedAsset build();
+
+private:
+  const GeneratorOptions &_options;
+  Random _random;
+  json::Json _json;
+  std::vector<Buffer> _bins;
+
+  uint32_t addBufferView(const void *data, size_t bytes,
+                         std::optional<uint32_t> byteStride = std::nullopt,
+                         std::optional<uint32_t> target = std::nullopt);
+
+  uint32_t addAccessor(std::optional<uint32_t> bufferView,
+                       json::Accessor::ComponentType componentType,
+                       json::Accessor::Type type, uint32_t count);
+
+  template <typename T>
+  uint32_t addData(const std::vector<T> &values,
+                   json::Accessor::ComponentType componentType,
+                   json::Accessor::Type type,
+                   std::optional<uint32_t> target = arrayBuffer) {
+    auto components = json::Accessor::componentsCountOfType(type);
+    auto view = addBufferView(values.data(), values.size() * sizeof(T),
+                              std::nullopt, target);
+    return addAccessor(view, componentType, type, values.size() / components);
+  }
+
+  uint32_t addFloats(const std::vector<float> &values, json::Accessor::Type type,
+                     bool bounds = false) {
+    auto index = addData(values, json::Accessor::ComponentType::FLOAT, type);
+    if (bounds) {
+      auto &accessor = _json.accessors->at(index);
+      minMax(values, json::Accessor::componentsCountOfType(type),
+             accessor.min.emplace(), accessor.max.emplace());
+    }
+    return index;
+  }
+
+  void addExtension(const std::string &name, bool required = false);
+
+  json::MeshPrimitive addPrimitive(const MeshData &mesh);
+  json::MeshPrimitive addDracoPrimitive(const MeshData &mesh);
+  json::MeshPrimitiveTarget addMorphTarget(const MeshData &mesh);
+  void addSparseOverlay(uint32_t accessorIndex, const MeshData &mesh);
+
+  uint32_t addNode(std::optional<uint32_t> parent,
+                   std::array<float, 3> translation);
+  void addNodes();
+  void addSkin();
+  void addAnimation();
+  void addRig();
+  void addSpringChains(std::optional<uint32_t> parent);
+};
+
+uint32_t Builder::addBufferView(const void *data, size_t bytes,
+                                std::optional<uint32_t> byteStride,
+                                std::optional<uint32_t> target) {
+  auto maxBytes = std::min<uint64_t>(_options.maxBufferBytes, UINT32_MAX);
+  if (bytes > maxBytes)
+    throw InputException("generated bufferView exceeds the buffer size");
+  auto *bin = &_bins.back();
+  auto offset = (bin->size() + 3) & ~size_t(3);
+  if (offset + bytes > maxBytes)
+    bin = &_bins.emplace_back();
+  else
+    bin->resize(offset);
+  json::BufferView bufferView;
+  bufferView.buffer = _bins.size() - 1;
+  bufferView.byteOffset = bin->size();
+  bufferView.byteLength = bytes;
+  bufferView.byteStride = byteStride;
+  bufferView.target = target;
+  auto begin = static_cast<const uint8_t *>(data);
+  bin->insert(bin->end(), begin, begin + bytes);
+  if (!_json.bufferViews)
+    _json.bufferViews.emplace();
+  _json.bufferViews->push_back(bufferView);
+  return _json.bufferViews->size() - 1;
+}
+
+uint32_t Builder::addAccessor(std::optional<uint32_t> bufferView,
+                              json::Accessor::ComponentType componentType,
+                              json::Accessor::Type type, uint32_t count) {
+  json::Accessor accessor;
+  accessor.bufferView = bufferView;
+  accessor.componentType = componentType;
+  accessor.type = type;
+  accessor.count = count;
+  if (!_json.accessors)
+    _json.accessors.emplace();
+  _json.accessors->push_back(accessor);
+  return _json.accessors->size() - 1;
+}
+
+void Builder::addExtension(const std::string &name, bool required) {
+  auto add = [&name](std::optional<std::vector<std::string>> &names) {
+    if (!names)
+      names.emplace();
+    if (std::find(names->begin(), names->end(), name) == names->end())
+      names->push_back(name);
+  };
+  add(_json.extensionsUsed);
+  if (required)
+    add(_json.extensionsRequired);
+}
+
+json::MeshPrimitive Builder::addPrimitive(const MeshData &mesh) {
+  json::MeshPrimitive primitive;
+  auto &attributes = primitive.attributes;
+  attributes.position = addFloats(mesh.positions, json::Accessor::Type::VEC3,
+                                  true);
+  attributes.normal = addFloats(mesh.normals, json::Accessor::Type::VEC3);
+  attributes.texcoords = std::vector<uint32_t>{
+      addFloats(mesh.texcoords, json::Accessor::Type::VEC2)};
+  if (!mesh.joints.empty()) {
+    attributes.joints = std::vector<uint32_t>{
+        addData(mesh.joints, json::Accessor::ComponentType::UNSIGNED_SHORT,
+                json::Accessor::Type::VEC4)};
+    attributes.weights = std::vector<uint32_t>{
+        addFloats(mesh.weights, json::Accessor::Type::VEC4)};
+  }
+  if (mesh.vertexCount <= UINT16_MAX) {
+    std::vector<uint16_t> indices(mesh.indices.begin(), mesh.indices.end());
+    primitive.indices =
+        addData(indices, json::Accessor::ComponentType::UNSIGNED_SHORT,
+                json::Accessor::Type::SCALAR, elementArrayBuffer);
+  } else {
+    primitive.indices =
+        addData(mesh.indices, json::Accessor::ComponentType::UNSIGNED_INT,
+                json::Accessor::Type::SCALAR, elementArrayBuffer);
+  }
+  return primitive;
+}
+
+template <typename T>
+static int addDracoAttribute(draco::Mesh &dracoMesh,
+                             draco::GeometryAttribute::Type type,
+                             draco::DataType dataType, uint8_t components,
+                             const std::vector<T> &values) {
+  draco::GeometryAttribute attribute;
+  attribute.Init(type, nullptr, components, dataType, false,
+                 sizeof(T) * components, 0);
+  auto id = dracoMesh.AddAttribute(attribute, true, dracoMesh.num_points());
+  dracoMesh.attribute(id)->buffer()->Write(0, values.data(),
+                                           values.size() * sizeof(T));
+  return id;
+}
+
+json::MeshPrimitive Builder::addDracoPrimitive(const MeshData &mesh) {
+  draco::Mesh dracoMesh;
+  dracoMesh.set_num_points(mesh.vertexCount);
+  dracoMesh.SetNumFaces(mesh.indices.size() / 3);
+  for (uint32_t i = 0; i < mesh.indices.size() / 3; i++) {
+    dracoMesh.SetFace(draco::FaceIndex(i),
+                      {draco::PointIndex(mesh.indices[i * 3]),
+                       draco::PointIndex(mesh.indices[i * 3 + 1]),
+                       draco::PointIndex(mesh.indices[i * 3 + 2])});
+  }
+
+  json::MeshPrimitive primitive;
+  json::MeshPrimitiveDracoExtension extension;
+  auto uniqueId = [&dracoMesh](int id) {
+    return dracoMesh.attribute(id)->unique_id();
+  };
+  auto &attributes = primitive.attributes;
+  attributes.position =
+      addAccessor(std::nullopt, json::Accessor::ComponentType::FLOAT,
+                  json::Accessor::Type::VEC3, mesh.vertexCount);
+  minMax(mesh.positions, 3, _json.accessors->back().min.emplace(),
+         _json.accessors->back().max.emplace());
+  extension.attributes.position = uniqueId(
+      addDracoAttribute(dracoMesh, draco::GeometryAttribute::POSITION,
+                        draco::DT_FLOAT32, 3, mesh.positions));
+  attributes.normal =
+      addAccessor(std::nullopt, json::Accessor::ComponentType::FLOAT,
+                  json::Accessor::Type::VEC3, mesh.vertexCount);
+  extension.attributes.normal = uniqueId(
+      addDracoAttribute(dracoMesh, draco::GeometryAttribute::NORMAL,
+                        draco::DT_FLOAT32, 3, mesh.normals));
+  attributes.texcoords = std::vector<uint32_t>{
+      addAccessor(std::nullopt, json::Accessor::ComponentType::FLOAT,
+                  json::Accessor::Type::VEC2, mesh.vertexCount)};
+  extension.attributes.texcoords = std::vector<uint32_t>{uniqueId(
+      addDracoAttribute(dracoMesh, draco::GeometryAttribute::TEX_COORD,
+                        draco::DT_FLOAT32, 2, mesh.texcoords))};
+  if (!mesh.joints.empty()) {
+    attributes.joints = std::vector<uint32_t>{
+        addAccessor(std::nullopt, json::Accessor::ComponentType::UNSIGNED_SHORT,
+                    json::Accessor::Type::VEC4, mesh.vertexCount)};
+    extension.attributes.joints = std::vector<uint32_t>{uniqueId(
+        addDracoAttribute(dracoMesh, draco::GeometryAttribute::JOINTS,
+                          draco::DT_UINT16, 4, mesh.joints))};
+    attributes.weights = std::vector<uint32_t>{
+        addAccessor(std::nullopt, json::Accessor::ComponentType::FLOAT,
+                    json::Accessor::Type::VEC4, mesh.vertexCount)};
+    extension.attributes.weights = std::vector<uint32_t>{uniqueId(
+        addDracoAttribute(dracoMesh, draco::GeometryAttribute::WEIGHTS,
+                          draco::DT_FLOAT32, 4, mesh.weights))};
+  }
+  primitive.indices =
+      addAccessor(std::nullopt, json::Accessor::ComponentType::UNSIGNED_INT,
+                  json::Accessor::Type::SCALAR, mesh.indices.size());
+
+  draco::Encoder encoder;
+  // sequential encoding keeps the number and order of the points, which the
+  // accessors above describe
+  encoder.SetEncodingMethod(draco::MESH_SEQUENTIAL_ENCODING);
+  encoder.SetAttributeQuantization(draco::GeometryAttribute::POSITION, 14);
+  encoder.SetAttributeQuantization(draco::GeometryAttribute::NORMAL, 10);
+  encoder.SetAttributeQuantization(draco::GeometryAttribute::TEX_COORD, 12);
+  draco::EncoderBuffer buffer;
+  auto status = encoder.EncodeMeshToBuffer(dracoMesh, &buffer);
+  if (!status.ok()) {
+    throw InputException(
+        ("Failed to encode Draco mesh: " + status.error_msg_string()).c_str());
+  }
+  extension.bufferView = addBufferView(buffer.data(), buffer.size());
+  primitive.dracoExtension = extension;
+  addExtension(GLTFExtensionKHRDracoMeshCompression, true);
+  return primitive;
+}
+
+json::MeshPrimitiveTarget Builder::addMorphTarget(const MeshData &mesh) {
+  json::MeshPrimitiveTarget target;
+  if (_options.sparseCount == 0) {
+    std::vector<float> displacements(mesh.vertexCount * 3);
+    for (auto &value : displacements)
+      value = _random.uniform(-0.1f, 0.1f);
+    target.position = addFloats(displacements, json::Accessor::Type::VEC3, true);
+    return target;
+  }
+
+  auto indices = sparseIndices(_options.sparseCount, mesh.vertexCount, _random);
+  std::vector<float> values(indices.size() * 3);
+  for (auto &value : values)
+    value = _random.uniform(-0.1f, 0.1f);
+
+  target.position =
+      addAccessor(std::nullopt, json::Accessor::ComponentType::FLOAT,
+                  json::Accessor::Type::VEC3, mesh.vertexCount);
+  auto &accessor = _json.accessors->back();
+  json::AccessorSparse sparse;
+  sparse.count = indices.size();
+  sparse.indices.bufferView =
+      addBufferView(indices.data(), indices.size() * sizeof(uint32_t));
+  sparse.indices.componentType =
+      json::AccessorSparseIndices::ComponentType::UNSIGNED_INT;
+  sparse.values.bufferView =
+      addBufferView(values.data(), values.size() * sizeof(float));
+  // the other vertices are not displaced
+  if (indices.size() < mesh.vertexCount)
+    values.insert(values.end(), {0, 0, 0});
+  minMax(values, 3, accessor.min.emplace(), accessor.max.emplace());
+  accessor.sparse = sparse;
+  return target;
+}
+
+void Builder::addSparseOverlay(uint32_t accessorIndex, const MeshData &mesh) {
+  auto indices = sparseIndices(_options.sparseCount, mesh.vertexCount, _random);
+  std::vector<float> positions = mesh.positions;
+  std::vector<float> values;
+  values.reserve(indices.size() * 3);
+  for (auto index : indices) {
+    float y = _random.uniform(0.1f, 0.2f);
+    values.insert(values.end(),
+                  {positions[index * 3], y, positions[index * 3 + 2]});
+    positions[index * 3 + 1] = y;
+  }
+
+  json::AccessorSparse sparse;
+  sparse.count = indices.size();
+  sparse.indices.bufferView =
+      addBufferView(indices.data(), indices.size() * sizeof(uint32_t));
+  sparse.indices.componentType =
+      json::AccessorSparseIndices::ComponentType::UNSIGNED_INT;
+  sparse.values.bufferView =
+      addBufferView(values.data(), values.size() * sizeof(float));
+  auto &accessor = _json.accessors->at(accessorIndex);
+  minMax(positions, 3, accessor.min.emplace(), accessor.max.emplace());
+  accessor.sparse = sparse;
+}
+
+uint32_t Builder::addNode(std::optional<uint32_t> parent,
+                          std::array<float, 3> translation) {
+  if (!_json.nodes)
+    _json.nodes.emplace();
+  json::Node node;
+  node.translation = translation;
+  _json.nodes->push_back(node);
+  uint32_t index = _json.nodes->size() - 1;
+  if (parent) {
+    auto &children = _json.nodes->at(*parent).children;
+    if (!children)
+      children.emplace();
+    children->push_back(index);
+  } else {
+    _json.scenes->at(0).nodes->push_back(index);
+  }
+  return index;
+}
+
+void Builder::addNodes() {
+  uint32_t count = std::max(_options.nodes, _options.meshes);
+  _json.nodes.emplace();
+  _json.nodes->reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    std::optional<uint32_t> parent;
+    if (i > 0 && _options.branching > 0)
+      parent = (i - 1) / _options.branching;
+    auto node = addNode(parent, {_random.uniform(-1, 1), _random.uniform(-1, 1),
+                                 _random.uniform(-1, 1)});
+    _json.nodes->at(node).mesh = i % _options.meshes;
+  }
+}
+
+void Builder::addSkin() {
+  json::Skin skin;
+  std::vector<float> inverseBindMatrices;
+  inverseBindMatrices.reserve(_options.joints * 16);
+  std::optional<uint32_t> parent;
+  float y = 0;
+  for (uint32_t i = 0; i < _options.joints; i++) {
+    float step = 1.0f / _options.joints;
+    auto joint = addNode(parent, {0, parent ? step : 0, 0});
+    y += parent ? step : 0;
+    skin.joints.push_back(joint);
+    inverseBindMatrices.insert(inverseBindMatrices.end(),
+                               {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, -y, 0, 1});
+    parent = joint;
+  }
+  skin.skeleton = skin.joints.front();
+  skin.inverseBindMatrices =
+      addFloats(inverseBindMatrices, json::Accessor::Type::MAT4);
+  _json.skins = {skin};
+  for (uint32_t i = 0; i < std::max(_options.nodes, _options.meshes); i++)
+    _json.nodes->at(i).skin = 0;
+}
+
+void Builder::addAnimation() {
+  std::vector<float> times(_options.keyframes);
+  for (uint32_t i = 0; i < times.size(); i++)
+    times[i] = i / 30.0f;
+  auto input = addFloats(times, json::Accessor::Type::SCALAR, true);
+
+  // each node is targeted at most once per path, as glTF requires
+  uint32_t nodeCount = _json.nodes->size();
+  uint32_t channelCount = std::min<uint64_t>(_options.animationChannels,
+                                             (uint64_t)nodeCount * 3);
+  json::Animation animation;
+  for (uint32_t i = 0; i < channelCount; i++) {
+    uint32_t node = i % nodeCount;
+    auto path = static_cast<json::AnimationChannelTarget::Path>(
+        (node + i / nodeCount) % 3);
+    std::vector<float> values;
+    for (uint32_t k = 0; k < _options.keyframes; k++) {
+      switch (path) {
+      case json::AnimationChannelTarget::Path::ROTATION: {
+        float angle = _random.uniform(-1, 1);
+        values.insert(values.end(),
+                      {0, std::sin(angle / 2), 0, std::cos(angle / 2)});
+        break;
+      }
+      case json::AnimationChannelTarget::Path::SCALE: {
+        float scale = _random.uniform(0.5f, 1.5f);
+        values.insert(values.end(), {scale, scale, scale});
+        break;
+      }
+      default:
+        values.insert(values.end(),
+                      {_random.uniform(-1, 1), _random.uniform(-1, 1),
+                       _random.uniform(-1, 1)});
+        break;
+      }
+    }
+    json::AnimationSampler sampler;
+    sampler.input = input;
+    sampler.output = addFloats(values,
+                               path == json::AnimationChannelTarget::Path::ROTATION
+                                   ? json::Accessor::Type::VEC4
+                                   : json::Accessor::Type::VEC3);
+    animation.samplers.push_back(sampler);
+
+    json::AnimationChannel channel;
+    channel.sampler = i;
+    channel.target.node = node;
+    channel.target.path = path;
+    animation.channels.push_back(channel);
+  }
+  _json.animations = {animation};
+}
+
+void Builder::addRig() {
+  // the bones required by both VRM versions
+  auto hips = addNode(std::nullopt, {0, 1, 0});
+  auto spine = addNode(hips, {0, 0.1f, 0});
+  auto head = addNode(spine, {0, 0.5f, 0});
+  auto leftUpperLeg = addNode(hips, {0.1f, -0.05f, 0});
+  auto leftLowerLeg = addNode(leftUpperLeg, {0, -0.45f, 0});
+  auto leftFoot = addNode(leftLowerLeg, {0, -0.45f, 0});
+  auto rightUpperLeg = addNode(hips, {-0.1f, -0.05f, 0});
+  auto rightLowerLeg = addNode(rightUpperLeg, {0, -0.45f, 0});
+  auto rightFoot = addNode(rightLowerLeg, {0, -0.45f, 0});
+  auto leftUpperArm = addNode(spine, {0.2f, 0.35f, 0});
+  auto leftLowerArm = addNode(leftUpperArm, {0.3f, 0, 0});
+  auto leftHand = addNode(leftLowerArm, {0.25f, 0, 0});
+  auto rightUpperArm = addNode(spine, {-0.2f, 0.35f, 0});
+  auto rightLowerArm = addNode(rightUpperArm, {-0.3f, 0, 0});
+  auto rightHand = addNode(rightLowerArm, {-0.25f, 0, 0});
+
+  if (_options.rig == Rig::VRM0) {
+    using BoneName = json::vrm0::HumanoidBone::BoneName;
+    const std::pair<BoneName, uint32_t> bones[] = {
+        {BoneName::HIPS, hips},
+        {BoneName::SPINE, spine},
+        {BoneName::HEAD, head},
+        {BoneName::LEFT_UPPER_LEG, leftUpperLeg},
+        {BoneName::LEFT_LOWER_LEG, leftLowerLeg},
+        {BoneName::LEFT_FOOT, leftFoot},
+        {BoneName::RIGHT_UPPER_LEG, rightUpperLeg},
+        {BoneName::RIGHT_LOWER_LEG, rightLowerLeg},
+        {BoneName::RIGHT_FOOT, rightFoot},
+        {BoneName::LEFT_UPPER_ARM, leftUpperArm},
+        {BoneName::LEFT_LOWER_ARM, leftLowerArm},
+        {BoneName::LEFT_HAND, leftHand},
+        {BoneName::RIGHT_UPPER_ARM, rightUpperArm},
+        {BoneName::RIGHT_LOWER_ARM, rightLowerArm},
+        {BoneName::RIGHT_HAND, rightHand}};
+    json::vrm0::Humanoid humanoid;
+    humanoid.humanBones.emplace();
+    for (const auto &[name, node] : bones) {
+      json::vrm0::HumanoidBone bone;
+      bone.bone = name;
+      bone.node = node;
+      humanoid.humanBones->push_back(bone);
+    }
+    json::vrm0::VRM vrm;
+    vrm.specVersion = "0.0";
+    vrm.humanoid = humanoid;
+    _json.vrm0 = vrm;
+    addExtension(GLTFExtensionVRM);
+  } else {
+    json::vrmc::VRM vrm;
+    vrm.specVersion = "1.0";
+    vrm.meta.name = "GLTF2Generator";
+    vrm.meta.authors = {"GLTF2Generator"};
+    vrm.meta.licenseUrl = "https://vrm.dev/licenses/1.0/";
+    auto &bones = vrm.humanoid.humanBones;
+    bones.hips.node = hips;
+    bones.spine.node = spine;
+    bones.head.node = head;
+    bones.leftUpperLeg.node = leftUpperLeg;
+    bones.leftLowerLeg.node = leftLowerLeg;
+    bones.leftFoot.node = leftFoot;
+    bones.rightUpperLeg.node = rightUpperLeg;
+    bones.rightLowerLeg.node = rightLowerLeg;
+    bones.rightFoot.node = rightFoot;
+    bones.leftUpperArm.node = leftUpperArm;
+    bones.leftLowerArm.node = leftLowerArm;
+    bones.leftHand.node = leftHand;
+    bones.rightUpperArm.node = rightUpperArm;
+    bones.rightLowerArm.node = rightLowerArm;
+    bones.rightHand.node = rightHand;
+    _json.vrm1 = vrm;
+    addExtension(GLTFExtensionVRMCvrm);
+  }
+  addSpringChains(head);
+}
+
+void Builder::addSpringChains(std::optional<uint32_t> parent) {
+  std::vector<std::vector<uint32_t>> chains;
+  for (uint32_t i = 0; i < _options.springChains; i++) {
+    auto &chain = chains.emplace_back();
+    auto joint = parent;
+    for (uint32_t j = 0; j < _options.springJoints; j++) {
+      joint = addNode(joint, {j == 0 ? _random.uniform(-0.1f, 0.1f) : 0,
+                              j == 0 ? 0.1f : -0.05f, 0});
+      chain.push_back(*joint);
+    }
+  }
+  if (chains.empty())
+    return;
+
+  if (_options.rig == Rig::VRM0) {
+    json::vrm0::SecondaryAnimation secondaryAnimation;
+    secondaryAnimation.boneGroups.emplace();
+    for (const auto &chain : chains) {
+      json::vrm0::SecondaryAnimationSpring spring;
+      spring.stiffiness = 1;
+      spring.dragForce = 0.4f;
+      spring.hitRadius = 0.02f;
+      spring.bones = std::vector<uint32_t>{chain.front()};
+      secondaryAnimation.boneGroups->push_back(spring);
+    }
+    _json.vrm0->secondaryAnimation = secondaryAnimation;
+    return;
+  }
+
+  json::vrmc::SpringBone springBone;
+  springBone.specVersion = "1.0";
+  springBone.springs.emplace();
+  for (const auto &chain : chains) {
+    json::vrmc::SpringBoneSpring spring;
+    for (auto node : chain) {
+      json::vrmc::SpringBoneJoint joint;
+      joint.node = node;
+      joint.hitRadius = 0.02f;
+      spring.joints.push_back(joint);
+    }
+    springBone.springs->push_back(spring);
+  }
+  _json.springBone = springBone;
+  addExtension(GLTFExtensionVRMCSpringBone);
+}
+
+GeneratedAsset Builder::build() {
+  json::Scene scene;
+  scene.nodes.emplace();
+  _json.scenes = {scene};
+  _json.scene = 0;
+
+  json::Material material;
+  material.name = "default";
+  _json.materials = {material};
+
+  _json.meshes.emplace();
+  for (uint32_t i = 0; i < _options.meshes; i++) {
+    auto data = gridMesh(_options.vertices, _random);
+    if (_options.joints > 0)
+      addSkinWeights(data, _options.joints, _random);
+
+    auto primitive =
+        _options.draco ? addDracoPrimitive(data) : addPrimitive(data);
+    primitive.material = 0;
+    json::Mesh mesh;
+    if (_options.morphTargets > 0) {
+      primitive.targets.emplace();
+      for (uint32_t t = 0; t < _options.morphTargets; t++)
+        primitive.targets->push_back(addMorphTarget(data));
+      mesh.weights = std::vector<float>(_options.morphTargets);
+    } else if (_options.sparseCount > 0 && !_options.draco) {
+      addSparseOverlay(*primitive.attributes.position, data);
+    }
+    mesh.primitives.push_back(primitive);
+    _json.meshes->push_back(mesh);
+  }
+
+  addNodes();
+  if (_options.joints > 0)
+    addSkin();
+  if (_options.animationChannels > 0)
+    addAnimation();
+  if (_options.rig != Rig::None)
+    addRig();
+  else
+    addSpringChains(std::nullopt);
+
+  _json.buffers.emplace();
+  for (const auto &bin : _bins) {
+    json::Buffer buffer;
+    buffer.byteLength = bin.size();
+    _json.buffers->push_back(buffer);
+  }
+  return GeneratedAsset(std::move(_json), std::move(_bins));
+}
+
+GeneratedAsset GLTFGenerator::generate(const GeneratorOptions &options) {
+  if (options.meshes == 0)
+    throw InvalidFormatException("at least one mesh is required");
+  if (options.animationChannels > 0 && options.keyframes == 0)
+    throw InvalidFormatException("at least one keyframe is required");
+  return Builder(options).build();
+}
+
+GLBWriter GeneratedAsset::glb() const {
+  GLBWriter writer(_json);
+  if (_json.bufferViews) {
+    for (const auto &bufferView : *_json.bufferViews) {
+      const auto &bin = _bins.at(bufferView.buffer);
+      writer.addBufferView(bin.data() + bufferView.byteOffset.value_or(0),
+                           bufferView.byteLength, GLBChunkAlignment,
+                           bufferView.byteStride, bufferView.target,
+                           bufferView.name);
+    }
+  }
+  return writer;
+}
+
+GLTFFile GeneratedAsset::file() const {
+  std::stringstream ss;
+  glb().write(ss);
+  return GLTFFile::parseStream(std::move(ss));
+}
+
+std::string
+GeneratedAsset::gltf(const std::vector<std::string> &bufferUris) const {
+  auto json = _json;
+  for (size_t i = 0; i < json.buffers->size(); i++)
+    json.buffers->at(i).uri = bufferUris.at(i);
+  return json::JsonEncoder::encode(json).dump();
+}
+
+std::string GeneratedAsset::gltf() const {
+  std::vector<std::string> uris;
+  for (const auto &bin : _bins) {
+    uris.push_back("data:application/octet-stream;base64," +
+                   cppcodec::base64_rfc4648::encode(bin));
+  }
+  return gltf(uris);
+}
+
+void GeneratedAsset::write(const std::filesystem::path &path,
+                           BufferStorage storage) const {
+  if (storage == BufferStorage::Embedded) {
+    glb().write(path);
+    return;
+  }
+
+  std::string text;
+  if (storage == BufferStorage::External) {
+    std::vector<std::string> uris;
+    for (size_t i = 0; i < _bins.size(); i++) {
+      auto suffix = i == 0 ? std::string() : "_" + std::to_string(i);
+      auto binPath = path.parent_path() / (path.stem().string() + suffix +
+                                           ".bin");
+      std::ofstream bin(binPath, std::ios::binary);
+      bin.write(reinterpret_cast<const char *>(_bins[i].data()),
+                _bins[i].size());
+      if (!bin)
+        throw InputException(("Failed to write " + binPath.string()).c_str());
+      uris.push_back(binPath.filename().string());
+    }
+    text = gltf(uris);
+  } else {
+    text = gltf();
+  }
+  std::ofstream fs(path, std::ios::binary);
+  fs << text;
+  if (!fs)
+    throw InputException(("Failed to write " + path.string()).c_str());
+}
+
+} // namespace gen
+} // namespace gltf2
@@ -0,0 +1,161 @@
+#ifndef GLTFGenerator_h
+#define GLTFGenerator_h
+
+#include "GLTF2.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace gltf2 {
+namespace gen {
+
+/**
+ * @brief Where the buffers of a generated asset are stored.
+ */
+enum class BufferStorage {
+  /// The BIN chunk of a GLB file, which holds every buffer in at most 4 GiB.
+  Embedded,
+  /// A base64 data URI in a glTF file for each buffer.
+  DataUri,
+  /// A `.bin` file next to a glTF file for each buffer.
+  External
+};
+
+/**
+ * @brief The humanoid rig of a generated asset.
+ */
+enum class Rig { None, VRM0, VRM1 };
+
+/**
+ * @brief The parameters of a generated asset.
+ *
+ * The same options always generate the same asset, byte for byte, on every
+ * platform.
+ */
+struct GeneratorOptions {
+  uint64_t seed = 1;
+
+  /// The number of nodes. Node `i` instances mesh `i % meshes`, so there are
+  /// always at least as many nodes as meshes.
+  uint32_t nodes = 1;
+
+  /// The shape of the node hierarchy: 0 puts every node at the root of the
+  /// scene, 1 makes a single chain and b > 1 a complete b-ary tree.
+  uint32_t branching = 0;
+
+  uint32_t meshes = 1;
+
+  /// The number of vertices of each mesh, rounded up to a grid.
+  uint32_t vertices = 1024;
+
+  /// The number of morph targets of each mesh.
+  uint32_t morphTargets = 0;
+
+  /// The number of vertices each morph target displaces. Non-zero stores
+  /// the targets as sparse accessors; without morph targets, the positions
+  /// of each mesh get a sparse overlay of this size instead.
+  uint32_t sparseCount = 0;
+
+  /// The number of joints of a skin shared by every mesh node. 0 generates
+  /// no skin.
+  uint32_t joints = 0;
+
+  /// The number of channels of a single animation, targeting the nodes in
+  /// turn. Each node is targeted once per path at most, so there are at most
+  /// 3 channels per node of the mesh instances and the skin.
+  uint32_t animationChannels = 0;
+
+  /// The number of keyframes of each channel, at least 1.
+  uint32_t keyframes = 30;
+
+  /// Compresses every mesh with KHR_draco_mesh_compression.
+  bool draco = false;
+
+  Rig rig = Rig::None;
+
+  /// The number of spring bone chains hanging from the head of the rig, or
+  /// from the scene root without a rig.
+  uint32_t springChains = 0;
+
+  uint32_t springJoints = 4;
+
+  /// The largest buffer. Payloads that do not fit in the current buffer
+  /// start another one, so assets larger than a glTF buffer can hold, which
+  /// is 4 GiB at most, can be stored externally or as data URIs.
+  uint64_t maxBufferBytes = UINT32_MAX;
+};
+
+/**
+ * @brief A generated document with its buffers.
+ */
+class GeneratedAsset {
+public:
+  GeneratedAsset(json::Json json, std::vector<Buffer> bins)
+      : _json(std::move(json)), _bins(std::move(bins)) {}
+
+  /**
+   * @brief The document. Its buffers have no uri.
+   */
+  const json::Json &json() const { return _json; }
+
+  /// The payload of every buffer, in order.
+  const std::vector<Buffer> &bins() const { return _bins; }
+
+  /// The payload of the first buffer, the only one unless
+  /// `GeneratorOptions::maxBufferBytes` is exceeded.
+  const Buffer &bin() const { return _bins.front(); }
+
+  /**
+   * @brief Create a GLB writer for the asset, which joins the buffers in its
+   * BIN chunk. The writer refers to the buffers of the asset, which must
+   * outlive it.
+   */
+  GLBWriter glb() const;
+
+  /**
+   * @brief Write the asset as a GLB file and parse it back, as if it had
+   * been read from disk.
+   */
+  GLTFFile file() const;
+
+  /**
+   * @brief Encode the document as glTF JSON, with the given uri for each
+   * buffer.
+   */
+  std::string gltf(const std::vector<std::string> &bufferUris) const;
+
+  /**
+   * @brief Encode the document as glTF JSON with the buffers as data URIs.
+   */
+  std::string gltf() const;
+
+  /**
+   * @brief Write the asset to the given path. `External` storage writes the
+   * first buffer to a `.bin` file with the same stem, and buffer `i > 0` to
+   * `<stem>_<i>.bin`.
+   *
+   * @throws InputException If a file cannot be written, or the BIN chunk of
+   * `Embedded` storage would exceed 4 GiB.
+   */
+  void write(const std::filesystem::path &path, BufferStorage storage) const;
+
+private:
+  json::Json _json;
+  std::vector<Buffer> _bins;
+};
+
+class GLTFGenerator {
+public:
+  /**
+   * @brief Generate an asset.
+   *
+   * @throws InputException If Draco compression fails.
+   */
+  static GeneratedAsset generate(const GeneratorOptions &options);
+};
+
+} // namespace gen
+} // namespace gltf2
+
+#endif /* GLTFGenerator_h */
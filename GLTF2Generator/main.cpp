@@ -0,0 +1,118 @@
+#include "GLTFGenerator.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace gltf2::gen;
+
+static void printUsage(const char *program) {
+  std::cerr
+      << "Usage: " << program << " [options] <output>\n"
+      << "\n"
+      << "Generates a synthetic glTF or GLB file. The same options always\n"
+      << "generate the same file. A .glb output embeds up to 4 GiB of\n"
+      << "buffers; a .gltf output stores each buffer of up to 4 GiB in a\n"
+      << ".bin file unless --data-uri is given.\n"
+      << "\n"
+      << "Options:\n"
+      << "  --seed <n>               Random seed. Defaults to 1.\n"
+      << "  --nodes <n>              Number of nodes. Defaults to 1.\n"
+      << "  --branching <n>          0: flat, 1: chain, n: n-ary tree.\n"
+      << "  --meshes <n>             Number of meshes. Defaults to 1.\n"
+      << "  --vertices <n>           Vertices per mesh. Defaults to 1024.\n"
+      << "  --morph-targets <n>      Morph targets per mesh.\n"
+      << "  --sparse <n>             Vertices per sparse accessor.\n"
+      << "  --joints <n>             Joints of a skin shared by all meshes.\n"
+      << "  --animation-channels <n> Channels of a single animation.\n"
+      << "  --keyframes <n>          Keyframes per channel. Defaults to 30.\n"
+      << "  --draco                  Compress meshes with Draco.\n"
+      << "  --rig <vrm0|vrm1>        Add a VRM humanoid rig.\n"
+      << "  --spring-chains <n>      Spring bone chains.\n"
+      << "  --spring-joints <n>      Joints per spring bone chain.\n"
+      << "  --data-uri               Store the buffers of a .gltf as data URIs.\n"
+      << "  -h, --help               Print this help and exit.\n";
+}
+
+int main(int argc, char *argv[]) {
+  GeneratorOptions options;
+  bool dataUri = false;
+  std::optional<std::filesystem::path> output;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto value = [&]() -> std::string {
+      if (i + 1 >= argc) {
+        std::cerr << "missing value for " << arg << std::endl;
+        std::exit(2);
+      }
+      return argv[++i];
+    };
+    auto number = [&]() -> uint32_t {
+      return std::strtoul(value().c_str(), nullptr, 10);
+    };
+    if (arg == "-h" || arg == "--help") {
+      printUsage(argv[0]);
+      return 0;
+    } else if (arg == "--seed") {
+      options.seed = std::strtoull(value().c_str(), nullptr, 10);
+    } else if (arg == "--nodes") {
+      options.nodes = number();
+    } else if (arg == "--branching") {
+      options.branching = number();
+    } else if (arg == "--meshes") {
+      options.meshes = number();
+    } else if (arg == "--vertices") {
+      options.vertices = number();
+    } else if (arg == "--morph-targets") {
+      options.morphTargets = number();
+    } else if (arg == "--sparse") {
+      options.sparseCount = number();
+    } else if (arg == "--joints") {
+      options.joints = number();
+    } else if (arg == "--animation-channels") {
+      options.animationChannels = number();
+    } else if (arg == "--keyframes") {
+      options.keyframes = number();
+    } else if (arg == "--draco") {
+      options.draco = true;
+    } else if (arg == "--rig") {
+      auto rig = value();
+      if (rig == "vrm0") {
+        options.rig = Rig::VRM0;
+      } else if (rig == "vrm1") {
+        options.rig = Rig::VRM1;
+      } else {
+        std::cerr << "unknown rig " << rig << std::endl;
+        return 2;
+      }
+    } else if (arg == "--spring-chains") {
+      options.springChains = number();
+    } else if (arg == "--spring-joints") {
+      options.springJoints = number();
+    } else if (arg == "--data-uri") {
+      dataUri = true;
+    } else if (!arg.empty() && arg[0] == '-') {
+      std::cerr << "unknown option " << arg << std::endl;
+      printUsage(argv[0]);
+      return 2;
+    } else {
+      output = arg;
+    }
+  }
+
+  if (!output) {
+    printUsage(argv[0]);
+    return 2;
+  }
+  auto storage = BufferStorage::Embedded;
+  if (output->extension() == ".gltf")
+    storage = dataUri ? BufferStorage::DataUri : BufferStorage::External;
+
+  try {
+    GLTFGenerator::generate(options).write(*output, storage);
+  } catch (const std::exception &e) {
+    std::cerr << "error: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
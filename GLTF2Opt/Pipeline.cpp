@@ -0,0 +1,152 @@
+#include "Pipeline.h"
+#include "GLTFPrune.h"
+#include "GLTFRepack.h"
+#include <exception>
+#include <system_error>
+
+namespace gltf2 {
+namespace opt {
+
+uint64_t PipelineState::payloadBytes() const {
+  if (writer)
+    return writer->binLength();
+  uint64_t bytes = 0;
+  if (file && file->json().bufferViews) {
+    for (const auto &bufferView : *file->json().bufferViews)
+      bytes += bufferView.byteLength;
+  }
+  return bytes;
+}
+
+static void requireFile(const PipelineState &state, const char *pass) {
+  if (!state.file) {
+    throw std::runtime_error(std::string(pass) +
+                             " must run before the document is repacked");
+  }
+}
+
+static void runPrune(PipelineState &state) {
+  requireFile(state, "prune");
+  state.file = GLTFPrune::prune(std::move(*state.file));
+}
+
+static void runRepack(PipelineState &state) {
+  requireFile(state, "repack");
+  state.writer = GLTFRepack::repack(*state.file);
+  state.file.reset();
+}
+
+static void runOptimize(PipelineState &state) {
+  requireFile(state, "optimize");
+  LoadOptions options;
+  options.vertexWeld = VertexWeldOptions();
+  options.meshOptimization = MeshOptimizeOptions();
+  state.data = GLTFData::load(std::move(*state.file), options);
+  state.file.reset();
+  state.writer = MeshOptimizer::write(*state.data);
+}
+
+static void runDraco(PipelineState &state) {
+  // compresses the primitives as the optimize pass left them
+  if (!state.data) {
+    requireFile(state, "draco");
+    state.data = GLTFData::load(std::move(*state.file));
+    state.file.reset();
+  }
+  state.writer = DracoEncoder().compress(*state.data);
+}
+
+const std::vector<Pass> &availablePasses() {
+  static const std::vector<Pass> passes = {
+      {"prune", "remove resources unreachable from scenes and extensions",
+       runPrune},
+      {"repack",
+       "merge buffers and images into one deduplicated, aligned BIN chunk",
+       runRepack},
+      {"optimize",
+       "merge duplicate vertices, reorder triangle meshes for the vertex "
+       "cache, overdraw and vertex fetch and write the GLB instead of repack "
+       "(opt-in)",
+       runOptimize, true},
+      {"draco",
+       "compress triangle meshes with KHR_draco_mesh_compression and write "
+       "the GLB instead of repack (lossy, opt-in)",
+       runDraco, true},
+  };
+  return passes;
+}
+
+const Pass *findPass(const std::string &name) {
+  for (const auto &pass : availablePasses()) {
+    if (name == pass.name)
+      return &pass;
+  }
+  return nullptr;
+}
+
+/**
+ * @brief The size of a file and of the external files its buffers and images
+ * refer to.
+ */
+static uint64_t inputBytes(const std::filesystem::path &path,
+                           const json::Json &json) {
+  std::error_code ec;
+  uint64_t bytes = std::filesystem::file_size(path, ec);
+  auto addUri = [&](const std::optional<std::string> &uri) {
+    if (!uri || uri->rfind("data:", 0) == 0)
+      return;
+    auto size = std::filesystem::file_size(path.parent_path() / *uri, ec);
+    if (!ec)
+      bytes += size;
+  };
+  if (json.buffers) {
+    for (const auto &buffer : *json.buffers)
+      addUri(buffer.uri);
+  }
+  if (json.images) {
+    for (const auto &image : *json.images)
+      addUri(image.uri);
+  }
+  return bytes;
+}
+
+FileReport runPipeline(const std::filesystem::path &input,
+                       const std::filesystem::path &output,
+                       const std::vector<const Pass *> &passes) {
+  using Clock = std::chrono::steady_clock;
+  FileReport report;
+  report.input = input;
+  report.output = output;
+
+  auto start = Clock::now();
+  try {
+    PipelineState state;
+    state.file = GLTFFile::parseFile(input);
+    report.inputBytes = inputBytes(input, state.file->json());
+
+    auto runPass = [&](const Pass &pass) {
+      PassReport passReport;
+      passReport.name = pass.name;
+      passReport.bytesBefore = state.payloadBytes();
+      auto passStart = Clock::now();
+      pass.run(state);
+      passReport.time = Clock::now() - passStart;
+      passReport.bytesAfter = state.payloadBytes();
+      report.passes.push_back(passReport);
+    };
+    for (const auto *pass : passes)
+      runPass(*pass);
+    if (!state.writer)
+      runPass(*findPass("repack"));
+
+    state.writer->write(output);
+    report.outputBytes = std::filesystem::file_size(output);
+  } catch (const std::exception &e) {
+    report.error = e.what();
+  }
+  report.time = Clock::now() - start;
+  return report;
+}
+
+} // namespace opt
+} // namespace gltf2
@@ -0,0 +1,78 @@
+#ifndef Pipeline_h
+#define Pipeline_h
+
+#include "GLTF2.h"
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace gltf2 {
+namespace opt {
+
+/**
+ * @brief The document being optimized. Passes that edit the glTF document
+ * work on `file`; once it has been repacked into a GLB, `writer` holds the
+ * result and `file` is empty.
+ */
+struct PipelineState {
+  std::optional<GLTFFile> file;
+  /// The loaded data `writer` refers to, if a pass wrote it from loaded data.
+  std::optional<GLTFData> data;
+  std::optional<GLBWriter> writer;
+
+  /**
+   * @brief The number of binary payload bytes the document refers to: the
+   * sum of all bufferView lengths before repacking, and the BIN chunk length
+   * after it.
+   */
+  uint64_t payloadBytes() const;
+};
+
+struct Pass {
+  const char *name;
+  const char *description;
+  void (*run)(PipelineState &state);
+  /// Whether the pass runs only when it is named, because it is lossy.
+  bool optIn = false;
+};
+
+/**
+ * @brief All passes, in their recommended order.
+ */
+const std::vector<Pass> &availablePasses();
+
+const Pass *findPass(const std::string &name);
+
+struct PassReport {
+  std::string name;
+  std::chrono::duration<double, std::milli> time;
+  uint64_t bytesBefore;
+  uint64_t bytesAfter;
+};
+
+struct FileReport {
+  std::filesystem::path input;
+  std::filesystem::path output;
+  uint64_t inputBytes = 0;
+  uint64_t outputBytes = 0;
+  std::chrono::duration<double, std::milli> time{};
+  std::vector<PassReport> passes;
+  std::optional<std::string> error;
+};
+
+/**
+ * @brief Load `input`, run the passes in order and write the result to
+ * `output` as GLB. The document is always repacked before writing.
+ *
+ * Failures are reported in `FileReport::error` rather than thrown.
+ */
+FileReport runPipeline(const std::filesystem::path &input,
+                       const std::filesystem::path &output,
+                       const std::vector<const Pass *> &passes);
+
+} // namespace opt
+} // namespace gltf2
+
+#endif /* Pipeline_h */
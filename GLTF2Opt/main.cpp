@@ -0,0 +1,177 @@
+#include "Pipeline.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+using namespace gltf2::opt;
+
+static void printUsage(const char *program) {
+  std::cerr
+      << "Usage: " << program << " [options] <input>...\n"
+      << "\n"
+      << "Optimizes glTF and GLB files and writes them as GLB.\n"
+      << "\n"
+      << "Options:\n"
+      << "  -o <path>       Output file, or output directory when there are\n"
+      << "                  several inputs. Defaults to <input>.opt.glb.\n"
+      << "  -p <passes>     Comma-separated passes to run in order.\n"
+      << "                  Defaults to every pass that is not opt-in.\n"
+      << "  -j <threads>    Number of files processed in parallel.\n"
+      << "  --list-passes   Print the available passes and exit.\n"
+      << "  -h, --help      Print this help and exit.\n";
+}
+
+static void printPasses() {
+  for (const auto &pass : availablePasses()) {
+    std::printf("  %-12s %s\n", pass.name, pass.description);
+  }
+}
+
+static std::string formatDelta(uint64_t before, uint64_t after) {
+  char buf[128];
+  double percent =
+      before == 0 ? 0 : ((double)after - (double)before) * 100 / before;
+  std::snprintf(buf, sizeof(buf), "%12llu -> %12llu bytes (%+.1f%%)",
+                (unsigned long long)before, (unsigned long long)after,
+                percent);
+  return buf;
+}
+
+static void printReport(const FileReport &report) {
+  std::printf("%s -> %s\n", report.input.string().c_str(),
+              report.output.string().c_str());
+  if (report.error) {
+    std::printf("  error: %s\n", report.error->c_str());
+    return;
+  }
+  for (const auto &pass : report.passes) {
+    std::printf("  %-10s %10.2f ms  %s\n", pass.name.c_str(),
+                pass.time.count(),
+                formatDelta(pass.bytesBefore, pass.bytesAfter).c_str());
+  }
+  std::printf("  %-10s %10.2f ms  %s\n", "total", report.time.count(),
+              formatDelta(report.inputBytes, report.outputBytes).c_str());
+}
+
+int main(int argc, char *argv[]) {
+  std::optional<std::filesystem::path> output;
+  std::vector<const Pass *> passes;
+  bool passesGiven = false;
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::filesystem::path> inputs;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto value = [&]() -> std::string {
+      if (i + 1 >= argc) {
+        std::cerr << "missing value for " << arg << std::endl;
+        std::exit(2);
+      }
+      return argv[++i];
+    };
+    if (arg == "-h" || arg == "--help") {
+      printUsage(argv[0]);
+      return 0;
+    } else if (arg == "--list-passes") {
+      printPasses();
+      return 0;
+    } else if (arg == "-o") {
+      output = value();
+    } else if (arg == "-j") {
+      threads = std::max(1, std::atoi(value().c_str()));
+    } else if (arg == "-p") {
+      passesGiven = true;
+      std::stringstream ss(value());
+      std::string name;
+      while (std::getline(ss, name, ',')) {
+        const auto *pass = findPass(name);
+        if (!pass) {
+          std::cerr << "unknown pass " << name << ". Available passes:\n";
+          printPasses();
+          return 2;
+        }
+        passes.push_back(pass);
+      }
+    } else if (!arg.empty() && arg[0] == '-') {
+      std::cerr << "unknown option " << arg << std::endl;
+      printUsage(argv[0]);
+      return 2;
+    } else {
+      inputs.push_back(arg);
+    }
+  }
+
+  if (inputs.empty()) {
+    printUsage(argv[0]);
+    return 2;
+  }
+  if (!passesGiven) {
+    for (const auto &pass : availablePasses()) {
+      if (!pass.optIn)
+        passes.push_back(&pass);
+    }
+  }
+
+  bool outputDirectory =
+      output && (inputs.size() > 1 || std::filesystem::is_directory(*output));
+  if (outputDirectory) {
+    std::error_code ec;
+    std::filesystem::create_directories(*output, ec);
+    if (ec || !std::filesystem::is_directory(*output)) {
+      std::cerr << "output " << *output
+                << " is not a directory, which several inputs need"
+                << std::endl;
+      return 2;
+    }
+  }
+
+  std::vector<std::filesystem::path> outputs;
+  // the input written to each output, so that none overwrites another
+  std::map<std::filesystem::path, std::filesystem::path> written;
+  for (const auto &input : inputs) {
+    if (!output) {
+      outputs.push_back(std::filesystem::path(input).replace_extension(
+          ".opt.glb"));
+    } else if (!outputDirectory) {
+      outputs.push_back(*output);
+    } else {
+      outputs.push_back(*output /
+                        input.filename().replace_extension(".glb"));
+    }
+    auto [it, inserted] =
+        written.emplace(outputs.back().lexically_normal(), input);
+    if (!inserted) {
+      std::cerr << "inputs " << it->second << " and " << input
+                << " would both be written to " << outputs.back()
+                << std::endl;
+      return 2;
+    }
+  }
+
+  std::vector<FileReport> reports(inputs.size());
+  std::atomic<size_t> next = 0;
+  std::vector<std::future<void>> workers;
+  for (unsigned t = 0; t < std::min<size_t>(threads, inputs.size()); t++) {
+    workers.push_back(std::async(std::launch::async, [&] {
+      for (size_t i = next++; i < inputs.size(); i = next++) {
+        reports[i] = runPipeline(inputs[i], outputs[i], passes);
+      }
+    }));
+  }
+  for (auto &worker : workers)
+    worker.get();
+
+  int failures = 0;
+  for (const auto &report : reports) {
+    printReport(report);
+    if (report.error)
+      failures++;
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -56,8 +56,8 @@ static CGImageRef CGImageRefFromData(NSData *data) {
 - (BOOL)loadFile:(const NSString *)path
            error:(NSError *_Nullable *_Nullable)error {
   try {
-    const auto file = gltf2::GLTFFile::parseFile([path UTF8String]);
-    const auto data = gltf2::GLTFData::load(std::move(file));
+    auto file = gltf2::GLTFFile::parseFile([path UTF8String]);
+    auto data = gltf2::GLTFData::load(std::move(file));
     [self loadScenesWithData:data];
     const auto json = data.moveJson();
     _json = [JsonConverter convertGLTFJson:json];
@@ -0,0 +1,315 @@
+#include "GLTF2.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+
+using namespace gltf2;
+
+namespace {
+
+template <typename T> std::vector<T> randomComponents(size_t count) {
+  std::mt19937 rng((uint32_t)count);
+  std::uniform_int_distribution<int> dist(std::numeric_limits<T>::min(),
+                                          std::numeric_limits<T>::max());
+  std::vector<T> values(count);
+  for (auto &value : values)
+    value = (T)dist(rng);
+  return values;
+}
+
+// The formulas of the glTF spec, one component at a time.
+template <typename T> float expected(T c) {
+  const auto scale = (float)std::numeric_limits<T>::max();
+  if (std::is_signed<T>::value)
+    return std::max((float)c / scale, -1.0f);
+  return (float)c / scale;
+}
+
+template <typename T>
+void expectNormalized(json::Accessor::ComponentType componentType) {
+  // lengths around the vector widths exercise the scalar tails
+  for (size_t count : {0, 1, 7, 8, 15, 16, 17, 33, 1000}) {
+    auto values = randomComponents<T>(count);
+    if (count > 2) {
+      values[0] = std::numeric_limits<T>::min();
+      values[1] = std::numeric_limits<T>::max();
+    }
+    std::vector<float> dst(count);
+    normalizeComponents(values.data(), count, componentType, dst.data());
+    for (size_t i = 0; i < count; i++)
+      ASSERT_EQ(dst[i], expected(values[i]))
+          << "count " << count << " at " << i;
+  }
+}
+
+} // namespace
+
+TEST(AccessorConversion, normalizesByte) {
+  expectNormalized<int8_t>(json::Accessor::ComponentType::BYTE);
+}
+
+TEST(AccessorConversion, normalizesUnsignedByte) {
+  expectNormalized<uint8_t>(json::Accessor::ComponentType::UNSIGNED_BYTE);
+}
+
+TEST(AccessorConversion, normalizesShort) {
+  expectNormalized<int16_t>(json::Accessor::ComponentType::SHORT);
+}
+
+TEST(AccessorConversion, normalizesUnsignedShort) {
+  expectNormalized<uint16_t>(json::Accessor::ComponentType::UNSIGNED_SHORT);
+}
+
+TEST(AccessorConversion, signedRangeEndsAtMinusOne) {
+  const int8_t bytes[] = {-128, -127, 0, 127};
+  const int16_t shorts[] = {-32768, -32767, 0, 32767};
+  float dst[4];
+  normalizeComponents(bytes, 4, json::Accessor::ComponentType::BYTE, dst);
+  EXPECT_EQ(dst[0], -1.0f);
+  EXPECT_EQ(dst[1], -1.0f);
+  EXPECT_EQ(dst[2], 0.0f);
+  EXPECT_EQ(dst[3], 1.0f);
+  normalizeComponents(shorts, 4, json::Accessor::ComponentType::SHORT, dst);
+  EXPECT_EQ(dst[0], -1.0f);
+  EXPECT_EQ(dst[1], -1.0f);
+  EXPECT_EQ(dst[2], 0.0f);
+  EXPECT_EQ(dst[3], 1.0f);
+}
+
+TEST(AccessorConversion, normalizeBufferConvertsAllComponents) {
+  json::Accessor accessor;
+  accessor.componentType = json::Accessor::ComponentType::UNSIGNED_BYTE;
+  accessor.type = json::Accessor::Type::VEC4;
+  accessor.count = 5;
+  accessor.normalized = true;
+  Buffer binary(4 * 5);
+  for (size_t i = 0; i < binary.size(); i++)
+    binary[i] = (uint8_t)(i * 13);
+
+  auto res = normalizeBuffer(binary, accessor);
+  ASSERT_EQ(res.size(), sizeof(float) * 4 * 5);
+  const float *values = (const float *)res.data();
+  for (size_t i = 0; i < binary.size(); i++)
+    EXPECT_EQ(values[i], binary[i] / 255.0f);
+}
+
+TEST(AccessorConversion, convertsStridedElements) {
+  // VEC3 shorts with two bytes of padding after each element
+  const int16_t src[] = {1, -2, 3, 99, 4, -5, 6, 99};
+  float dst[6];
+  convertAccessor<int16_t, float, 3>(src, 8, 2, dst);
+  const float expected[] = {1, -2, 3, 4, -5, 6};
+  EXPECT_TRUE(std::equal(dst, dst + 6, expected));
+
+  convertAccessor<int16_t, float, 3, true>(src, 8, 2, dst);
+  EXPECT_EQ(dst[1], -2 / 32767.0f);
+  EXPECT_EQ(dst[5], 6 / 32767.0f);
+}
+
+TEST(AccessorConversion, convertsNormalizedBetweenTypes) {
+  EXPECT_EQ((convertComponent<float, uint8_t, true>(1.0f)), 255);
+  EXPECT_EQ((convertComponent<float, uint8_t, true>(-0.5f)), 0);
+  EXPECT_EQ((convertComponent<float, int16_t, true>(-1.0f)), -32767);
+  EXPECT_EQ((convertComponent<float, int8_t, true>(0.5f)), 64);
+  EXPECT_EQ((convertComponent<uint8_t, uint16_t, true>(255)), 65535);
+  EXPECT_EQ((convertComponent<uint16_t, uint8_t, true>(65535)), 255);
+  EXPECT_EQ((convertComponent<int8_t, int16_t, true>(-128)), -32767);
+  EXPECT_EQ((convertComponent<uint32_t, uint8_t, false>(258)), 2);
+}
+
+TEST(AccessorConversion, selectsConverterOfAccessor) {
+  EXPECT_EQ((accessorConverter<float>(json::Accessor::ComponentType::BYTE,
+                                      json::Accessor::Type::VEC4, true)),
+            (&convertAccessor<int8_t, float, 4, true>));
+  EXPECT_EQ((accessorConverter<float>(json::Accessor::ComponentType::FLOAT,
+                                      json::Accessor::Type::MAT4, false)),
+            (&convertAccessor<float, float, 16, false>));
+  EXPECT_EQ((accessorConverter<uint32_t>(
+                json::Accessor::ComponentType::UNSIGNED_SHORT,
+                json::Accessor::Type::SCALAR, false)),
+            (&convertAccessor<uint16_t, uint32_t, 1, false>));
+}
+
+TEST(AccessorConversion, loadsInterleavedNormalizedAccessors) {
+  // per vertex: a normalized BYTE VEC3, one byte of padding and a
+  // normalized UNSIGNED_SHORT VEC2
+  const uint32_t count = 37;
+  const uint32_t stride = 8;
+  Buffer vertices(stride * count);
+  for (uint32_t i = 0; i < count; i++) {
+    auto vertex = vertices.data() + stride * i;
+    for (int j = 0; j < 3; j++)
+      vertex[j] = (uint8_t)(int8_t)(i * 7 + j * 50 - 128);
+    uint16_t uv[2] = {(uint16_t)(i * 1771), (uint16_t)(65535 - i)};
+    std::memcpy(vertex + 4, uv, sizeof(uv));
+  }
+
+  json::Json json;
+  json.asset.version = "2.0";
+  GLBWriter writer(std::move(json));
+  auto view = writer.addBufferView(vertices.data(), vertices.size(), 4,
+                                   stride);
+  json::Accessor normals;
+  normals.bufferView = view;
+  normals.componentType = json::Accessor::ComponentType::BYTE;
+  normals.type = json::Accessor::Type::VEC3;
+  normals.count = count;
+  normals.normalized = true;
+  json::Accessor uvs = normals;
+  uvs.byteOffset = 4;
+  uvs.componentType = json::Accessor::ComponentType::UNSIGNED_SHORT;
+  uvs.type = json::Accessor::Type::VEC2;
+  writer.json().accessors = {normals, uvs};
+
+  std::stringstream ss;
+  writer.write(ss);
+  auto data = GLTFData::load(GLTFFile::parseStream(std::move(ss)));
+
+  const auto &normalBuffer = data.accessorBufferAt(0);
+  const auto &uvBuffer = data.accessorBufferAt(1);
+  ASSERT_TRUE(normalBuffer.normalized);
+  ASSERT_EQ(normalBuffer.buffer.size(), sizeof(float) * 3 * count);
+  ASSERT_EQ(uvBuffer.buffer.size(), sizeof(float) * 2 * count);
+  const float *normalValues = (const float *)normalBuffer.buffer.data();
+  const float *uvValues = (const float *)uvBuffer.buffer.data();
+  for (uint32_t i = 0; i < count; i++) {
+    auto vertex = vertices.data() + stride * i;
+    for (int j = 0; j < 3; j++)
+      EXPECT_EQ(normalValues[i * 3 + j], expected((int8_t)vertex[j]));
+    uint16_t uv[2];
+    std::memcpy(uv, vertex + 4, sizeof(uv));
+    EXPECT_EQ(uvValues[i * 2], expected(uv[0]));
+    EXPECT_EQ(uvValues[i * 2 + 1], expected(uv[1]));
+  }
+}
+
+TEST(AccessorConversion, gathersElementsOfEverySize) {
+  std::mt19937 rng(7);
+  for (size_t elementSize = 1; elementSize <= 20; elementSize++) {
+    for (size_t byteStride : {elementSize, elementSize + 1, elementSize + 4,
+                              (elementSize + 3) / 4 * 4 + 16}) {
+      for (size_t count : {0, 1, 2, 3, 17}) {
+        Buffer src(byteStride * count + elementSize);
+        for (auto &b : src)
+          b = (uint8_t)rng();
+        Buffer dst(elementSize * count + 1, 0xcd);
+        gatherElements(src.data(), byteStride, elementSize, count,
+                       dst.data());
+        for (size_t i = 0; i < count; i++) {
+          ASSERT_TRUE(std::equal(dst.begin() + i * elementSize,
+                                 dst.begin() + (i + 1) * elementSize,
+                                 src.begin() + i * byteStride))
+              << "size " << elementSize << " stride " << byteStride;
+        }
+        EXPECT_EQ(dst.back(), 0xcd);
+      }
+    }
+  }
+}
+
+TEST(AccessorConversion, deinterleavesInOnePass) {
+  // per vertex: a VEC3 position, a VEC2 texcoord and a VEC4 tangent
+  const size_t count = 3000;
+  const size_t stride = 36;
+  Buffer vertices(stride * count);
+  for (size_t i = 0; i < vertices.size(); i++)
+    vertices[i] = (uint8_t)(i * 31 + i / 7);
+
+  Buffer positions(12 * count), texcoords(8 * count), tangents(16 * count);
+  deinterleave(vertices.data(), stride, count,
+               {{0, 12, positions.data()},
+                {12, 8, texcoords.data()},
+                {20, 16, tangents.data()}});
+  for (size_t i = 0; i < count; i++) {
+    auto vertex = vertices.begin() + stride * i;
+    ASSERT_TRUE(std::equal(vertex, vertex + 12, positions.begin() + 12 * i));
+    ASSERT_TRUE(
+        std::equal(vertex + 12, vertex + 20, texcoords.begin() + 8 * i));
+    ASSERT_TRUE(
+        std::equal(vertex + 20, vertex + 36, tangents.begin() + 16 * i));
+  }
+}
+
+TEST(AccessorConversion, loadsInterleavedAccessors) {
+  const uint32_t count = 41;
+  const uint32_t stride = 36;
+  std::vector<float> vertices(stride / 4 * count);
+  for (size_t i = 0; i < vertices.size(); i++)
+    vertices[i] = (float)i;
+
+  json::Json json;
+  json.asset.version = "2.0";
+  GLBWriter writer(std::move(json));
+  auto view = writer.addBufferView((const uint8_t *)vertices.data(),
+                                   vertices.size() * sizeof(float), 4, stride);
+  std::vector<json::Accessor> accessors(3);
+  const std::pair<json::Accessor::Type, uint32_t> attributes[] = {
+      {json::Accessor::Type::VEC3, 0},
+      {json::Accessor::Type::VEC2, 12},
+      {json::Accessor::Type::VEC4, 20}};
+  for (size_t i = 0; i < 3; i++) {
+    accessors[i].bufferView = view;
+    accessors[i].byteOffset = attributes[i].second;
+    accessors[i].componentType = json::Accessor::ComponentType::FLOAT;
+    accessors[i].type = attributes[i].first;
+    accessors[i].count = count;
+  }
+  writer.json().accessors = accessors;
+
+  std::stringstream ss;
+  writer.write(ss);
+  auto recorder = std::make_shared<ChromeTraceRecorder>();
+  LoadOptions options;
+  options.tracer = recorder;
+  auto data = GLTFData::load(GLTFFile::parseStream(std::move(ss)), options);
+  auto events = recorder->events();
+  EXPECT_EQ(std::count_if(events.begin(), events.end(),
+                          [](const TraceEvent &event) {
+                            return std::string(event.name) ==
+                                   "deinterleaveAccessorBuffers";
+                          }),
+            1);
+  for (size_t i = 0; i < 3; i++) {
+    auto components =
+        json::Accessor::componentsCountOfType(attributes[i].first);
+    const auto &buffer = data.accessorBufferAt(i).buffer;
+    ASSERT_EQ(buffer.size(), sizeof(float) * components * count);
+    const float *values = (const float *)buffer.data();
+    for (uint32_t v = 0; v < count; v++) {
+      for (uint32_t c = 0; c < components; c++) {
+        EXPECT_EQ(values[v * components + c],
+                  vertices[v * stride / 4 + attributes[i].second / 4 + c]);
+      }
+    }
+  }
+  EXPECT_EQ(data.stats().accessorBytes, sizeof(float) * 9 * count);
+}
+
+TEST(AccessorConversion, convertsFloatsToHalfs) {
+  // ties round to even, and halves below 2^-14 are subnormal
+  const std::vector<std::pair<float, uint16_t>> cases = {
+      {0.0f, 0x0000},
+      {-0.0f, 0x8000},
+      {1.0f, 0x3c00},
+      {-2.0f, 0xc000},
+      {0.5f, 0x3800},
+      {65504.0f, 0x7bff},
+      {1e6f, 0x7c00},
+      {-INFINITY, 0xfc00},
+      {std::ldexp(1.0f, -14), 0x0400},
+      {std::ldexp(1.0f, -24), 0x0001},
+      {1.0f + std::ldexp(1.0f, -11), 0x3c00},
+      {1.0f + 3 * std::ldexp(1.0f, -11), 0x3c02}};
+  // lengths around the vector widths exercise the scalar tails
+  for (size_t count : {1, 7, 8, 9, 17}) {
+    std::vector<float> src(count);
+    std::vector<uint16_t> expected(count);
+    for (size_t i = 0; i < count; i++) {
+      src[i] = cases[i % cases.size()].first;
+      expected[i] = cases[i % cases.size()].second;
+    }
+    std::vector<uint16_t> dst(count);
+    floatsToHalfs(src.data(), count, dst.data());
+    EXPECT_EQ(dst, expected) << "count " << count;
+  }
+}
@@ -0,0 +1,132 @@
+#include "GLTF2.h"
+#include "GLTFExtension.h"
+#include "GLTFGenerator.h"
+#include "MeshPrimitiveTestUtils.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace gltf2;
+
+namespace {
+
+// Two primitives with KHR_draco_mesh_compression whose bufferView does not
+// hold a Draco mesh, or does not exist when `bufferViewOutOfRange`.
+GLTFFile corruptDracoFile(bool bufferViewOutOfRange = false) {
+  const uint8_t garbage[] = {'D', 'R', 'A', 'C', 'O', 2, 2, 1, 0xff, 0xff,
+                             0xff, 0xff};
+
+  json::Json json;
+  json.asset.version = "2.0";
+  json.extensionsUsed = {GLTFExtensionKHRDracoMeshCompression};
+  json.extensionsRequired = {GLTFExtensionKHRDracoMeshCompression};
+  GLBWriter writer(std::move(json));
+  json::MeshPrimitiveDracoExtension extension;
+  extension.bufferView = writer.addBufferView(garbage, sizeof(garbage));
+  if (bufferViewOutOfRange)
+    extension.bufferView++;
+  extension.attributes.position = 0;
+
+  json::Accessor position;
+  position.componentType = json::Accessor::ComponentType::FLOAT;
+  position.type = json::Accessor::Type::VEC3;
+  position.count = 3;
+  writer.json().accessors = {position};
+
+  json::MeshPrimitive primitive;
+  primitive.attributes.position = 0;
+  primitive.dracoExtension = extension;
+  json::Mesh mesh;
+  mesh.primitives = {primitive, primitive};
+  writer.json().meshes = std::vector<json::Mesh>{mesh};
+
+  std::stringstream ss;
+  writer.write(ss);
+  return GLTFFile::parseStream(std::move(ss));
+}
+
+GLTFData generatedData(uint32_t morphTargets) {
+  gen::GeneratorOptions options;
+  options.meshes = 4;
+  options.nodes = 4;
+  options.vertices = 256;
+  options.joints = 4;
+  options.morphTargets = morphTargets;
+  return GLTFData::load(gen::GLTFGenerator::generate(options).file());
+}
+
+GLTFData reload(GLBWriter &writer) {
+  std::stringstream ss;
+  writer.write(ss);
+  return GLTFData::load(GLTFFile::parseStream(std::move(ss)));
+}
+
+} // namespace
+
+TEST(DracoCompression, throwsOnCorruptMesh) {
+  EXPECT_THROW(GLTFData::load(corruptDracoFile()), InvalidFormatException);
+
+  InlineExecutor executor;
+  LoadOptions options;
+  options.executor = &executor;
+  EXPECT_THROW(GLTFData::load(corruptDracoFile(), options),
+               InvalidFormatException);
+}
+
+TEST(DracoCompression, throwsOnBufferViewOutOfRange) {
+  EXPECT_THROW(GLTFData::load(corruptDracoFile(true)), InvalidFormatException);
+}
+
+TEST(DracoCompression, encodesMeshPrimitives) {
+  auto data = generatedData(0);
+  DracoEncodeOptions options;
+  options.encodingSpeed = 10;
+  auto writer = DracoEncoder(options).compress(data);
+  EXPECT_LT(writer.binLength(), GLTFRepack::repack(data).binLength());
+  const auto &required = *writer.json().extensionsRequired;
+  EXPECT_NE(std::find(required.begin(), required.end(),
+                      GLTFExtensionKHRDracoMeshCompression),
+            required.end());
+
+  auto compressed = reload(writer);
+  for (uint32_t i = 0; i < data.json().meshes->size(); i++) {
+    const auto &primitive = compressed.json().meshes->at(i).primitives[0];
+    ASSERT_TRUE(primitive.dracoExtension);
+    const auto &expected = data.meshPrimitiveAt(i, 0);
+    const auto &loaded = compressed.meshPrimitiveAt(i, 0);
+    EXPECT_EQ(loaded.element->primitiveCount,
+              expected.element->primitiveCount);
+    ASSERT_EQ(loaded.sources.joints.size(), 1);
+    EXPECT_EQ(loaded.sources.joints[0].componentType,
+              expected.sources.joints[0].componentType);
+    EXPECT_EQ(loaded.sources.texcoords.size(),
+              expected.sources.texcoords.size());
+  }
+}
+
+TEST(DracoCompression, keepsVertexOrderWithMorphTargets) {
+  auto data = generatedData(1);
+  auto writer = DracoEncoder().compress(data);
+  auto compressed = reload(writer);
+  const auto &expected = data.meshPrimitiveAt(0, 0);
+  const auto &loaded = compressed.meshPrimitiveAt(0, 0);
+  ASSERT_EQ(loaded.targets.size(), 1);
+  EXPECT_EQ(indicesOf(*loaded.element), indicesOf(*expected.element));
+
+  const auto &accessor = compressed.json().accessors->at(
+      *compressed.json().meshes->at(0).primitives[0].attributes.position);
+  // 14 quantization bits over the largest extent
+  float extent = 0;
+  for (uint32_t c = 0; c < 3; c++)
+    extent = std::max(extent, accessor.max->at(c) - accessor.min->at(c));
+  auto positions = loaded.sources.position->toFloatBuffer();
+  auto expectedPositions = expected.sources.position->toFloatBuffer();
+  ASSERT_EQ(positions.size(), expectedPositions.size());
+  const auto *values = (const float *)positions.data();
+  const auto *expectedValues = (const float *)expectedPositions.data();
+  for (size_t i = 0; i < positions.size() / sizeof(float); i++) {
+    EXPECT_NEAR(values[i], expectedValues[i], extent / (1 << 13));
+    // the bounds contain the decoded positions
+    EXPECT_GE(values[i], accessor.min->at(i % 3));
+    EXPECT_LE(values[i], accessor.max->at(i % 3));
+  }
+}
@@ -0,0 +1,106 @@
+#include "GLTF2.h"
+#include "GLTFGenerator.h"
+#include <gtest/gtest.h>
+#include <numeric>
+#ifdef GLTF2_TEST_TBB
+#include "TBBExecutor.h"
+#endif
+
+using namespace gltf2;
+
+static GLTFFile generateFile() {
+  gen::GeneratorOptions options;
+  options.meshes = 8;
+  options.vertices = 256;
+  options.morphTargets = 2;
+  return gen::GLTFGenerator::generate(options).file();
+}
+
+static void expectLoads(Executor &executor) {
+  LoadOptions options;
+  options.executor = &executor;
+  auto data = GLTFData::load(generateFile(), options);
+  auto reference = GLTFData::load(generateFile());
+  for (uint32_t i = 0; i < 8; i++) {
+    EXPECT_EQ(data.meshPrimitiveAt(i, 0).sources.position->buffer,
+              reference.meshPrimitiveAt(i, 0).sources.position->buffer);
+  }
+}
+
+TEST(Executor, parallelForCallsEachIndexOnce) {
+  ThreadPoolExecutor executor(4);
+  std::vector<std::atomic<int>> calls(1000);
+  executor.parallelFor(calls.size(), [&](size_t i) { calls[i]++; });
+  for (const auto &count : calls)
+    EXPECT_EQ(count, 1);
+}
+
+TEST(Executor, nestedParallelForOnOneThread) {
+  // every level waits on the next; the callers must do the work themselves
+  ThreadPoolExecutor executor(1);
+  std::atomic<int> sum = 0;
+  executor.parallelFor(4, [&](size_t) {
+    executor.parallelFor(4, [&](size_t) {
+      executor.parallelFor(4, [&](size_t i) { sum += (int)i; });
+    });
+  });
+  EXPECT_EQ(sum, 16 * 6);
+}
+
+TEST(Executor, parallelForRethrows) {
+  ThreadPoolExecutor executor(2);
+  std::atomic<int> calls = 0;
+  EXPECT_THROW(executor.parallelFor(10,
+                                    [&](size_t i) {
+                                      calls++;
+                                      if (i == 3)
+                                        throw std::runtime_error("fail");
+                                    }),
+               std::runtime_error);
+  EXPECT_EQ(calls, 10);
+}
+
+TEST(Executor, runsHigherPriorityFirst) {
+  ThreadPoolExecutor executor(1);
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  executor.submit([released] { released.wait(); });
+
+  std::mutex mutex;
+  std::vector<TaskPriority> order;
+  std::promise<void> done;
+  for (auto priority :
+       {TaskPriority::Low, TaskPriority::Normal, TaskPriority::High}) {
+    executor.submit(
+        [&, priority] {
+          std::lock_guard<std::mutex> lock(mutex);
+          order.push_back(priority);
+          if (order.size() == 3)
+            done.set_value();
+        },
+        priority);
+  }
+  release.set_value();
+  done.get_future().wait();
+  EXPECT_EQ(order, (std::vector<TaskPriority>{
+                       TaskPriority::High, TaskPriority::Normal,
+                       TaskPriority::Low}));
+}
+
+TEST(Executor, loadsInline) {
+  InlineExecutor executor;
+  expectLoads(executor);
+}
+
+TEST(Executor, loadsOnPool) {
+  ThreadPoolExecutor executor(2);
+  expectLoads(executor);
+}
+
+#ifdef GLTF2_TEST_TBB
+TEST(Executor, loadsOnTBB) {
+  tbb::task_arena arena(2);
+  TBBExecutor executor(arena);
+  expectLoads(executor);
+}
+#endif
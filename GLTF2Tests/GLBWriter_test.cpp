@@ -0,0 +1,106 @@
+#include "GLBFormat.h"
+#include "GLBWriter.h"
+#include "GLTF2.h"
+#include "JsonDecoder.h"
+#include "config.h"
+#include "nlohmann/json.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace gltf2;
+
+static json::Json minimalJson() {
+  json::Json json;
+  json.asset.version = "2.0";
+  return json;
+}
+
+static std::string writeToString(const GLBWriter &writer) {
+  std::stringstream ss;
+  writer.write(ss);
+  return ss.str();
+}
+
+TEST(GLBWriter, alignsBufferViews) {
+  GLBWriter writer(minimalJson());
+  Buffer a = {1, 2, 3};
+  Buffer b = {4, 5, 6, 7, 8};
+  EXPECT_EQ(writer.addBufferView(a.data(), a.size()), 0);
+  EXPECT_EQ(writer.addBufferView(b.data(), b.size(), 16, 4), 1);
+  EXPECT_EQ(writer.binLength(), 21);
+
+  auto glb = writeToString(writer);
+  EXPECT_EQ(glb.size() % 4, 0);
+
+  GLBHeader header;
+  std::memcpy(&header, glb.data(), sizeof(GLBHeader));
+  EXPECT_EQ(header.magic, GLBHeaderMagic);
+  EXPECT_EQ(header.version, 2);
+  EXPECT_EQ(header.length, glb.size());
+
+  auto file = GLTFFile::parseStream(std::istringstream(glb));
+  const auto &bufferViews = *file.json().bufferViews;
+  ASSERT_EQ(bufferViews.size(), 2);
+  EXPECT_EQ(bufferViews[0].byteOffset, 0);
+  EXPECT_EQ(bufferViews[0].byteLength, 3);
+  EXPECT_EQ(bufferViews[1].byteOffset, 16);
+  EXPECT_EQ(bufferViews[1].byteLength, 5);
+  EXPECT_EQ(bufferViews[1].byteStride, 4);
+  EXPECT_EQ(file.json().buffers->at(0).byteLength, 21);
+
+  const auto &bin = *file.bin();
+  EXPECT_EQ(bin.size(), 24);
+  EXPECT_TRUE(std::equal(a.begin(), a.end(), bin.begin()));
+  EXPECT_TRUE(std::equal(b.begin(), b.end(), bin.begin() + 16));
+  EXPECT_TRUE(std::all_of(bin.begin() + 3, bin.begin() + 16,
+                          [](uint8_t v) { return v == 0; }));
+}
+
+TEST(GLBWriter, deduplicatesPayloads) {
+  GLBWriter writer(minimalJson());
+  EXPECT_EQ(writer.addBufferView(Buffer{1, 2, 3, 4, 5, 6, 7, 8}), 0);
+  EXPECT_EQ(writer.addBufferView(Buffer{9, 9, 9, 9}), 1);
+  EXPECT_EQ(writer.addBufferView(Buffer{1, 2, 3, 4, 5, 6, 7, 8}), 2);
+  EXPECT_EQ(writer.bufferViewCount(), 3);
+  EXPECT_EQ(writer.binLength(), 12);
+
+  auto file = GLTFFile::parseStream(std::istringstream(writeToString(writer)));
+  const auto &bufferViews = *file.json().bufferViews;
+  EXPECT_EQ(bufferViews[0].byteOffset, bufferViews[2].byteOffset);
+  EXPECT_EQ(bufferViews[1].byteOffset, 8);
+}
+
+TEST(GLBWriter, withoutBufferViews) {
+  GLBWriter writer(minimalJson());
+  auto file = GLTFFile::parseStream(std::istringstream(writeToString(writer)));
+  EXPECT_FALSE(file.bin().has_value());
+  EXPECT_FALSE(file.json().buffers.has_value());
+  EXPECT_EQ(file.json().asset.version, "2.0");
+}
+
+TEST(GLBWriter, fromData) {
+  json::Json json = minimalJson();
+  json.buffers = std::vector<json::Buffer>{
+      {std::nullopt, 10, std::nullopt, std::nullopt}};
+  json.bufferViews = std::vector<json::BufferView>{
+      {0, 0, 6, std::nullopt, std::nullopt, std::string("a"), std::nullopt},
+      {0, 6, 4, std::nullopt, std::nullopt, std::nullopt, std::nullopt}};
+
+  GLBWriter source(json);
+  Buffer bin = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  source.addBufferView(bin.data(), 6, 4, std::nullopt, std::nullopt,
+                       std::string("a"));
+  source.addBufferView(bin.data() + 6, 4);
+
+  auto data = GLTFData::load(
+      GLTFFile::parseStream(std::istringstream(writeToString(source))));
+  auto writer = GLBWriter::fromData(data);
+  EXPECT_EQ(writer.bufferViewCount(), 2);
+
+  auto file = GLTFFile::parseStream(std::istringstream(writeToString(writer)));
+  const auto &bufferViews = *file.json().bufferViews;
+  EXPECT_EQ(bufferViews[0].name, "a");
+  EXPECT_EQ(bufferViews[1].byteOffset, 8);
+  EXPECT_EQ(file.bin()->at(8), 6);
+  EXPECT_EQ(file.bin()->at(11), 9);
+}
@@ -0,0 +1,112 @@
+#include "GLTF2.h"
+
+#ifdef GLTF2_HAS_COROUTINES
+
+#include "GLTFGenerator.h"
+#include <condition_variable>
+#include <deque>
+#include <gtest/gtest.h>
+#include <set>
+#include <thread>
+
+using namespace gltf2;
+
+namespace {
+
+class TestExecutor : public Executor {
+public:
+  explicit TestExecutor(unsigned threads) {
+    for (unsigned i = 0; i < threads; i++) {
+      _threads.emplace_back([this] {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true) {
+          _cv.wait(lock, [this] { return _stop || !_queue.empty(); });
+          if (_queue.empty())
+            return;
+          auto fn = std::move(_queue.front());
+          _queue.pop_front();
+          _ids.insert(std::this_thread::get_id());
+          lock.unlock();
+          fn();
+          lock.lock();
+        }
+      });
+    }
+  }
+
+  ~TestExecutor() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _cv.notify_all();
+    for (auto &thread : _threads)
+      thread.join();
+  }
+
+  void submit(std::function<void()> fn,
+              TaskPriority priority = TaskPriority::Normal) override {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _queue.push_back(std::move(fn));
+      _submitted++;
+    }
+    _cv.notify_one();
+  }
+
+  size_t concurrency() const override { return _threads.size(); }
+
+  size_t submitted() const { return _submitted; }
+
+  std::set<std::thread::id> ids() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _ids;
+  }
+
+private:
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::deque<std::function<void()>> _queue;
+  std::vector<std::thread> _threads;
+  std::set<std::thread::id> _ids;
+  size_t _submitted = 0;
+  bool _stop = false;
+};
+
+std::filesystem::path writeAsset(const std::string &name) {
+  gen::GeneratorOptions options;
+  options.meshes = 2;
+  options.vertices = 64;
+  auto path = std::filesystem::temp_directory_path() / name;
+  gen::GLTFGenerator::generate(options).write(path,
+                                              gen::BufferStorage::External);
+  return path;
+}
+
+Task<size_t> countVertices(std::filesystem::path path, Executor &executor) {
+  auto document = co_await loadAsync(path, executor);
+  size_t vertices = 0;
+  for (uint32_t i = 0; i < document->json().meshes->size(); i++)
+    vertices += document->meshPrimitiveAt(i, 0)->sources.position->vectorCount;
+  co_return vertices;
+}
+
+} // namespace
+
+TEST(GLTFAsync, loadsOnExecutor) {
+  auto path = writeAsset("gltf2-async.gltf");
+  TestExecutor executor(2);
+  EXPECT_EQ(startTask(countVertices(path, executor)).get(), 2 * 64);
+  // one resumption per stage, and the work of the stages
+  EXPECT_GT(executor.submitted(), 4);
+  auto callers = executor.ids();
+  EXPECT_EQ(callers.count(std::this_thread::get_id()), 0);
+}
+
+TEST(GLTFAsync, propagatesExceptions) {
+  TestExecutor executor(1);
+  auto future = startTask(loadAsync("/nonexistent/gltf2.glb", executor));
+  EXPECT_THROW(future.get(), InputException);
+}
+
+#endif
@@ -0,0 +1,73 @@
+#include "GLTF2.h"
+#include "GLTFGenerator.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace gltf2;
+
+static GLTFDocumentPtr loadDocument() {
+  gen::GeneratorOptions options;
+  options.meshes = 4;
+  options.vertices = 100;
+  options.morphTargets = 1;
+  return GLTFDocument::load(gen::GLTFGenerator::generate(options).file());
+}
+
+TEST(GLTFDocument, handlesKeepDocumentAlive) {
+  auto document = loadDocument();
+  std::weak_ptr<const GLTFDocument> weak = document;
+  auto primitive = document->meshPrimitiveAt(1, 0);
+  auto mesh = document->meshAt(1);
+  const auto *expected = &document->data().meshPrimitiveAt(1, 0);
+
+  document.reset();
+  EXPECT_FALSE(weak.expired());
+  EXPECT_EQ(primitive.get(), expected);
+  EXPECT_EQ(primitive->sources.position->vectorCount, 100);
+  EXPECT_EQ(mesh->primitives.size(), 1);
+
+  primitive.reset();
+  mesh.reset();
+  EXPECT_TRUE(weak.expired());
+}
+
+TEST(GLTFDocument, sharesAcrossThreads) {
+  auto document = loadDocument();
+  auto meshCount = document->json().meshes->size();
+
+  std::vector<std::thread> threads;
+  std::vector<uint64_t> sums(8);
+  for (size_t t = 0; t < sums.size(); t++) {
+    threads.emplace_back([document, meshCount, &sums, t] {
+      for (uint32_t i = 0; i < meshCount; i++) {
+        auto primitive = document->meshPrimitiveAt(i, 0);
+        for (auto byte : primitive->sources.position->buffer)
+          sums[t] += byte;
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  for (auto sum : sums)
+    EXPECT_EQ(sum, sums[0]);
+}
+
+TEST(GLTFDocument, moveJsonMoves) {
+  gen::GeneratorOptions options;
+  options.vertices = 16;
+  auto data = GLTFData::load(gen::GLTFGenerator::generate(options).file());
+  const auto *meshes = data.json().meshes->data();
+  auto json = data.moveJson();
+  // the meshes were moved, not copied
+  EXPECT_EQ(json.meshes->data(), meshes);
+}
+
+TEST(GLTFDocument, freezesOnlyLoadedData) {
+  gen::GeneratorOptions options;
+  options.vertices = 16;
+  GLTFData data(gen::GLTFGenerator::generate(options).file());
+  data.loadPhase(LoadPhase::Buffers);
+  data.loadPhase(LoadPhase::BufferViews);
+  EXPECT_FALSE(data.isLoaded());
+  EXPECT_THROW(GLTFDocument::freeze(std::move(data)), InputException);
+}
@@ -0,0 +1,135 @@
+#include "GLTF2.h"
+#include "GLTFGenerator.h"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <set>
+#include <sstream>
+
+using namespace gltf2;
+
+static std::string writeToString(const gen::GeneratedAsset &asset) {
+  std::stringstream ss;
+  asset.glb().write(ss);
+  return ss.str();
+}
+
+TEST(GLTFGenerator, isDeterministic) {
+  gen::GeneratorOptions options;
+  options.seed = 42;
+  options.nodes = 20;
+  options.meshes = 3;
+  options.vertices = 100;
+  options.morphTargets = 2;
+  options.sparseCount = 10;
+  options.joints = 4;
+  options.animationChannels = 5;
+
+  auto a = writeToString(gen::GLTFGenerator::generate(options));
+  auto b = writeToString(gen::GLTFGenerator::generate(options));
+  EXPECT_EQ(a, b);
+
+  options.seed = 43;
+  EXPECT_NE(a, writeToString(gen::GLTFGenerator::generate(options)));
+}
+
+TEST(GLTFGenerator, generatesLoadableAsset) {
+  gen::GeneratorOptions options;
+  options.nodes = 7;
+  options.branching = 2;
+  options.meshes = 2;
+  options.vertices = 1000;
+  options.morphTargets = 1;
+  options.sparseCount = 16;
+  options.joints = 3;
+  options.animationChannels = 4;
+  options.keyframes = 10;
+  options.rig = gen::Rig::VRM1;
+  options.springChains = 2;
+  options.springJoints = 3;
+
+  auto file = gen::GLTFGenerator::generate(options).file();
+  const auto &json = file.json();
+  // 7 mesh nodes, 3 joints, 15 humanoid bones and 2 spring chains
+  EXPECT_EQ(json.nodes->size(), 7 + 3 + 15 + 2 * 3);
+  EXPECT_EQ(json.nodes->at(2).children->size(), 2);
+  EXPECT_EQ(json.meshes->size(), 2);
+  EXPECT_EQ(json.skins->at(0).joints.size(), 3);
+  EXPECT_EQ(json.animations->at(0).channels.size(), 4);
+  ASSERT_TRUE(json.vrm1.has_value());
+  EXPECT_EQ(json.springBone->springs->size(), 2);
+
+  const auto &primitive = json.meshes->at(0).primitives.at(0);
+  const auto &target = json.accessors->at(*primitive.targets->at(0).position);
+  EXPECT_FALSE(target.bufferView.has_value());
+  EXPECT_EQ(target.sparse->count, 16);
+
+  auto data = GLTFData::load(std::move(file));
+  // a 32 x 32 grid
+  const auto &position = data.meshPrimitiveAt(0, 0).sources.position;
+  ASSERT_TRUE(position.has_value());
+  EXPECT_EQ(position->vectorCount, 1024);
+  EXPECT_EQ(data.meshPrimitiveAt(0, 0).element->primitiveCount, 31 * 31 * 2);
+}
+
+TEST(GLTFGenerator, writesDataUri) {
+  gen::GeneratorOptions options;
+  options.vertices = 16;
+  auto asset = gen::GLTFGenerator::generate(options);
+  auto data = GLTFData::load(GLTFFile::parseStream(
+      std::istringstream(asset.gltf())));
+  EXPECT_EQ(data.bufferAt(0), asset.bin());
+}
+
+TEST(GLTFGenerator, targetsEachNodePathOnce) {
+  gen::GeneratorOptions options;
+  options.nodes = 5;
+  options.vertices = 16;
+  options.animationChannels = 100;
+  auto asset = gen::GLTFGenerator::generate(options);
+  const auto &channels = asset.json().animations->at(0).channels;
+  EXPECT_EQ(channels.size(), 5 * 3);
+  std::set<std::pair<uint32_t, json::AnimationChannelTarget::Path>> targets;
+  for (const auto &channel : channels)
+    targets.emplace(*channel.target.node, channel.target.path);
+  EXPECT_EQ(targets.size(), channels.size());
+
+  options.keyframes = 0;
+  EXPECT_THROW(gen::GLTFGenerator::generate(options), InvalidFormatException);
+}
+
+TEST(GLTFGenerator, splitsBuffersOverMaxBytes) {
+  gen::GeneratorOptions options;
+  options.meshes = 3;
+  options.nodes = 3;
+  options.vertices = 100;
+  auto single = gen::GLTFGenerator::generate(options);
+  options.maxBufferBytes = 4096;
+  auto split = gen::GLTFGenerator::generate(options);
+  ASSERT_GT(split.bins().size(), 1);
+  EXPECT_EQ(split.json().buffers->size(), split.bins().size());
+  for (const auto &bin : split.bins())
+    EXPECT_LE(bin.size(), options.maxBufferBytes);
+
+  auto expected = GLTFData::load(GLTFFile::parseStream(
+      std::istringstream(single.gltf())));
+  auto dir = std::filesystem::temp_directory_path() / "gltf2_generator_test";
+  std::filesystem::create_directories(dir);
+  split.write(dir / "split.gltf", gen::BufferStorage::External);
+  EXPECT_TRUE(std::filesystem::exists(dir / "split_1.bin"));
+  std::vector<GLTFFile> files;
+  files.push_back(GLTFFile::parseFile(dir / "split.gltf"));
+  files.push_back(GLTFFile::parseStream(std::istringstream(split.gltf())));
+  files.push_back(split.file());
+  for (auto &file : files) {
+    auto data = GLTFData::load(std::move(file));
+    for (uint32_t i = 0; i < 3; i++) {
+      EXPECT_EQ(data.meshPrimitiveAt(i, 0).sources.position->buffer,
+                expected.meshPrimitiveAt(i, 0).sources.position->buffer);
+    }
+  }
+  std::filesystem::remove_all(dir);
+
+  // a payload larger than a buffer cannot be split
+  options.maxBufferBytes = 64;
+  EXPECT_THROW(gen::GLTFGenerator::generate(options), InputException);
+}
@@ -0,0 +1,157 @@
+#include "GLTF2.h"
+#include "GLTFPrune.h"
+#include "JsonDecoder.h"
+#include "nlohmann/json.hpp"
+#include <gtest/gtest.h>
+
+using namespace gltf2;
+
+static json::Json prunableJson() {
+  return json::JsonDecoder::decode(nlohmann::json::parse(R"({
+    "asset": {"version": "2.0"},
+    "scenes": [{"nodes": [0]}],
+    "nodes": [
+      {"mesh": 0, "children": [1]},
+      {"skin": 0},
+      {"mesh": 1},
+      {"name": "collider"},
+      {"name": "springBone"}
+    ],
+    "meshes": [
+      {"primitives": [{"attributes": {"POSITION": 0}, "material": 1}]},
+      {"primitives": [{"attributes": {"POSITION": 1}, "material": 0}]}
+    ],
+    "materials": [
+      {"pbrMetallicRoughness": {"baseColorTexture": {"index": 0}}},
+      {"pbrMetallicRoughness": {"baseColorTexture": {"index": 1}}}
+    ],
+    "textures": [{"source": 0, "sampler": 0}, {"source": 1}],
+    "images": [{"uri": "a.png"}, {"uri": "b.png"}],
+    "samplers": [{}],
+    "accessors": [
+      {"bufferView": 1, "componentType": 5126, "count": 1, "type": "VEC3"},
+      {"bufferView": 0, "componentType": 5126, "count": 1, "type": "VEC3"},
+      {"bufferView": 2, "componentType": 5126, "count": 1, "type": "MAT4"}
+    ],
+    "bufferViews": [
+      {"buffer": 0, "byteLength": 12},
+      {"buffer": 1, "byteLength": 12},
+      {"buffer": 1, "byteOffset": 12, "byteLength": 64}
+    ],
+    "buffers": [
+      {"uri": "a.bin", "byteLength": 12},
+      {"uri": "b.bin", "byteLength": 76}
+    ],
+    "skins": [{"inverseBindMatrices": 2, "joints": [1]}],
+    "extensions": {
+      "VRMC_springBone": {
+        "specVersion": "1.0",
+        "colliders": [
+          {"node": 3, "shape": {"sphere": {"offset": [0, 0, 0], "radius": 0.1}}}
+        ]
+      },
+      "VRM": {
+        "secondaryAnimation": {"boneGroups": [{"bones": [4], "center": -1}]}
+      }
+    }
+  })"));
+}
+
+TEST(GLTFPrune, removesUnreachable) {
+  auto json = prunableJson();
+  auto result = GLTFPrune::prune(json);
+
+  EXPECT_EQ(result.accessors, 1);
+  EXPECT_EQ(result.buffers, 1);
+  EXPECT_EQ(result.bufferViews, 1);
+  EXPECT_EQ(result.images, 1);
+  EXPECT_EQ(result.materials, 1);
+  EXPECT_EQ(result.meshes, 1);
+  EXPECT_EQ(result.nodes, 1);
+  EXPECT_EQ(result.samplers, 1);
+  EXPECT_EQ(result.skins, 0);
+  EXPECT_EQ(result.textures, 1);
+  EXPECT_EQ(result.total(), 9);
+
+  EXPECT_EQ(json.nodes->size(), 4);
+  EXPECT_EQ(json.meshes->size(), 1);
+  EXPECT_EQ(json.materials->size(), 1);
+  EXPECT_EQ(json.textures->size(), 1);
+  EXPECT_FALSE(json.samplers->size());
+  EXPECT_EQ(json.images->at(0).uri, "b.png");
+  EXPECT_EQ(json.buffers->at(0).uri, "b.bin");
+}
+
+TEST(GLTFPrune, remapsIndices) {
+  auto json = prunableJson();
+  GLTFPrune::prune(json);
+
+  EXPECT_EQ(json.scenes->at(0).nodes, std::vector<uint32_t>({0}));
+  EXPECT_EQ(json.nodes->at(0).mesh, 0);
+  EXPECT_EQ(json.nodes->at(0).children, std::vector<uint32_t>({1}));
+  EXPECT_EQ(json.nodes->at(1).skin, 0);
+  EXPECT_EQ(json.nodes->at(2).name, "collider");
+
+  const auto &primitive = json.meshes->at(0).primitives.at(0);
+  EXPECT_EQ(primitive.attributes.position, 0);
+  EXPECT_EQ(primitive.material, 0);
+  EXPECT_EQ(json.materials->at(0).pbrMetallicRoughness->baseColorTexture->index,
+            0);
+  EXPECT_EQ(json.textures->at(0).source, 0);
+  EXPECT_FALSE(json.textures->at(0).sampler.has_value());
+
+  EXPECT_EQ(json.accessors->at(0).bufferView, 0);
+  EXPECT_EQ(json.accessors->at(1).bufferView, 1);
+  EXPECT_EQ(json.skins->at(0).inverseBindMatrices, 1);
+  EXPECT_EQ(json.skins->at(0).joints, std::vector<uint32_t>({1}));
+  EXPECT_EQ(json.bufferViews->at(0).buffer, 0);
+  EXPECT_EQ(json.bufferViews->at(1).buffer, 0);
+
+  EXPECT_EQ(json.springBone->colliders->at(0).node, 2);
+  const auto &spring = json.vrm0->secondaryAnimation->boneGroups->at(0);
+  EXPECT_EQ(spring.bones, std::vector<uint32_t>({3}));
+  EXPECT_EQ(spring.center, -1);
+}
+
+TEST(GLTFPrune, keepsAllNodesWithoutScenes) {
+  auto json = prunableJson();
+  json.scenes.reset();
+  auto result = GLTFPrune::prune(json);
+  EXPECT_EQ(result.nodes, 0);
+  EXPECT_EQ(result.meshes, 0);
+  EXPECT_EQ(result.materials, 0);
+}
+
+TEST(GLTFPrune, outOfRange) {
+  auto json = prunableJson();
+  json.nodes->at(0).mesh = 5;
+  EXPECT_THROW(GLTFPrune::prune(json), InvalidFormatException);
+}
+
+TEST(GLTFPrune, keepsVRM0MaterialTextures) {
+  auto json = json::JsonDecoder::decode(nlohmann::json::parse(R"({
+    "asset": {"version": "2.0"},
+    "textures": [{"source": 0}, {"source": 1}, {"source": 2}],
+    "images": [{"uri": "a.png"}, {"uri": "b.png"}, {"uri": "c.png"}],
+    "extensions": {
+      "VRM": {
+        "materialProperties": [{
+          "name": "face",
+          "shader": "VRM/MToon",
+          "textureProperties": {"_ShadeTexture": 2, "_SphereAdd": 0}
+        }]
+      }
+    }
+  })"));
+  auto result = GLTFPrune::prune(json);
+
+  EXPECT_EQ(result.textures, 1);
+  EXPECT_EQ(result.images, 1);
+  ASSERT_EQ(json.textures->size(), 2);
+  const auto &textures =
+      *json.vrm0->materialProperties->at(0).textureProperties;
+  EXPECT_EQ(textures.at("_SphereAdd"), 0);
+  EXPECT_EQ(textures.at("_ShadeTexture"), 1);
+  EXPECT_EQ(json.textures->at(1).source, 1);
+  EXPECT_EQ(json.images->at(1).uri, "c.png");
+}
@@ -0,0 +1,102 @@
+#include "GLTF2.h"
+#include "cppcodec/base64_rfc4648.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace gltf2;
+
+static const uint8_t imageBytes[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A,
+                                     '\n'};
+
+static std::filesystem::path writeMultiFileGLTF() {
+  auto dir = std::filesystem::temp_directory_path() / "gltf2_repack_test";
+  std::filesystem::create_directories(dir);
+
+  Buffer bin(32);
+  for (uint32_t i = 0; i < bin.size(); i++)
+    bin[i] = i;
+  std::ofstream(dir / "data.bin", std::ios::binary)
+      .write(reinterpret_cast<const char *>(bin.data()), bin.size());
+  std::ofstream(dir / "image.png", std::ios::binary)
+      .write(reinterpret_cast<const char *>(imageBytes), sizeof(imageBytes));
+
+  Buffer embedded(16);
+  for (uint32_t i = 0; i < embedded.size(); i++)
+    embedded[i] = 100 + i;
+  auto dataUri = "data:application/octet-stream;base64," +
+                 cppcodec::base64_rfc4648::encode(embedded);
+
+  std::ofstream(dir / "model.gltf") << R"({
+    "asset": {"version": "2.0"},
+    "buffers": [
+      {"uri": "data.bin", "byteLength": 32},
+      {"uri": ")" << dataUri << R"(", "byteLength": 16}
+    ],
+    "bufferViews": [
+      {"buffer": 0, "byteOffset": 0, "byteLength": 12},
+      {"buffer": 0, "byteOffset": 16, "byteLength": 8},
+      {"buffer": 1, "byteOffset": 4, "byteLength": 8}
+    ],
+    "accessors": [
+      {"bufferView": 0, "componentType": 5126, "count": 1, "type": "VEC3"},
+      {"bufferView": 2, "componentType": 5126, "count": 2, "type": "SCALAR"}
+    ],
+    "images": [{"uri": "image.png"}]
+  })";
+  return dir / "model.gltf";
+}
+
+static void expectRepacked(const GLTFFile &file) {
+  const auto &json = file.json();
+  ASSERT_EQ(json.buffers->size(), 1);
+  EXPECT_FALSE(json.buffers->at(0).uri.has_value());
+
+  const auto &bufferViews = *json.bufferViews;
+  ASSERT_EQ(bufferViews.size(), 3);
+  EXPECT_EQ(bufferViews[0].byteOffset, 0);
+  EXPECT_EQ(bufferViews[0].byteLength, 12);
+  EXPECT_EQ(bufferViews[1].byteOffset, 12);
+  EXPECT_EQ(bufferViews[1].byteLength, 8);
+  EXPECT_EQ(bufferViews[2].byteOffset, 20);
+  EXPECT_EQ(bufferViews[2].byteLength, sizeof(imageBytes));
+
+  EXPECT_EQ(json.accessors->at(0).bufferView, 0);
+  EXPECT_EQ(json.accessors->at(1).bufferView, 1);
+
+  const auto &image = json.images->at(0);
+  EXPECT_FALSE(image.uri.has_value());
+  EXPECT_EQ(image.bufferView, 2);
+  EXPECT_EQ(image.mimeType, json::Image::MimeType::PNG);
+
+  const auto &bin = *file.bin();
+  EXPECT_EQ(bin.size(), 28);
+  EXPECT_EQ(bin[11], 11);
+  EXPECT_EQ(bin[12], 104);
+  EXPECT_EQ(bin[19], 111);
+  EXPECT_TRUE(std::equal(std::begin(imageBytes), std::end(imageBytes),
+                         bin.begin() + 20));
+}
+
+static GLTFFile reparse(const GLBWriter &writer) {
+  std::stringstream ss;
+  writer.write(ss);
+  return GLTFFile::parseStream(std::move(ss));
+}
+
+TEST(GLTFRepack, repackFile) {
+  auto path = writeMultiFileGLTF();
+  expectRepacked(reparse(GLTFRepack::repack(GLTFFile::parseFile(path))));
+}
+
+TEST(GLTFRepack, repackData) {
+  auto path = writeMultiFileGLTF();
+  auto data = GLTFData::load(GLTFFile::parseFile(path));
+  expectRepacked(reparse(GLTFRepack::repack(data)));
+}
+
+TEST(GLTFRepack, repackPath) {
+  auto path = writeMultiFileGLTF();
+  auto dst = path.parent_path() / "model.glb";
+  GLTFRepack::repack(path, dst);
+  expectRepacked(GLTFFile::parseFile(dst));
+}
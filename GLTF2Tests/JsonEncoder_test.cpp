@@ -0,0 +1,57 @@
+#include "GLTF2.h"
+#include "JsonDecoder.h"
+#include "JsonEncoder.h"
+#include "config.h"
+#include "nlohmann/json.hpp"
+#include <gtest/gtest.h>
+
+using namespace gltf2;
+
+static nlohmann::json readRawJson(const char *path) {
+  std::ifstream fs;
+  fs.open(path, std::ios::binary);
+  return nlohmann::json::parse(fs);
+}
+
+static void expectRoundTrip(const char *path) {
+  const auto decoded = json::JsonDecoder::decode(readRawJson(path));
+  const auto encoded = json::JsonEncoder::encode(decoded);
+  const auto redecoded = json::JsonDecoder::decode(encoded);
+  EXPECT_EQ(json::JsonEncoder::encode(redecoded), encoded);
+}
+
+TEST(JsonEncoder, roundTripGLTF) { expectRoundTrip(GLTF_JSON_PATH); }
+
+TEST(JsonEncoder, roundTripVRM0) { expectRoundTrip(VRM0_JSON_PATH); }
+
+TEST(JsonEncoder, roundTripVRM1) { expectRoundTrip(VRM1_JSON_PATH); }
+
+TEST(JsonEncoder, roundTripSpringBone) { expectRoundTrip(SPRINGBONE_JSON_PATH); }
+
+TEST(JsonEncoder, roundTripMToon) { expectRoundTrip(MTOON_JSON_PATH); }
+
+TEST(JsonEncoder, preservesSourceKeys) {
+  const auto raw = readRawJson(GLTF_JSON_PATH);
+  const auto encoded =
+      json::JsonEncoder::encode(json::JsonDecoder::decode(raw));
+
+  EXPECT_EQ(encoded["accessors"], raw["accessors"]);
+  EXPECT_EQ(encoded["bufferViews"], raw["bufferViews"]);
+  EXPECT_EQ(encoded["asset"]["version"], raw["asset"]["version"]);
+  EXPECT_EQ(encoded["extensionsUsed"], raw["extensionsUsed"]);
+  EXPECT_EQ(encoded["meshes"][0]["primitives"][0]["attributes"],
+            raw["meshes"][0]["primitives"][0]["attributes"]);
+}
+
+TEST(JsonEncoder, vrm1HumanBones) {
+  const auto raw = readRawJson(VRM1_JSON_PATH);
+  const auto encoded =
+      json::JsonEncoder::encode(json::JsonDecoder::decode(raw));
+
+  const auto &bones = encoded["extensions"]["VRMC_vrm"]["humanoid"]["humanBones"];
+  const auto &rawBones = raw["extensions"]["VRMC_vrm"]["humanoid"]["humanBones"];
+  EXPECT_EQ(bones.size(), rawBones.size());
+  for (const auto &[name, bone] : rawBones.items()) {
+    EXPECT_EQ(bones[name]["node"], bone["node"]) << name;
+  }
+}
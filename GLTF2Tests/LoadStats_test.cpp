@@ -0,0 +1,47 @@
+#include "GLTF2.h"
+#include "GLTFGenerator.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace gltf2;
+
+TEST(LoadStats, recordsLoad) {
+  gen::GeneratorOptions options;
+  options.meshes = 2;
+  options.vertices = 100;
+  options.morphTargets = 1;
+  options.sparseCount = 8;
+  auto asset = gen::GLTFGenerator::generate(options);
+  std::stringstream ss;
+  asset.glb().write(ss);
+  auto glbSize = ss.str().size();
+
+  auto data = GLTFData::load(GLTFFile::parseStream(std::move(ss)));
+  auto stats = data.stats();
+  EXPECT_GT(stats.parse.wall.count(), 0);
+  EXPECT_EQ(stats.bytesFromFiles, glbSize);
+  EXPECT_EQ(stats.bytesFromDataUris, 0);
+  EXPECT_EQ(stats.bufferBytes, data.bufferAt(0).size());
+  EXPECT_GT(stats.accessorBytes, 0);
+  EXPECT_GT(stats.primitiveBytes, 0);
+  EXPECT_GT(stats.morphTargetBytes, 0);
+  EXPECT_GT(stats.meshPrimitives.wall.count(), 0);
+  // 1 sparse morph target per mesh
+  EXPECT_EQ(stats.sparseAccessors, 2);
+  EXPECT_EQ(stats.normalizedAccessors, 0);
+  EXPECT_EQ(stats.dracoPrimitives, 0);
+  // one task per phase at least
+  EXPECT_GE(stats.tasks, 5);
+}
+
+TEST(LoadStats, countsDataUriBytes) {
+  gen::GeneratorOptions options;
+  options.vertices = 16;
+  auto asset = gen::GLTFGenerator::generate(options);
+  auto gltf = asset.gltf();
+  auto data =
+      GLTFData::load(GLTFFile::parseStream(std::istringstream(gltf)));
+  auto stats = data.stats();
+  EXPECT_EQ(stats.bytesFromFiles, gltf.size());
+  EXPECT_EQ(stats.bytesFromDataUris, asset.bin().size());
+}
@@ -0,0 +1,67 @@
+#include "GLTF2.h"
+#include "GLTFGenerator.h"
+#include "nlohmann/json.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace gltf2;
+
+TEST(LoadTrace, recordsTasks) {
+  gen::GeneratorOptions options;
+  options.meshes = 3;
+  options.vertices = 64;
+  auto file = gen::GLTFGenerator::generate(options).file();
+  auto accessorCount = file.json().accessors->size();
+
+  auto recorder = std::make_shared<ChromeTraceRecorder>();
+  LoadOptions loadOptions;
+  loadOptions.tracer = recorder;
+  auto data = GLTFData::load(std::move(file), loadOptions);
+
+  std::map<std::string, int> counts;
+  for (const auto &event : recorder->events()) {
+    counts[event.name]++;
+    EXPECT_LE(event.begin, event.end);
+    if (std::string(event.name) == "loadAccessorBufferAt") {
+      ASSERT_TRUE(event.index.has_value());
+      EXPECT_EQ(event.bytes, data.accessorBufferAt(*event.index).buffer.size());
+    }
+    if (std::string(event.name) == "loadMeshPrimitiveAt") {
+      EXPECT_TRUE(event.primitiveIndex.has_value());
+    }
+  }
+  EXPECT_EQ(counts["loadBuffers"], 1);
+  EXPECT_EQ(counts["loadBufferAt"], 1);
+  EXPECT_EQ(counts["loadAccessorBufferAt"], accessorCount);
+  EXPECT_EQ(counts["loadMeshPrimitiveAt"], 3);
+}
+
+TEST(LoadTrace, writesChromeTraceJson) {
+  gen::GeneratorOptions options;
+  options.vertices = 16;
+  auto recorder = std::make_shared<ChromeTraceRecorder>();
+  LoadOptions loadOptions;
+  loadOptions.tracer = recorder;
+  GLTFData::load(gen::GLTFGenerator::generate(options).file(), loadOptions);
+
+  std::stringstream ss;
+  recorder->write(ss);
+  auto trace = nlohmann::json::parse(ss.str());
+  const auto &events = trace.at("traceEvents");
+  size_t completeEvents = 0;
+  for (const auto &event : events) {
+    if (event.at("ph") == "X") {
+      completeEvents++;
+      EXPECT_GE(event.at("dur").get<double>(), 0);
+      EXPECT_TRUE(event.at("args").contains("bytes"));
+    }
+  }
+  EXPECT_EQ(completeEvents, recorder->events().size());
+}
+
+TEST(LoadTrace, isOffByDefault) {
+  gen::GeneratorOptions options;
+  options.vertices = 16;
+  auto data = GLTFData::load(gen::GLTFGenerator::generate(options).file());
+  EXPECT_EQ(data.options().tracer, nullptr);
+}
@@ -0,0 +1,76 @@
+#include "GLTF2.h"
+#include "GLTFGenerator.h"
+#include "nlohmann/json.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace gltf2;
+
+static gen::GeneratorOptions generatorOptions() {
+  gen::GeneratorOptions options;
+  options.meshes = 2;
+  options.vertices = 256;
+  options.morphTargets = 1;
+  options.sparseCount = 8;
+  return options;
+}
+
+TEST(MemoryBudget, estimateMatchesLoad) {
+  auto asset = gen::GLTFGenerator::generate(generatorOptions());
+  auto data = GLTFData::load(asset.file());
+  auto estimate = data.estimateMemory();
+  EXPECT_GT(estimate.accessors, 0);
+  EXPECT_GT(estimate.morphTargets, 0);
+  EXPECT_EQ(data.allocatedBytes(), estimate.total());
+}
+
+TEST(MemoryBudget, rejectsDocumentOverBudget) {
+  auto asset = gen::GLTFGenerator::generate(generatorOptions());
+  auto total = GLTFData(asset.file()).estimateMemory().total();
+
+  LoadOptions options;
+  options.memoryBudget = total - 1;
+  EXPECT_THROW(GLTFData::load(asset.file(), options),
+               MemoryBudgetException);
+
+  options.memoryBudget = total;
+  auto data = GLTFData::load(asset.file(), options);
+  EXPECT_EQ(data.allocatedBytes(), total);
+}
+
+TEST(MemoryBudget, budgetsEachPhase) {
+  auto asset = gen::GLTFGenerator::generate(generatorOptions());
+  LoadOptions options;
+  options.memoryBudget = 1024;
+  GLTFData data(asset.file(), options);
+  // the buffer alone exceeds the budget
+  EXPECT_THROW(data.loadBuffers().get(), MemoryBudgetException);
+  EXPECT_EQ(data.allocatedBytes(), 0);
+}
+
+TEST(MemoryBudget, rejectsAccessorOutOfBufferView) {
+  gen::GeneratorOptions generator;
+  generator.vertices = 16;
+  auto gltf = nlohmann::json::parse(
+      gen::GLTFGenerator::generate(generator).gltf());
+  gltf["accessors"][0]["count"] = 1 << 30;
+  auto file = [&] {
+    return GLTFFile::parseStream(std::istringstream(gltf.dump()));
+  };
+
+  EXPECT_THROW(GLTFData::load(file()), InvalidFormatException);
+
+  LoadOptions options;
+  options.memoryBudget = 1 << 20;
+  EXPECT_THROW(GLTFData::load(file(), options), MemoryBudgetException);
+}
+
+TEST(MemoryBudget, rejectsIndexOutOfRange) {
+  gen::GeneratorOptions generator;
+  generator.vertices = 16;
+  auto gltf = nlohmann::json::parse(
+      gen::GLTFGenerator::generate(generator).gltf());
+  gltf["meshes"][0]["primitives"][0]["attributes"]["POSITION"] = 99;
+  auto file = GLTFFile::parseStream(std::istringstream(gltf.dump()));
+  EXPECT_THROW(estimateMemory(file.json()), InvalidFormatException);
+}
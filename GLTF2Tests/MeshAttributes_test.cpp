@@ -0,0 +1,78 @@
+#include "GLTF2.h"
+#include "GLTFGenerator.h"
+#include <gtest/gtest.h>
+
+using namespace gltf2;
+
+namespace {
+
+GLTFFile skinnedFile(bool draco) {
+  gen::GeneratorOptions options;
+  options.vertices = 256;
+  options.joints = 4;
+  options.morphTargets = 1;
+  options.draco = draco;
+  return gen::GLTFGenerator::generate(options).file();
+}
+
+} // namespace
+
+TEST(MeshAttributes, loadsAllByDefault) {
+  auto data = GLTFData::load(skinnedFile(false));
+  const auto &primitive = data.meshPrimitiveAt(0, 0);
+  EXPECT_TRUE(primitive.sources.normal);
+  EXPECT_EQ(primitive.sources.texcoords.size(), 1);
+  EXPECT_EQ(primitive.sources.joints.size(), 1);
+  EXPECT_EQ(primitive.sources.weights.size(), 1);
+}
+
+TEST(MeshAttributes, skipsAttributes) {
+  auto all = GLTFData::load(skinnedFile(false));
+  LoadOptions options;
+  options.skippedAttributes = MeshAttributes::Texcoords |
+                              MeshAttributes::Joints | MeshAttributes::Weights;
+  auto data = GLTFData::load(skinnedFile(false), options);
+  const auto &primitive = data.meshPrimitiveAt(0, 0);
+  EXPECT_EQ(primitive.sources.position->buffer,
+            all.meshPrimitiveAt(0, 0).sources.position->buffer);
+  EXPECT_TRUE(primitive.sources.normal);
+  EXPECT_TRUE(primitive.sources.texcoords.empty());
+  EXPECT_TRUE(primitive.sources.joints.empty());
+  EXPECT_TRUE(primitive.sources.weights.empty());
+  EXPECT_LT(data.stats().primitiveBytes, all.stats().primitiveBytes);
+
+  options.skippedAttributes = MeshAttributes::All;
+  auto positions = GLTFData::load(skinnedFile(false), options);
+  const auto &geometry = positions.meshPrimitiveAt(0, 0);
+  EXPECT_TRUE(geometry.sources.position);
+  EXPECT_TRUE(geometry.element);
+  EXPECT_FALSE(geometry.sources.normal);
+  ASSERT_EQ(geometry.targets.size(), 1);
+  EXPECT_TRUE(geometry.targets[0].position);
+  EXPECT_FALSE(geometry.targets[0].normal);
+}
+
+TEST(MeshAttributes, loadsDracoAttributesByUniqueId) {
+  auto plain = GLTFData::load(skinnedFile(false));
+  auto data = GLTFData::load(skinnedFile(true));
+  const auto &expected = plain.meshPrimitiveAt(0, 0).sources;
+  const auto &sources = data.meshPrimitiveAt(0, 0).sources;
+  ASSERT_EQ(sources.joints.size(), 1);
+  ASSERT_EQ(sources.weights.size(), 1);
+  // joints and weights are stored losslessly
+  EXPECT_EQ(sources.joints[0].componentType,
+            json::Accessor::ComponentType::UNSIGNED_SHORT);
+  EXPECT_EQ(sources.joints[0].buffer, expected.joints[0].buffer);
+  EXPECT_EQ(sources.weights[0].buffer, expected.weights[0].buffer);
+  ASSERT_EQ(sources.texcoords.size(), 1);
+  EXPECT_EQ(sources.texcoords[0].componentsPerVector, 2);
+
+  LoadOptions options;
+  options.skippedAttributes = MeshAttributes::All;
+  auto geometry = GLTFData::load(skinnedFile(true), options);
+  const auto &geometrySources = geometry.meshPrimitiveAt(0, 0).sources;
+  EXPECT_EQ(geometrySources.position->buffer, sources.position->buffer);
+  EXPECT_FALSE(geometrySources.normal);
+  EXPECT_TRUE(geometrySources.texcoords.empty());
+  EXPECT_TRUE(geometrySources.joints.empty());
+}
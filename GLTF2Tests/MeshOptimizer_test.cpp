@@ -0,0 +1,223 @@
+#include "GLTF2.h"
+#include "GLTFGenerator.h"
+#include "MeshPrimitiveTestUtils.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <random>
+#include <sstream>
+
+using namespace gltf2;
+
+namespace {
+
+template <typename T>
+MeshPrimitiveElement elementOf(const std::vector<T> &indices,
+                               json::MeshPrimitive::Mode mode =
+                                   json::MeshPrimitive::Mode::TRIANGLES) {
+  MeshPrimitiveElement element;
+  element.buffer.resize(indices.size() * sizeof(T));
+  std::memcpy(element.buffer.data(), indices.data(), element.buffer.size());
+  element.primitiveMode = mode;
+  element.primitiveCount = (uint32_t)indices.size() / 3;
+  element.componentType = ComponentTypeOf<T>::value;
+  return element;
+}
+
+using Triangle = std::array<float, 9>;
+
+/// The positions of every triangle, each starting at its smallest corner so
+/// that triangles compare equal however the optimizer rotates them.
+std::vector<Triangle> trianglesOf(const MeshPrimitive &primitive) {
+  auto positions = valuesOf<float>(*primitive.sources.position);
+  auto indices = indicesOf(*primitive.element);
+  std::vector<Triangle> triangles;
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    Triangle triangle;
+    for (size_t j = 0; j < 3; j++) {
+      for (size_t c = 0; c < 3; c++)
+        triangle[j * 3 + c] = positions[indices[i + j] * 3 + c];
+    }
+    Triangle smallest = triangle;
+    for (size_t r = 1; r < 3; r++) {
+      std::rotate(triangle.begin(), triangle.begin() + 3, triangle.end());
+      smallest = std::min(smallest, triangle);
+    }
+    triangles.push_back(smallest);
+  }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+/// The vertices transformed per triangle by a FIFO cache of 16 vertices.
+float averageCacheMissRatio(const std::vector<uint32_t> &indices) {
+  std::deque<uint32_t> cache;
+  size_t misses = 0;
+  for (auto index : indices) {
+    if (std::find(cache.begin(), cache.end(), index) != cache.end())
+      continue;
+    misses++;
+    cache.push_back(index);
+    if (cache.size() > 16)
+      cache.pop_front();
+  }
+  return (float)misses / (indices.size() / 3);
+}
+
+GLTFData generatedData(LoadOptions loadOptions = LoadOptions()) {
+  gen::GeneratorOptions options;
+  options.meshes = 3;
+  options.nodes = 3;
+  options.vertices = 500;
+  options.morphTargets = 2;
+  options.sparseCount = 20;
+  return GLTFData::load(gen::GLTFGenerator::generate(options).file(),
+                        loadOptions);
+}
+
+} // namespace
+
+TEST(MeshOptimizer, reordersVerticesInFetchOrder) {
+  MeshPrimitive primitive;
+  primitive.sources.position =
+      sourceOf<float>({0, 0, 0, 1, 0, 0, 9, 9, 9, 0, 1, 0, 1, 1, 0}, 3);
+  primitive.sources.texcoords.push_back(
+      sourceOf<float>({0, 0, 1, 0, 9, 9, 0, 1, 1, 1}, 2));
+  // a sparse morph target over zeros that displaces vertices 0 and 4
+  auto sparse = std::make_shared<SparseAccessorBuffer>();
+  sparse->count = 5;
+  sparse->elementSize = 12;
+  sparse->indices = {0, 4};
+  std::vector<float> deltas = {1, 2, 3, 4, 5, 6};
+  sparse->values.resize(24);
+  std::memcpy(sparse->values.data(), deltas.data(), 24);
+  auto &target = primitive.targets.emplace_back();
+  target.position = sourceOf<float>({}, 3);
+  target.position->vectorCount = 5;
+  target.position->sparse = sparse;
+  // vertex 2 is unused
+  primitive.element = elementOf<uint16_t>({4, 3, 1, 1, 3, 0});
+
+  MeshOptimizeOptions options;
+  options.vertexCache = false;
+  options.overdraw = false;
+  ASSERT_TRUE(MeshOptimizer(options).optimize(primitive));
+
+  EXPECT_EQ(primitive.element->componentType,
+            json::Accessor::ComponentType::UNSIGNED_SHORT);
+  EXPECT_EQ(indicesOf(*primitive.element),
+            (std::vector<uint32_t>{0, 1, 2, 2, 1, 3}));
+  EXPECT_EQ(primitive.sources.position->vectorCount, 4);
+  EXPECT_EQ(valuesOf<float>(*primitive.sources.position),
+            (std::vector<float>{1, 1, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0}));
+  EXPECT_EQ(valuesOf<float>(primitive.sources.texcoords[0]),
+            (std::vector<float>{1, 1, 0, 1, 1, 0, 0, 0}));
+  const auto &remapped = target.position->sparse;
+  ASSERT_TRUE(remapped);
+  EXPECT_EQ(remapped->count, 4);
+  EXPECT_EQ(remapped->indices, (std::vector<uint32_t>{0, 3}));
+  EXPECT_EQ(valuesOf<float>(*target.position),
+            (std::vector<float>{4, 5, 6, 0, 0, 0, 0, 0, 0, 1, 2, 3}));
+}
+
+TEST(MeshOptimizer, skipsOtherPrimitives) {
+  MeshPrimitive lines;
+  lines.sources.position = sourceOf<float>({0, 0, 0, 1, 0, 0}, 3);
+  lines.element = elementOf<uint8_t>({0, 1}, json::MeshPrimitive::Mode::LINES);
+  EXPECT_FALSE(MeshOptimizer().optimize(lines));
+
+  MeshPrimitive outOfRange;
+  outOfRange.sources.position = sourceOf<float>({0, 0, 0, 1, 0, 0}, 3);
+  outOfRange.element = elementOf<uint8_t>({0, 1, 2});
+  EXPECT_FALSE(MeshOptimizer().optimize(outOfRange));
+  EXPECT_EQ(indicesOf(*outOfRange.element),
+            (std::vector<uint32_t>{0, 1, 2}));
+}
+
+TEST(MeshOptimizer, improvesVertexCacheOfShuffledGrid) {
+  const uint32_t size = 32;
+  std::vector<float> positions;
+  for (uint32_t y = 0; y <= size; y++) {
+    for (uint32_t x = 0; x <= size; x++) {
+      positions.insert(positions.end(), {(float)x, (float)y, 0});
+    }
+  }
+  std::vector<std::array<uint32_t, 3>> triangles;
+  for (uint32_t y = 0; y < size; y++) {
+    for (uint32_t x = 0; x < size; x++) {
+      uint32_t i = y * (size + 1) + x;
+      triangles.push_back({i, i + 1, i + size + 1});
+      triangles.push_back({i + 1, i + size + 2, i + size + 1});
+    }
+  }
+  std::shuffle(triangles.begin(), triangles.end(), std::mt19937(1));
+  std::vector<uint32_t> indices;
+  for (const auto &triangle : triangles)
+    indices.insert(indices.end(), triangle.begin(), triangle.end());
+
+  MeshPrimitive primitive;
+  primitive.sources.position = sourceOf(positions, 3);
+  primitive.element = elementOf(indices);
+  auto before = trianglesOf(primitive);
+  ASSERT_TRUE(MeshOptimizer().optimize(primitive));
+  EXPECT_EQ(trianglesOf(primitive), before);
+  EXPECT_LE(averageCacheMissRatio(indicesOf(*primitive.element)),
+            averageCacheMissRatio(indices));
+}
+
+TEST(MeshOptimizer, optimizesPrimitivesOnLoad) {
+  auto data = generatedData();
+  LoadOptions options;
+  options.meshOptimization = MeshOptimizeOptions();
+  auto optimized = generatedData(options);
+  ASSERT_EQ(optimized.json().meshes->size(), 3);
+  for (uint32_t i = 0; i < optimized.json().meshes->size(); i++) {
+    const auto &primitive = optimized.meshPrimitiveAt(i, 0);
+    const auto &original = data.meshPrimitiveAt(i, 0);
+    ASSERT_TRUE(primitive.element);
+    EXPECT_EQ(trianglesOf(primitive), trianglesOf(original));
+    // vertices are numbered in the order the indices first use them
+    uint32_t next = 0;
+    for (auto index : indicesOf(*primitive.element)) {
+      ASSERT_LE(index, next);
+      if (index == next)
+        next++;
+    }
+    EXPECT_EQ(next, primitive.sources.position->vectorCount);
+    ASSERT_EQ(primitive.targets.size(), original.targets.size());
+    for (const auto &target : primitive.targets)
+      EXPECT_EQ(target.position->vectorCount, next);
+  }
+}
+
+TEST(MeshOptimizer, writesOptimizedPrimitives) {
+  LoadOptions options;
+  options.meshOptimization = MeshOptimizeOptions();
+  options.keepSparseAccessors = true;
+  auto data = generatedData(options);
+  auto writer = MeshOptimizer::write(data);
+  std::stringstream ss;
+  writer.write(ss);
+  auto written = GLTFData::load(GLTFFile::parseStream(std::move(ss)));
+
+  for (uint32_t i = 0; i < data.json().meshes->size(); i++) {
+    const auto &primitive = data.meshPrimitiveAt(i, 0);
+    const auto &reloaded = written.meshPrimitiveAt(i, 0);
+    EXPECT_EQ(indicesOf(*reloaded.element), indicesOf(*primitive.element));
+    EXPECT_EQ(valuesOf<float>(*reloaded.sources.position),
+              valuesOf<float>(*primitive.sources.position));
+    ASSERT_EQ(reloaded.sources.texcoords.size(),
+              primitive.sources.texcoords.size());
+    ASSERT_EQ(reloaded.targets.size(), primitive.targets.size());
+    for (size_t t = 0; t < primitive.targets.size(); t++) {
+      EXPECT_EQ(valuesOf<float>(*reloaded.targets[t].position),
+                valuesOf<float>(*primitive.targets[t].position));
+    }
+    const auto &accessor =
+        written.json()
+            .accessors->at(*written.json().meshes->at(i).primitives[0]
+                                .attributes.position);
+    EXPECT_TRUE(accessor.min && accessor.max);
+  }
+}
@@ -0,0 +1,53 @@
+#ifndef MeshPrimitiveTestUtils_h
+#define MeshPrimitiveTestUtils_h
+
+#include "GLTF2.h"
+#include <cstring>
+#include <vector>
+
+namespace gltf2 {
+
+/// A tightly packed source holding `values`, `components` per vector.
+template <typename T>
+MeshPrimitiveSource sourceOf(const std::vector<T> &values,
+                             uint8_t components) {
+  MeshPrimitiveSource source;
+  source.buffer.resize(values.size() * sizeof(T));
+  std::memcpy(source.buffer.data(), values.data(), source.buffer.size());
+  source.vectorCount = (uint32_t)(values.size() / components);
+  source.componentsPerVector = components;
+  source.componentType = ComponentTypeOf<T>::value;
+  return source;
+}
+
+/// The indices of an element, whatever their component type.
+inline std::vector<uint32_t> indicesOf(const MeshPrimitiveElement &element) {
+  std::vector<uint32_t> indices;
+  const auto *data = element.buffer.data();
+  switch (element.componentType) {
+  case json::Accessor::ComponentType::UNSIGNED_SHORT:
+    for (size_t i = 0; i < element.buffer.size() / 2; i++)
+      indices.push_back(((const uint16_t *)data)[i]);
+    break;
+  case json::Accessor::ComponentType::UNSIGNED_INT:
+    for (size_t i = 0; i < element.buffer.size() / 4; i++)
+      indices.push_back(((const uint32_t *)data)[i]);
+    break;
+  default:
+    indices.assign(data, data + element.buffer.size());
+  }
+  return indices;
+}
+
+/// The values of a source, with its sparse substitution applied.
+template <typename T>
+std::vector<T> valuesOf(const MeshPrimitiveSource &source) {
+  auto buffer = source.sparse ? source.sparse->toBuffer() : source.buffer;
+  std::vector<T> values(buffer.size() / sizeof(T));
+  std::memcpy(values.data(), buffer.data(), buffer.size());
+  return values;
+}
+
+} // namespace gltf2
+
+#endif /* MeshPrimitiveTestUtils_h */
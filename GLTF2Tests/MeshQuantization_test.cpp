@@ -0,0 +1,123 @@
+#include "GLTF2.h"
+#include "GLTFExtension.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace gltf2;
+
+namespace {
+
+const uint32_t vertexCount = 21;
+
+// A mesh with KHR_mesh_quantization attributes: SHORT positions, normalized
+// BYTE normals padded to 4 bytes and normalized UNSIGNED_SHORT texcoords.
+GLTFFile quantizedFile() {
+  std::vector<int16_t> positions(3 * vertexCount);
+  std::vector<int8_t> normals(4 * vertexCount);
+  std::vector<uint16_t> texcoords(2 * vertexCount);
+  for (uint32_t i = 0; i < vertexCount; i++) {
+    positions[i * 3] = (int16_t)(i * 1000 - 10000);
+    positions[i * 3 + 1] = (int16_t)i;
+    positions[i * 3 + 2] = -1;
+    normals[i * 4] = (int8_t)(i * 12 - 127);
+    normals[i * 4 + 1] = (int8_t)-128;
+    normals[i * 4 + 2] = 127;
+    texcoords[i * 2] = (uint16_t)(i * 3000);
+    texcoords[i * 2 + 1] = 65535;
+  }
+
+  json::Json json;
+  json.asset.version = "2.0";
+  json.extensionsUsed = {GLTFExtensionKHRMeshQuantization};
+  json.extensionsRequired = {GLTFExtensionKHRMeshQuantization};
+  GLBWriter writer(std::move(json));
+  auto addAccessor = [&](const void *data, uint32_t bytes,
+                         std::optional<uint32_t> byteStride,
+                         json::Accessor::ComponentType componentType,
+                         json::Accessor::Type type, bool normalized) {
+    json::Accessor accessor;
+    accessor.bufferView =
+        writer.addBufferView((const uint8_t *)data, bytes, 4, byteStride);
+    accessor.componentType = componentType;
+    accessor.type = type;
+    accessor.count = vertexCount;
+    if (normalized)
+      accessor.normalized = true;
+    auto &accessors = writer.json().accessors;
+    if (!accessors)
+      accessors.emplace();
+    accessors->push_back(accessor);
+    return (uint32_t)accessors->size() - 1;
+  };
+
+  json::MeshPrimitive primitive;
+  primitive.attributes.position = addAccessor(
+      positions.data(), positions.size() * sizeof(int16_t), std::nullopt,
+      json::Accessor::ComponentType::SHORT, json::Accessor::Type::VEC3, false);
+  primitive.attributes.normal =
+      addAccessor(normals.data(), normals.size(), 4,
+                  json::Accessor::ComponentType::BYTE,
+                  json::Accessor::Type::VEC3, true);
+  primitive.attributes.texcoords = std::vector<uint32_t>{addAccessor(
+      texcoords.data(), texcoords.size() * sizeof(uint16_t), std::nullopt,
+      json::Accessor::ComponentType::UNSIGNED_SHORT,
+      json::Accessor::Type::VEC2, true)};
+  json::Mesh mesh;
+  mesh.primitives.push_back(primitive);
+  writer.json().meshes = std::vector<json::Mesh>{mesh};
+
+  std::stringstream ss;
+  writer.write(ss);
+  return GLTFFile::parseStream(std::move(ss));
+}
+
+} // namespace
+
+TEST(MeshQuantization, expandsNormalizedAttributesByDefault) {
+  auto data = GLTFData::load(quantizedFile());
+  const auto &sources = data.meshPrimitiveAt(0, 0).sources;
+  EXPECT_EQ(sources.position->componentType,
+            json::Accessor::ComponentType::SHORT);
+  EXPECT_EQ(sources.normal->componentType,
+            json::Accessor::ComponentType::FLOAT);
+  EXPECT_FALSE(sources.normal->normalized);
+  EXPECT_EQ(sources.normal->buffer.size(), sizeof(float) * 3 * vertexCount);
+  EXPECT_EQ(sources.texcoords[0].componentType,
+            json::Accessor::ComponentType::FLOAT);
+}
+
+TEST(MeshQuantization, keepsQuantizedAttributes) {
+  auto expanded = GLTFData::load(quantizedFile());
+  LoadOptions options;
+  options.keepQuantizedAttributes = true;
+  auto data = GLTFData::load(quantizedFile(), options);
+  EXPECT_LT(data.allocatedBytes(), expanded.allocatedBytes());
+
+  const auto &sources = data.meshPrimitiveAt(0, 0).sources;
+  const auto &expandedSources = expanded.meshPrimitiveAt(0, 0).sources;
+
+  const auto &normal = *sources.normal;
+  EXPECT_EQ(normal.componentType, json::Accessor::ComponentType::BYTE);
+  EXPECT_TRUE(normal.normalized);
+  EXPECT_EQ(normal.buffer.size(), 3 * vertexCount);
+  EXPECT_EQ(normal.dequantizationScale(), 1.0f / 127);
+  EXPECT_EQ(normal.toFloatBuffer(), expandedSources.normal->buffer);
+
+  const auto &texcoord = sources.texcoords[0];
+  EXPECT_EQ(texcoord.componentType,
+            json::Accessor::ComponentType::UNSIGNED_SHORT);
+  EXPECT_TRUE(texcoord.normalized);
+  EXPECT_EQ(texcoord.buffer.size(), sizeof(uint16_t) * 2 * vertexCount);
+  EXPECT_EQ(texcoord.toFloatBuffer(), expandedSources.texcoords[0].buffer);
+
+  const auto &position = *sources.position;
+  EXPECT_FALSE(position.normalized);
+  EXPECT_EQ(position.dequantizationScale(), 1.0f);
+  auto positions = position.toFloatBuffer();
+  ASSERT_EQ(positions.size(), sizeof(float) * 3 * vertexCount);
+  const float *values = (const float *)positions.data();
+  EXPECT_EQ(values[0], -10000.0f);
+  EXPECT_EQ(values[3 * 20], 10000.0f);
+  EXPECT_EQ(values[3 * 20 + 1], 20.0f);
+  EXPECT_EQ(values[3 * 20 + 2], -1.0f);
+}
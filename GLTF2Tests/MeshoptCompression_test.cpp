@@ -0,0 +1,258 @@
+#include "GLTF2.h"
+#include "meshoptimizer.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace gltf2;
+
+namespace {
+
+const uint32_t vertexCount = 64;
+
+struct CompressedView {
+  uint32_t byteOffset;
+  uint32_t byteLength;
+};
+
+/// The BIN chunk of a document and the ranges of its compressed bufferViews.
+struct CompressedBin {
+  Buffer bin;
+
+  CompressedView add(const std::vector<uint8_t> &encoded) {
+    CompressedView view{(uint32_t)bin.size(), (uint32_t)encoded.size()};
+    bin.insert(bin.end(), encoded.begin(), encoded.end());
+    bin.resize((bin.size() + 3) / 4 * 4);
+    return view;
+  }
+};
+
+std::vector<float> positionsData() {
+  std::vector<float> positions(3 * vertexCount);
+  for (uint32_t i = 0; i < vertexCount; i++) {
+    positions[i * 3] = (float)(i % 8);
+    positions[i * 3 + 1] = (float)(i / 8);
+    positions[i * 3 + 2] = 0.25f * i;
+  }
+  return positions;
+}
+
+std::vector<uint32_t> trianglesData() {
+  std::vector<uint32_t> indices;
+  for (uint32_t y = 0; y + 1 < 8; y++) {
+    for (uint32_t x = 0; x + 1 < 8; x++) {
+      uint32_t i = y * 8 + x;
+      indices.insert(indices.end(), {i, i + 1, i + 8, i + 1, i + 9, i + 8});
+    }
+  }
+  return indices;
+}
+
+std::vector<float> normalsData() {
+  std::vector<float> normals(4 * vertexCount);
+  for (uint32_t i = 0; i < vertexCount; i++) {
+    float angle = 0.1f * i;
+    normals[i * 4] = std::cos(angle) * 0.6f;
+    normals[i * 4 + 1] = std::sin(angle) * 0.6f;
+    normals[i * 4 + 2] = i % 2 ? 0.8f : -0.8f;
+    normals[i * 4 + 3] = 1.0f;
+  }
+  return normals;
+}
+
+std::vector<uint8_t> encodeVertices(const void *vertices, size_t count,
+                                    size_t size) {
+  std::vector<uint8_t> encoded(meshopt_encodeVertexBufferBound(count, size));
+  encoded.resize(meshopt_encodeVertexBuffer(encoded.data(), encoded.size(),
+                                            vertices, count, size));
+  return encoded;
+}
+
+std::vector<uint8_t> encodeTriangles(const std::vector<uint32_t> &indices) {
+  std::vector<uint8_t> encoded(
+      meshopt_encodeIndexBufferBound(indices.size(), vertexCount));
+  encoded.resize(meshopt_encodeIndexBuffer(encoded.data(), encoded.size(),
+                                           indices.data(), indices.size()));
+  return encoded;
+}
+
+std::vector<uint8_t> encodeSequence(const std::vector<uint32_t> &indices) {
+  std::vector<uint8_t> encoded(
+      meshopt_encodeIndexSequenceBound(indices.size(), vertexCount));
+  encoded.resize(meshopt_encodeIndexSequence(encoded.data(), encoded.size(),
+                                             indices.data(), indices.size()));
+  return encoded;
+}
+
+std::string meshoptView(uint32_t byteOffset, uint32_t byteLength,
+                        const CompressedView &compressed, uint32_t byteStride,
+                        uint32_t count, const std::string &mode,
+                        const std::string &filter) {
+  std::stringstream ss;
+  ss << R"({"buffer": 1, "byteOffset": )" << byteOffset
+     << R"(, "byteLength": )" << byteLength
+     << R"(, "extensions": {"EXT_meshopt_compression": {"buffer": 0, )"
+     << R"("byteOffset": )" << compressed.byteOffset << R"(, "byteLength": )"
+     << compressed.byteLength << R"(, "byteStride": )" << byteStride
+     << R"(, "count": )" << count << R"(, "mode": ")" << mode
+     << R"(", "filter": ")" << filter << R"("}}})";
+  return ss.str();
+}
+
+/**
+ * A grid of 8x8 vertices whose positions, normals, triangles and a sequence
+ * of point indices are stored in EXT_meshopt_compression bufferViews of a
+ * fallback buffer without uri. `corruptTriangles` truncates the triangles.
+ */
+GLTFFile compressedFile(bool corruptTriangles = false) {
+  auto positions = positionsData();
+  auto triangles = trianglesData();
+  std::vector<uint32_t> sequence(vertexCount);
+  for (uint32_t i = 0; i < vertexCount; i++)
+    sequence[i] = i;
+  auto normals = normalsData();
+  std::vector<int8_t> octahedral(4 * vertexCount);
+  meshopt_encodeFilterOct(octahedral.data(), vertexCount, 4, 8,
+                          normals.data());
+
+  CompressedBin bin;
+  auto positionsView = bin.add(
+      encodeVertices(positions.data(), vertexCount, 3 * sizeof(float)));
+  auto trianglesEncoded = encodeTriangles(triangles);
+  if (corruptTriangles)
+    trianglesEncoded.resize(trianglesEncoded.size() / 2);
+  auto trianglesView = bin.add(trianglesEncoded);
+  auto sequenceView = bin.add(encodeSequence(sequence));
+  auto normalsView =
+      bin.add(encodeVertices(octahedral.data(), vertexCount, 4));
+
+  uint32_t positionsBytes = 12 * vertexCount;
+  uint32_t trianglesBytes = 2 * (uint32_t)triangles.size();
+  uint32_t sequenceBytes = 4 * vertexCount;
+  uint32_t normalsBytes = 4 * vertexCount;
+  uint32_t fallbackBytes =
+      positionsBytes + trianglesBytes + sequenceBytes + normalsBytes;
+
+  std::stringstream ss;
+  ss << R"({
+    "asset": {"version": "2.0"},
+    "extensionsUsed": ["EXT_meshopt_compression"],
+    "extensionsRequired": ["EXT_meshopt_compression"],
+    "buffers": [
+      {"byteLength": )"
+     << bin.bin.size() << R"(},
+      {"byteLength": )"
+     << fallbackBytes
+     << R"(, "extensions": {"EXT_meshopt_compression": {"fallback": true}}}
+    ],
+    "bufferViews": [
+      )"
+     << meshoptView(0, positionsBytes, positionsView, 12, vertexCount,
+                    "ATTRIBUTES", "NONE")
+     << ",\n      "
+     << meshoptView(positionsBytes, trianglesBytes, trianglesView, 2,
+                    (uint32_t)triangles.size(), "TRIANGLES", "NONE")
+     << ",\n      "
+     << meshoptView(positionsBytes + trianglesBytes, sequenceBytes,
+                    sequenceView, 4, vertexCount, "INDICES", "NONE")
+     << ",\n      "
+     << meshoptView(positionsBytes + trianglesBytes + sequenceBytes,
+                    normalsBytes, normalsView, 4, vertexCount, "ATTRIBUTES",
+                    "OCTAHEDRAL")
+     << R"(
+    ],
+    "accessors": [
+      {"bufferView": 0, "componentType": 5126, "count": )"
+     << vertexCount << R"(, "type": "VEC3"},
+      {"bufferView": 1, "componentType": 5123, "count": )"
+     << triangles.size() << R"(, "type": "SCALAR"},
+      {"bufferView": 2, "componentType": 5125, "count": )"
+     << vertexCount << R"(, "type": "SCALAR"},
+      {"bufferView": 3, "componentType": 5120, "normalized": true, "count": )"
+     << vertexCount << R"(, "type": "VEC4"}
+    ],
+    "meshes": [{"primitives": [
+      {"attributes": {"POSITION": 0}, "indices": 1},
+      {"attributes": {"POSITION": 0, "TANGENT": 3}, "indices": 2, "mode": 0}
+    ]}]
+  })";
+  return GLTFFile::parseStream(std::move(ss), std::nullopt, bin.bin);
+}
+
+template <typename T> std::vector<T> valuesOf(const Buffer &buffer) {
+  std::vector<T> values(buffer.size() / sizeof(T));
+  std::memcpy(values.data(), buffer.data(), buffer.size());
+  return values;
+}
+
+} // namespace
+
+TEST(MeshoptCompression, decodesAttributesAndIndices) {
+  auto data = GLTFData::load(compressedFile());
+  EXPECT_EQ(data.stats().meshoptBufferViews, 4);
+
+  const auto &triangles = data.meshPrimitiveAt(0, 0);
+  EXPECT_EQ(valuesOf<float>(triangles.sources.position->buffer),
+            positionsData());
+  ASSERT_TRUE(triangles.element);
+  std::vector<uint16_t> expected;
+  for (auto index : trianglesData())
+    expected.push_back((uint16_t)index);
+  EXPECT_EQ(valuesOf<uint16_t>(triangles.element->buffer), expected);
+
+  const auto &points = data.meshPrimitiveAt(0, 1);
+  ASSERT_TRUE(points.element);
+  auto sequence = valuesOf<uint32_t>(points.element->buffer);
+  ASSERT_EQ(sequence.size(), vertexCount);
+  for (uint32_t i = 0; i < vertexCount; i++)
+    EXPECT_EQ(sequence[i], i);
+}
+
+TEST(MeshoptCompression, appliesOctahedralFilter) {
+  auto data = GLTFData::load(compressedFile());
+  auto normals = normalsData();
+  auto decoded =
+      valuesOf<float>(data.meshPrimitiveAt(0, 1).sources.tangent->buffer);
+  ASSERT_EQ(decoded.size(), normals.size());
+  for (uint32_t i = 0; i < vertexCount; i++) {
+    for (uint32_t c = 0; c < 3; c++)
+      EXPECT_NEAR(decoded[i * 4 + c], normals[i * 4 + c], 0.03f);
+    EXPECT_NEAR(decoded[i * 4 + 3], 1.0f, 0.01f);
+  }
+}
+
+TEST(MeshoptCompression, throwsOnCorruptData) {
+  EXPECT_THROW(GLTFData::load(compressedFile(true)), InvalidFormatException);
+}
+
+TEST(MeshoptCompression, repacksDecodedData) {
+  auto expected = GLTFData::load(compressedFile());
+  auto file = compressedFile();
+  auto data = GLTFData::load(compressedFile());
+  std::vector<GLBWriter> writers;
+  writers.push_back(GLTFRepack::repack(file));
+  writers.push_back(GLTFRepack::repack(data));
+  writers.push_back(GLBWriter::fromData(data));
+  for (const auto &writer : writers) {
+    std::stringstream ss;
+    writer.write(ss);
+    auto repacked = GLTFFile::parseStream(std::move(ss));
+    const auto &json = repacked.json();
+    EXPECT_FALSE(json.extensionsUsed.has_value());
+    EXPECT_FALSE(json.extensionsRequired.has_value());
+    ASSERT_EQ(json.buffers->size(), 1);
+    for (const auto &bufferView : *json.bufferViews)
+      EXPECT_FALSE(bufferView.meshoptExtension.has_value());
+
+    auto loaded = GLTFData::load(std::move(repacked));
+    EXPECT_EQ(loaded.stats().meshoptBufferViews, 0);
+    for (uint32_t i = 0; i < 2; i++) {
+      const auto &primitive = loaded.meshPrimitiveAt(0, i);
+      const auto &reference = expected.meshPrimitiveAt(0, i);
+      EXPECT_EQ(primitive.sources.position->buffer,
+                reference.sources.position->buffer);
+      EXPECT_EQ(primitive.element->buffer, reference.element->buffer);
+    }
+    EXPECT_EQ(loaded.meshPrimitiveAt(0, 1).sources.tangent->buffer,
+              expected.meshPrimitiveAt(0, 1).sources.tangent->buffer);
+  }
+}
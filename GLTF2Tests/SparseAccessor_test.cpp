@@ -0,0 +1,173 @@
+#include "GLTF2.h"
+#include "GLTFGenerator.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace gltf2;
+
+namespace {
+
+// A SCALAR float accessor of 6 elements 0..5 with elements 4 and 1, in that
+// order, replaced by 40 and 10 through UNSIGNED_SHORT indices.
+GLTFFile sparseFile(bool withBase) {
+  const float base[] = {0, 1, 2, 3, 4, 5};
+  const uint16_t indices[] = {4, 1};
+  const float values[] = {40, 10};
+
+  json::Json json;
+  json.asset.version = "2.0";
+  GLBWriter writer(std::move(json));
+  auto baseView = writer.addBufferView((const uint8_t *)base, sizeof(base));
+  auto indicesView =
+      writer.addBufferView((const uint8_t *)indices, sizeof(indices));
+  auto valuesView =
+      writer.addBufferView((const uint8_t *)values, sizeof(values));
+
+  json::Accessor accessor;
+  if (withBase)
+    accessor.bufferView = baseView;
+  accessor.componentType = json::Accessor::ComponentType::FLOAT;
+  accessor.type = json::Accessor::Type::SCALAR;
+  accessor.count = 6;
+  json::AccessorSparse sparse;
+  sparse.count = 2;
+  sparse.indices.bufferView = indicesView;
+  sparse.indices.componentType =
+      json::AccessorSparseIndices::ComponentType::UNSIGNED_SHORT;
+  sparse.values.bufferView = valuesView;
+  accessor.sparse = sparse;
+  writer.json().accessors = {accessor};
+
+  std::stringstream ss;
+  writer.write(ss);
+  return GLTFFile::parseStream(std::move(ss));
+}
+
+std::vector<float> floatsOf(const Buffer &buffer) {
+  std::vector<float> values(buffer.size() / sizeof(float));
+  std::memcpy(values.data(), buffer.data(), buffer.size());
+  return values;
+}
+
+} // namespace
+
+TEST(SparseAccessor, scattersValuesOverBase) {
+  auto data = GLTFData::load(sparseFile(true));
+  const auto &accessorBuffer = data.accessorBufferAt(0);
+  EXPECT_EQ(accessorBuffer.sparse, nullptr);
+  EXPECT_EQ(floatsOf(accessorBuffer.buffer),
+            (std::vector<float>{0, 10, 2, 3, 40, 5}));
+}
+
+TEST(SparseAccessor, scattersValuesOverZeros) {
+  auto data = GLTFData::load(sparseFile(false));
+  EXPECT_EQ(floatsOf(data.accessorBufferAt(0).buffer),
+            (std::vector<float>{0, 10, 0, 0, 40, 0}));
+}
+
+TEST(SparseAccessor, keepsOverlay) {
+  LoadOptions options;
+  options.keepSparseAccessors = true;
+  auto data = GLTFData::load(sparseFile(true), options);
+  const auto &accessorBuffer = data.accessorBufferAt(0);
+  EXPECT_TRUE(accessorBuffer.buffer.empty());
+  ASSERT_NE(accessorBuffer.sparse, nullptr);
+
+  const auto &sparse = *accessorBuffer.sparse;
+  EXPECT_EQ(sparse.count, 6);
+  EXPECT_EQ(sparse.indices, (std::vector<uint32_t>{1, 4}));
+  EXPECT_EQ(floatsOf(sparse.values), (std::vector<float>{10, 40}));
+  EXPECT_EQ(floatsOf(sparse.toBuffer()),
+            (std::vector<float>{0, 10, 2, 3, 40, 5}));
+
+  std::vector<std::pair<uint32_t, float>> touched;
+  sparse.forEachValue([&](uint32_t index, const uint8_t *element) {
+    float value;
+    std::memcpy(&value, element, sizeof(value));
+    touched.emplace_back(index, value);
+  });
+  EXPECT_EQ(touched, (std::vector<std::pair<uint32_t, float>>{{1, 10},
+                                                              {4, 40}}));
+  // 2 indices and values instead of 6 elements
+  auto dense = GLTFData::load(sparseFile(true));
+  EXPECT_EQ(dense.allocatedBytes() - data.allocatedBytes(),
+            6 * sizeof(float) - 2 * (sizeof(uint32_t) + sizeof(float)));
+}
+
+TEST(SparseAccessor, keepsMorphTargetsSparse) {
+  gen::GeneratorOptions generatorOptions;
+  generatorOptions.vertices = 256;
+  generatorOptions.morphTargets = 2;
+  generatorOptions.sparseCount = 8;
+  auto asset = gen::GLTFGenerator::generate(generatorOptions);
+  auto dense = GLTFData::load(asset.file());
+  LoadOptions options;
+  options.keepSparseAccessors = true;
+  auto sparse = GLTFData::load(asset.file(), options);
+  EXPECT_LT(sparse.allocatedBytes(), dense.allocatedBytes());
+
+  const auto &denseTargets = dense.meshPrimitiveAt(0, 0).targets;
+  const auto &sparseTargets = sparse.meshPrimitiveAt(0, 0).targets;
+  ASSERT_EQ(sparseTargets.size(), 2);
+  for (size_t i = 0; i < sparseTargets.size(); i++) {
+    const auto &position = *sparseTargets[i].position;
+    ASSERT_NE(position.sparse, nullptr);
+    EXPECT_TRUE(position.buffer.empty());
+    EXPECT_EQ(position.sparse->indices.size(), 8);
+    EXPECT_EQ(position.sparse->toBuffer(), denseTargets[i].position->buffer);
+  }
+}
+
+TEST(SparseAccessor, densifiesIndices) {
+  const float positions[] = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+  const uint8_t sparseIndices[] = {1, 2};
+  const uint16_t values[] = {1, 2};
+
+  json::Json json;
+  json.asset.version = "2.0";
+  GLBWriter writer(std::move(json));
+  auto positionsView =
+      writer.addBufferView((const uint8_t *)positions, sizeof(positions));
+  auto indicesView = writer.addBufferView(sparseIndices, sizeof(sparseIndices));
+  auto valuesView =
+      writer.addBufferView((const uint8_t *)values, sizeof(values));
+
+  json::Accessor position;
+  position.bufferView = positionsView;
+  position.componentType = json::Accessor::ComponentType::FLOAT;
+  position.type = json::Accessor::Type::VEC3;
+  position.count = 3;
+  // indices {0, 0, 0} with the last two replaced by 1 and 2
+  json::Accessor indices;
+  indices.componentType = json::Accessor::ComponentType::UNSIGNED_SHORT;
+  indices.type = json::Accessor::Type::SCALAR;
+  indices.count = 3;
+  json::AccessorSparse sparse;
+  sparse.count = 2;
+  sparse.indices.bufferView = indicesView;
+  sparse.indices.componentType =
+      json::AccessorSparseIndices::ComponentType::UNSIGNED_BYTE;
+  sparse.values.bufferView = valuesView;
+  indices.sparse = sparse;
+  writer.json().accessors = {position, indices};
+  json::MeshPrimitive primitive;
+  primitive.attributes.position = 0;
+  primitive.indices = 1;
+  json::Mesh mesh;
+  mesh.primitives = {primitive};
+  writer.json().meshes = std::vector<json::Mesh>{mesh};
+
+  std::stringstream ss;
+  writer.write(ss);
+  LoadOptions options;
+  options.keepSparseAccessors = true;
+  auto data = GLTFData::load(GLTFFile::parseStream(std::move(ss)), options);
+  EXPECT_NE(data.accessorBufferAt(1).sparse, nullptr);
+  const auto &element = data.meshPrimitiveAt(0, 0).element;
+  ASSERT_TRUE(element);
+  EXPECT_EQ(element->primitiveCount, 1);
+  ASSERT_EQ(element->buffer.size(), 6);
+  const auto *loaded = (const uint16_t *)element->buffer.data();
+  EXPECT_EQ(std::vector<uint16_t>(loaded, loaded + 3),
+            (std::vector<uint16_t>{0, 1, 2}));
+}
@@ -0,0 +1,123 @@
+#include "GLTF2.h"
+#include "GLTFGenerator.h"
+#include "MeshPrimitiveTestUtils.h"
+#include <gtest/gtest.h>
+
+using namespace gltf2;
+
+namespace {
+
+// Two vertices with float positions, normals, texcoords and RGB colors, and
+// UNSIGNED_SHORT joints.
+MeshPrimitive primitive() {
+  MeshPrimitive primitive;
+  auto &sources = primitive.sources;
+  sources.position = sourceOf<float>({1, 2, 3, -4, 5.5f, 6}, 3);
+  sources.normal = sourceOf<float>({0, 0, 1, 0, -1, 0}, 3);
+  sources.texcoords.push_back(sourceOf<float>({0.5f, 1, 0.25f, 2}, 2));
+  sources.colors.push_back(sourceOf<float>({1, 0, 0.5f, 0, 1, 0.2f}, 3));
+  sources.joints.push_back(sourceOf<uint16_t>({1, 2, 3, 4, 5, 6, 7, 8}, 4));
+  return primitive;
+}
+
+template <typename T> T valueAt(const Buffer &buffer, size_t offset) {
+  T value;
+  std::memcpy(&value, buffer.data() + offset, sizeof(T));
+  return value;
+}
+
+} // namespace
+
+TEST(VertexLayout, interleavesAndConvertsFormats) {
+  VertexLayout layout;
+  layout.elements = {
+      {VertexAttribute::Position, VertexFormat::Float32x3},
+      {VertexAttribute::Normal, VertexFormat::Snorm16x4},
+      {VertexAttribute::Texcoord, VertexFormat::Float16x2},
+      {VertexAttribute::Color, VertexFormat::Unorm8x4},
+      {VertexAttribute::Joints, VertexFormat::Uint8x4},
+  };
+  VertexBufferBuilder builder(layout);
+  EXPECT_EQ(builder.offsets(), (std::vector<uint32_t>{0, 12, 20, 24, 28}));
+  ASSERT_EQ(builder.stride(), 32);
+
+  auto vertices = builder.build(primitive());
+  ASSERT_EQ(vertices.vertexCount, 2);
+  ASSERT_EQ(vertices.buffer.size(), 64);
+  const auto &buffer = vertices.buffer;
+  EXPECT_EQ(valueAt<float>(buffer, 32 + 4), 5.5f);
+  // the missing fourth component of normals and colors is 1
+  EXPECT_EQ(valueAt<int16_t>(buffer, 12 + 4), 32767);
+  EXPECT_EQ(valueAt<int16_t>(buffer, 12 + 6), 32767);
+  EXPECT_EQ(valueAt<int16_t>(buffer, 32 + 12 + 2), -32767);
+  EXPECT_EQ(valueAt<uint16_t>(buffer, 20), 0x3800);
+  EXPECT_EQ(valueAt<uint16_t>(buffer, 32 + 20 + 2), 0x4000);
+  EXPECT_EQ(valueAt<uint8_t>(buffer, 24), 255);
+  EXPECT_EQ(valueAt<uint8_t>(buffer, 24 + 2), 128);
+  EXPECT_EQ(valueAt<uint8_t>(buffer, 24 + 3), 255);
+  EXPECT_EQ(valueAt<uint8_t>(buffer, 32 + 28 + 3), 8);
+}
+
+TEST(VertexLayout, placesElementsAtOffsets) {
+  VertexLayout layout;
+  layout.elements = {
+      {VertexAttribute::Normal, VertexFormat::Float32x3, 0, 16},
+      {VertexAttribute::Position, VertexFormat::Float32x3, 0, 0},
+      // the primitive has no tangents
+      {VertexAttribute::Tangent, VertexFormat::Float32x4, 0, 32, 16},
+  };
+  layout.stride = 64;
+  VertexBufferBuilder builder(layout);
+  auto vertices = builder.build(primitive());
+  ASSERT_EQ(vertices.buffer.size(), 128);
+  EXPECT_EQ(valueAt<float>(vertices.buffer, 64), -4.0f);
+  EXPECT_EQ(valueAt<float>(vertices.buffer, 64 + 16 + 4), -1.0f);
+  for (size_t i = 32; i < 64; i++)
+    EXPECT_EQ(vertices.buffer[64 + i], 0);
+}
+
+TEST(VertexLayout, throwsOnInvalidLayout) {
+  VertexLayout overlapping;
+  overlapping.elements = {
+      {VertexAttribute::Position, VertexFormat::Float32x3, 0, 0},
+      {VertexAttribute::Normal, VertexFormat::Float32x3, 0, 8},
+  };
+  EXPECT_THROW(VertexBufferBuilder{overlapping}, InputException);
+
+  VertexLayout misaligned;
+  misaligned.elements = {
+      {VertexAttribute::Position, VertexFormat::Float32x3, 0, 2}};
+  EXPECT_THROW(VertexBufferBuilder{misaligned}, InputException);
+
+  VertexLayout small;
+  small.elements = {{VertexAttribute::Position, VertexFormat::Float32x3}};
+  small.stride = 8;
+  EXPECT_THROW(VertexBufferBuilder{small}, InputException);
+}
+
+TEST(VertexLayout, buildsEveryPrimitive) {
+  gen::GeneratorOptions options;
+  options.meshes = 3;
+  options.nodes = 3;
+  options.vertices = 1000;
+  auto data = GLTFData::load(gen::GLTFGenerator::generate(options).file());
+
+  VertexLayout layout;
+  layout.elements = {
+      {VertexAttribute::Position, VertexFormat::Float32x3},
+      {VertexAttribute::Texcoord, VertexFormat::Unorm16x2},
+  };
+  auto meshes = VertexBufferBuilder(layout).buildAll(data);
+  ASSERT_EQ(meshes.size(), 3);
+  for (uint32_t i = 0; i < meshes.size(); i++) {
+    ASSERT_EQ(meshes[i].size(), 1);
+    const auto &position = *data.meshPrimitiveAt(i, 0).sources.position;
+    const auto &vertices = meshes[i][0];
+    ASSERT_EQ(vertices.vertexCount, position.vectorCount);
+    for (uint32_t v = 0; v < vertices.vertexCount; v++) {
+      ASSERT_EQ(std::memcmp(vertices.buffer.data() + v * 16,
+                            position.buffer.data() + v * 12, 12),
+                0);
+    }
+  }
+}
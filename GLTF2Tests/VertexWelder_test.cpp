@@ -0,0 +1,165 @@
+#include "GLTF2.h"
+#include "GLTFGenerator.h"
+#include "MeshPrimitiveTestUtils.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+
+using namespace gltf2;
+
+namespace {
+
+/// The position of every index, so that welding must keep them.
+std::vector<float> indexedPositions(const MeshPrimitive &primitive) {
+  auto positions = valuesOf<float>(*primitive.sources.position);
+  std::vector<float> result;
+  for (auto index : indicesOf(*primitive.element)) {
+    result.insert(result.end(), positions.begin() + index * 3,
+                  positions.begin() + index * 3 + 3);
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(VertexWelder, indexesUnindexedTriangles) {
+  MeshPrimitive primitive;
+  primitive.sources.position = sourceOf<float>(
+      {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 1, 1, 0}, 3);
+  ASSERT_TRUE(VertexWelder().weld(primitive));
+
+  ASSERT_TRUE(primitive.element);
+  EXPECT_EQ(primitive.element->primitiveMode,
+            json::MeshPrimitive::Mode::TRIANGLES);
+  EXPECT_EQ(primitive.element->primitiveCount, 2);
+  EXPECT_EQ(primitive.element->componentType,
+            json::Accessor::ComponentType::UNSIGNED_BYTE);
+  EXPECT_EQ(indicesOf(*primitive.element),
+            (std::vector<uint32_t>{0, 1, 2, 2, 1, 3}));
+  EXPECT_EQ(valuesOf<float>(*primitive.sources.position),
+            (std::vector<float>{0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0}));
+}
+
+TEST(VertexWelder, keepsVerticesThatDifferInAnyAttribute) {
+  MeshPrimitive primitive;
+  primitive.sources.position =
+      sourceOf<float>({1, 2, 3, 1, 2, 3, 1, 2, 3, 1, 2, 3}, 3);
+  primitive.sources.texcoords.push_back(
+      sourceOf<float>({0, 0, 0, 0, 1, 0, 0, 0}, 2));
+  // a sparse morph target over zeros that only displaces vertex 3
+  auto sparse = std::make_shared<SparseAccessorBuffer>();
+  sparse->count = 4;
+  sparse->elementSize = 12;
+  sparse->indices = {3};
+  std::vector<float> delta = {0, 1, 0};
+  sparse->values.resize(12);
+  std::memcpy(sparse->values.data(), delta.data(), 12);
+  auto &target = primitive.targets.emplace_back();
+  target.position = sourceOf<float>({}, 3);
+  target.position->vectorCount = 4;
+  target.position->sparse = sparse;
+  MeshPrimitiveElement element;
+  element.buffer.resize(24);
+  std::vector<uint32_t> indices = {0, 1, 2, 3, 2, 1};
+  std::memcpy(element.buffer.data(), indices.data(), 24);
+  element.primitiveMode = json::MeshPrimitive::Mode::TRIANGLES;
+  element.primitiveCount = 2;
+  element.componentType = json::Accessor::ComponentType::UNSIGNED_INT;
+  primitive.element = element;
+
+  ASSERT_TRUE(VertexWelder().weld(primitive));
+  EXPECT_EQ(primitive.element->componentType,
+            json::Accessor::ComponentType::UNSIGNED_INT);
+  EXPECT_EQ(indicesOf(*primitive.element),
+            (std::vector<uint32_t>{0, 0, 1, 2, 1, 0}));
+  EXPECT_EQ(primitive.sources.position->vectorCount, 3);
+  EXPECT_EQ(valuesOf<float>(primitive.sources.texcoords[0]),
+            (std::vector<float>{0, 0, 1, 0, 0, 0}));
+  EXPECT_FALSE(target.position->sparse);
+  EXPECT_EQ(valuesOf<float>(*target.position),
+            (std::vector<float>{0, 0, 0, 0, 0, 0, 0, 1, 0}));
+}
+
+TEST(VertexWelder, snapsPositionsToEpsilon) {
+  MeshPrimitive primitive;
+  primitive.sources.position =
+      sourceOf<float>({1, 0, 0, 1.0004f, 0, 0, 2, 0, 0}, 3);
+  VertexWeldOptions options;
+  options.positionEpsilon = 0.001f;
+  ASSERT_TRUE(VertexWelder(options).weld(primitive,
+                                         json::MeshPrimitive::Mode::POINTS));
+  EXPECT_EQ(primitive.element->primitiveMode,
+            json::MeshPrimitive::Mode::POINTS);
+  EXPECT_EQ(primitive.element->primitiveCount, 3);
+  EXPECT_EQ(indicesOf(*primitive.element), (std::vector<uint32_t>{0, 0, 1}));
+  // the first vertex of the merged ones is kept
+  EXPECT_EQ(valuesOf<float>(*primitive.sources.position),
+            (std::vector<float>{1, 0, 0, 2, 0, 0}));
+
+  MeshPrimitive exact;
+  exact.sources.position =
+      sourceOf<float>({1, 0, 0, 1.0004f, 0, 0, 2, 0, 0}, 3);
+  ASSERT_TRUE(VertexWelder().weld(exact));
+  EXPECT_EQ(exact.sources.position->vectorCount, 3);
+}
+
+TEST(VertexWelder, weldsLargePrimitivesInParallel) {
+  const uint32_t uniqueCount = 50000;
+  std::mt19937 random(1);
+  std::uniform_real_distribution<float> distribution(-1, 1);
+  std::vector<float> unique(uniqueCount * 3);
+  for (auto &value : unique)
+    value = distribution(random);
+  std::vector<uint32_t> order;
+  for (uint32_t i = 0; i < uniqueCount * 4; i++)
+    order.push_back(i % uniqueCount);
+  std::shuffle(order.begin(), order.end(), random);
+  std::vector<float> positions;
+  for (auto i : order)
+    positions.insert(positions.end(), {unique[i * 3], unique[i * 3 + 1],
+                                       unique[i * 3 + 2]});
+
+  MeshPrimitive primitive;
+  primitive.sources.position = sourceOf(positions, 3);
+  auto inline_ = primitive;
+  InlineExecutor inlineExecutor;
+  ASSERT_TRUE(VertexWelder().weld(
+      inline_, json::MeshPrimitive::Mode::TRIANGLES, inlineExecutor));
+  ThreadPoolExecutor executor(4);
+  ASSERT_TRUE(VertexWelder().weld(
+      primitive, json::MeshPrimitive::Mode::TRIANGLES, executor));
+
+  EXPECT_EQ(primitive.sources.position->vectorCount, uniqueCount);
+  // the welded indices fit in 16 bits
+  EXPECT_EQ(primitive.element->componentType,
+            json::Accessor::ComponentType::UNSIGNED_SHORT);
+  EXPECT_EQ(indexedPositions(primitive), positions);
+  // the result does not depend on the scheduling
+  EXPECT_EQ(primitive.element->buffer, inline_.element->buffer);
+  EXPECT_EQ(primitive.sources.position->buffer,
+            inline_.sources.position->buffer);
+}
+
+TEST(VertexWelder, weldsPrimitivesOnLoad) {
+  gen::GeneratorOptions generatorOptions;
+  generatorOptions.meshes = 2;
+  generatorOptions.nodes = 2;
+  generatorOptions.vertices = 500;
+  auto asset = gen::GLTFGenerator::generate(generatorOptions);
+  auto load = [&asset](LoadOptions options) {
+    return GLTFData::load(asset.file(), options);
+  };
+  auto data = load(LoadOptions());
+  LoadOptions options;
+  options.vertexWeld = VertexWeldOptions();
+  options.meshOptimization = MeshOptimizeOptions();
+  auto welded = load(options);
+  for (uint32_t i = 0; i < 2; i++) {
+    const auto &primitive = welded.meshPrimitiveAt(i, 0);
+    const auto &original = data.meshPrimitiveAt(i, 0);
+    EXPECT_LE(primitive.sources.position->vectorCount,
+              original.sources.position->vectorCount);
+    EXPECT_EQ(indicesOf(*primitive.element).size(),
+              indicesOf(*original.element).size());
+  }
+}